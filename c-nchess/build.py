@@ -13,12 +13,15 @@ Commands:
 Compiler Options:
   --compiler=<gcc|clang|msvc>  - Specify compiler (auto-detected if not provided)
   --slow-perft                 - Run perft tests in slow mode (default is fast mode)
+  --precomputed-tables         - Generate the bitboard tables at build time as const
+                                 data instead of computing them in NCH_Init
 
 Examples:
   python build.py build
   python build.py clean build
   python build.py build test
   python build.py build test --slow-perft
+  python build.py clean build test --precomputed-tables
   python build.py clean build-debug test-debug
   python build.py --compiler=msvc build
   python build.py --compiler=gcc clean build test
@@ -90,10 +93,13 @@ CC_CONFIG = None
 
 # Global flags
 SLOW_PERFT_MODE = False
+PRECOMPUTED_TABLES = False
 
 SRC_DIR = "nchess"
 TEST_DIR = "test"
+TOOLS_DIR = "tools"
 BUILD_DIR = "build"
+GEN_DIR = os.path.join(BUILD_DIR, "gen")
 OBJ_DIR = os.path.join(BUILD_DIR, "obj")
 TEST_OBJ_DIR = os.path.join(BUILD_DIR, "test_obj")
 BIN_DIR = os.path.join(BUILD_DIR, "bin")
@@ -329,6 +335,44 @@ def link_executable(obj_files, libs, target, cflags):
     return True
 
 
+def precomputed_tables_flags():
+    """Get the flags that make the library use the generated tables"""
+    if CC_CONFIG.name == "msvc":
+        return ["/DNCH_PRECOMPUTED_TABLES", f"/I{GEN_DIR}"]
+    return ["-DNCH_PRECOMPUTED_TABLES", f"-I{GEN_DIR}"]
+
+
+def generate_tables(cflags):
+    """Build the gen_tables tool and write the bitboard tables with it"""
+    print("\n--- Generating bitboard tables ---")
+
+    obj_ext = ".obj" if CC_CONFIG.name == "msvc" else ".o"
+    include_flag = f"/I{SRC_DIR}" if CC_CONFIG.name == "msvc" else f"-I{SRC_DIR}"
+    src_files = glob.glob(os.path.join(SRC_DIR, "*.c")) + [os.path.join(TOOLS_DIR, "gen_tables.c")]
+
+    obj_files = []
+    for src_file in src_files:
+        obj_name = os.path.basename(src_file).replace(".c", obj_ext)
+        obj_file = os.path.join(GEN_DIR, "obj", obj_name)
+        if not compile_source(src_file, obj_file, cflags + [include_flag]):
+            return False
+        obj_files.append(obj_file)
+
+    tool = os.path.join(GEN_DIR, get_executable_name("gen_tables"))
+    libs = [] if CC_CONFIG.name == "msvc" else ["-pthread"]
+    if not link_executable(obj_files, libs, tool, cflags):
+        return False
+
+    output = os.path.join(GEN_DIR, "bitboard_tables.h")
+    result = subprocess.run([tool, output])
+    if result.returncode != 0:
+        print("Error generating the bitboard tables")
+        return False
+
+    print(f"Tables written to {output}")
+    return True
+
+
 def build_library(debug_mode=False):
     """Build the library"""
     # Set compilation flags
@@ -343,6 +387,11 @@ def build_library(debug_mode=False):
     print(f"\n--- Building library in {'DEBUG' if debug_mode else 'RELEASE'} mode ---")
     print(f"Compiler: {CC_CONFIG.name}")
     print(f"Found {len(src_files)} source files")
+
+    if PRECOMPUTED_TABLES:
+        if not generate_tables(cflags):
+            return False
+        cflags = cflags + precomputed_tables_flags()
     
     # Compile all source files
     obj_files = []
@@ -400,6 +449,10 @@ def build_and_run_tests(debug_mode=False):
         else:
             test_cflags.append("-DPERFT_SLOW_MODE")
     
+    # The tests must see the tables as const like the library
+    if PRECOMPUTED_TABLES:
+        test_cflags += precomputed_tables_flags()
+
     # Compile all test files
     obj_ext = ".obj" if CC_CONFIG.name == "msvc" else ".o"
     test_obj_files = []
@@ -414,8 +467,9 @@ def build_and_run_tests(debug_mode=False):
         
         test_obj_files.append(obj_file)
     
-    # Link test executable with library
-    if not link_executable(test_obj_files, [TARGET], TEST_TARGET, test_cflags):
+    # Link test executable with library (and pthreads used by the parallel perft)
+    libs = [TARGET] if CC_CONFIG.name == "msvc" else [TARGET, "-pthread"]
+    if not link_executable(test_obj_files, libs, TEST_TARGET, test_cflags):
         return False
     
     print(f"Test executable created: {TEST_TARGET}")
@@ -434,7 +488,7 @@ def build_and_run_tests(debug_mode=False):
 
 def main():
     """Main entry point"""
-    global SLOW_PERFT_MODE
+    global SLOW_PERFT_MODE, PRECOMPUTED_TABLES
     
     if len(sys.argv) < 2:
         print("No command specified.")
@@ -450,6 +504,8 @@ def main():
             compiler_name = arg.split("=", 1)[1].lower()
         elif arg == "--slow-perft":
             SLOW_PERFT_MODE = True
+        elif arg == "--precomputed-tables":
+            PRECOMPUTED_TABLES = True
         else:
             commands.append(arg)
     
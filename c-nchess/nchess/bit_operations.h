@@ -19,6 +19,20 @@
     #include <intrin.h>
 #endif
 
+// NCH_HAS_PEXT is 1 if the pext instruction (BMI2) could be emitted on this
+// platform. Whether the cpu supports it is checked at runtime unless the
+// compiler already targets BMI2 (__BMI2__). Define NCH_NO_PEXT to build
+// without it.
+#if !defined(NCH_NO_PEXT) && (defined(__x86_64__) || defined(_M_X64))
+    #define NCH_HAS_PEXT 1
+#else
+    #define NCH_HAS_PEXT 0
+#endif
+
+#if NCH_HAS_PEXT && (defined(__BMI2__) || NCH_MSC)
+    #include <immintrin.h>
+#endif
+
 
 NCH_STATIC_INLINE int
 count_bits(uint64 x){
@@ -77,4 +91,31 @@ has_two_bits(uint64 x){
     return !more_than_one(x & (x-1));
 }
 
+// reverses the order of the bits. bit 0 becomes bit 63 and so on.
+NCH_STATIC_INLINE uint64
+reverse_bits(uint64 x){
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+    x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+    return (x >> 32) | (x << 32);
+}
+
+#if NCH_HAS_PEXT
+// extracts the bits of x selected by mask into the low bits of the result.
+// must only be called if the cpu supports BMI2.
+NCH_STATIC_FINLINE uint64
+pext(uint64 x, uint64 mask){
+    #if defined(__BMI2__) || NCH_MSC
+        return _pext_u64(x, mask);
+    #else
+        // the compiler does not target BMI2 so the intrinsic is not available
+        uint64 out;
+        __asm__("pextq %2, %1, %0" : "=r"(out) : "r"(x), "r"(mask));
+        return out;
+    #endif
+}
+#endif
+
 #endif // NCHESS_SRC_BIT_OPERATIONS_H
\ No newline at end of file
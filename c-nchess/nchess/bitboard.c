@@ -13,6 +13,15 @@
 #include "loops.h"
 #include <stdio.h>
 
+SliderBackend SliderBackendInUse = NCH_SliderMagic;
+
+#ifdef NCH_PRECOMPUTED_TABLES
+
+// generated at build time by NCH_WriteBitboardTables
+#include "bitboard_tables.h"
+
+#else
+
 uint64 PawnAttacks[2][NCH_SQUARE_NB];               // 128
 uint64 KnightAttacks[NCH_SQUARE_NB];                // 64
 uint64 KingAttacks[NCH_SQUARE_NB];                  // 64
@@ -24,8 +33,18 @@ uint64 Magics[2][NCH_SQUARE_NB];                    // 128
 uint64 SlidersAttackMask[2][NCH_SQUARE_NB];         // 128
 int ReleventSquares[2][NCH_SQUARE_NB];              // 128
 
-uint64 RookTable[NCH_SQUARE_NB][4096];              // 262,144
-uint64 BishopTable[NCH_SQUARE_NB][512];             // 32,768  
+int SliderOffsets[2][NCH_SQUARE_NB];                // 128
+
+uint64 RookTable[NCH_ROOK_TABLE_SIZE];              // 102,400
+uint64 BishopTable[NCH_BISHOP_TABLE_SIZE];          // 5,248
+
+#if NCH_HAS_PEXT
+uint64 RookPextTable[NCH_ROOK_TABLE_SIZE];          // 102,400
+uint64 BishopPextTable[NCH_BISHOP_TABLE_SIZE];      // 5,248
+#endif
+
+// the slider tables of a backend are filled only when it is used.
+NCH_STATIC int SliderTablesReady[2] = {0, 0};
 
 NCH_STATIC void
 init_pawn_attacks(){
@@ -310,19 +329,39 @@ init_magics(){
 }
 
 NCH_STATIC void
-init_sliders_table(){
-    uint64 mask, occupancy;
-    int rel_bits, occupancy_indicies, magic_index;
+init_slider_offsets(){
+    int rook_offset = 0, bishop_offset = 0;
+    for (int i = 0; i < NCH_SQUARE_NB; i++){
+        SliderOffsets[NCH_RS][i] = rook_offset;
+        SliderOffsets[NCH_BS][i] = bishop_offset;
+        rook_offset += 1 << bb_rook_relevant(i);
+        bishop_offset += 1 << bb_bishop_relevant(i);
+    }
+}
+
+// fills the slider tables of a backend. the pext index of the occupancy
+// created by set_occupancy(i, ...) is i itself, so the pext tables are
+// filled without the pext instruction.
+NCH_STATIC void
+init_sliders_table(SliderBackend backend){
+    uint64 mask, occupancy, attacks;
+    int rel_bits, occupancy_indicies;
 
     for (int sqr_idx = 0; sqr_idx < NCH_SQUARE_NB; sqr_idx++){
         mask = bb_rook_mask(sqr_idx);
         rel_bits = count_bits(mask);
         occupancy_indicies = 1 << rel_bits;
 
-        for (int index = 0; index < occupancy_indicies; index++){
-            occupancy = set_occupancy(index, rel_bits, mask);
-            magic_index = (int)((occupancy * bb_rook_magic(sqr_idx)) >> (64 - rel_bits));
-            RookTable[sqr_idx][magic_index] = get_rook_mask_on_fly(sqr_idx, occupancy);
+        for (int i = 0; i < occupancy_indicies; i++){
+            occupancy = set_occupancy(i, rel_bits, mask);
+            attacks = get_rook_mask_on_fly(sqr_idx, occupancy);
+#if NCH_HAS_PEXT
+            if (backend == NCH_SliderPext){
+                RookPextTable[SliderOffsets[NCH_RS][sqr_idx] + i] = attacks;
+                continue;
+            }
+#endif
+            RookTable[SliderOffsets[NCH_RS][sqr_idx] + bb_magic_index(NCH_RS, sqr_idx, occupancy)] = attacks;
         }
     }
 
@@ -331,12 +370,20 @@ init_sliders_table(){
         rel_bits = count_bits(mask);
         occupancy_indicies = 1 << rel_bits;
 
-        for (int index = 0; index < occupancy_indicies; index++){
-            occupancy = set_occupancy(index, rel_bits, mask);
-            magic_index = (int)((occupancy * bb_bishop_magic(sqr_idx)) >> (64 - rel_bits));
-            BishopTable[sqr_idx][magic_index] = get_bishop_mask_on_fly(sqr_idx, occupancy);
+        for (int i = 0; i < occupancy_indicies; i++){
+            occupancy = set_occupancy(i, rel_bits, mask);
+            attacks = get_bishop_mask_on_fly(sqr_idx, occupancy);
+#if NCH_HAS_PEXT
+            if (backend == NCH_SliderPext){
+                BishopPextTable[SliderOffsets[NCH_BS][sqr_idx] + i] = attacks;
+                continue;
+            }
+#endif
+            BishopTable[SliderOffsets[NCH_BS][sqr_idx] + bb_magic_index(NCH_BS, sqr_idx, occupancy)] = attacks;
         }
     }
+
+    SliderTablesReady[backend] = 1;
 }
 
 NCH_STATIC void
@@ -353,8 +400,30 @@ init_linebb(){
     }
 }
 
+#endif // NCH_PRECOMPUTED_TABLES
+
+// returns 1 if the cpu supports the BMI2 instructions.
+NCH_STATIC int
+cpu_has_bmi2(){
+#if !NCH_HAS_PEXT
+    return 0;
+#elif defined(__BMI2__)
+    return 1;
+#elif NCH_MSC
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return (info[1] >> 8) & 1;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("bmi2");
+#endif
+}
+
 void
 NCH_InitBitboards(){
+    SliderBackend backend = cpu_has_bmi2() ? NCH_SliderPext : NCH_SliderMagic;
+
+#ifndef NCH_PRECOMPUTED_TABLES
     init_pawn_attacks();
     init_knight_attacks();
     init_king_attacks();
@@ -363,6 +432,104 @@ NCH_InitBitboards(){
     init_bishop_mask();
     init_relevant_bits();
     init_magics();
-    init_sliders_table();
-    init_linebb();
-}
\ No newline at end of file
+    init_slider_offsets();
+    init_sliders_table(backend);
+#endif
+
+    SliderBackendInUse = backend;
+
+#ifndef NCH_PRECOMPUTED_TABLES
+    init_linebb();        // uses the slider tables
+#endif
+}
+
+int
+NCH_SetSliderBackend(SliderBackend backend){
+    if (backend == NCH_SliderPext && !cpu_has_bmi2())
+        return -1;
+
+#if defined(__BMI2__)
+    // the lookups always use pext when the compiler targets BMI2.
+    if (backend == NCH_SliderMagic)
+        return -1;
+#endif
+
+#ifndef NCH_PRECOMPUTED_TABLES
+    if (!SliderTablesReady[backend])
+        init_sliders_table(backend);
+#endif
+
+    SliderBackendInUse = backend;
+    return 0;
+}
+
+NCH_STATIC void
+write_u64_array(FILE* file, const char* decl, const uint64* data, int rows, int cols){
+    fprintf(file, "const uint64 %s = {\n", decl);
+    for (int r = 0; r < rows; r++){
+        if (rows > 1)
+            fprintf(file, "    {");
+        for (int c = 0; c < cols; c++){
+            if (c % 4 == 0)
+                fprintf(file, rows > 1 ? "\n        " : "\n    ");
+            fprintf(file, "0x%016llxULL,", (unsigned long long)data[r * cols + c]);
+        }
+        fprintf(file, rows > 1 ? "\n    },\n" : "\n");
+    }
+    fprintf(file, "};\n\n");
+}
+
+NCH_STATIC void
+write_int_array(FILE* file, const char* decl, const int* data, int rows, int cols){
+    fprintf(file, "const int %s = {\n", decl);
+    for (int r = 0; r < rows; r++){
+        fprintf(file, "    {");
+        for (int c = 0; c < cols; c++){
+            if (c % 8 == 0)
+                fprintf(file, "\n        ");
+            fprintf(file, "%d,", data[r * cols + c]);
+        }
+        fprintf(file, "\n    },\n");
+    }
+    fprintf(file, "};\n\n");
+}
+
+int
+NCH_WriteBitboardTables(FILE* file){
+#ifndef NCH_PRECOMPUTED_TABLES
+    // both backends are written whatever the current one is.
+    if (!SliderTablesReady[NCH_SliderMagic])
+        init_sliders_table(NCH_SliderMagic);
+    #if NCH_HAS_PEXT
+    if (!SliderTablesReady[NCH_SliderPext])
+        init_sliders_table(NCH_SliderPext);
+    #endif
+#endif
+
+    fprintf(file, "/*\n"
+                  "    bitboard_tables.h\n\n"
+                  "    Generated by NCH_WriteBitboardTables. Do not edit.\n"
+                  "    Included by bitboard.c when NCH_PRECOMPUTED_TABLES is defined.\n"
+                  "*/\n\n");
+
+    write_u64_array(file, "PawnAttacks[2][NCH_SQUARE_NB]", &PawnAttacks[0][0], 2, NCH_SQUARE_NB);
+    write_u64_array(file, "KnightAttacks[NCH_SQUARE_NB]", KnightAttacks, 1, NCH_SQUARE_NB);
+    write_u64_array(file, "KingAttacks[NCH_SQUARE_NB]", KingAttacks, 1, NCH_SQUARE_NB);
+    write_u64_array(file, "BetweenTable[NCH_SQUARE_NB][NCH_SQUARE_NB]", &BetweenTable[0][0], NCH_SQUARE_NB, NCH_SQUARE_NB);
+    write_u64_array(file, "LineBB[NCH_SQUARE_NB][NCH_DIR_NB]", &LineBB[0][0], NCH_SQUARE_NB, NCH_DIR_NB);
+    write_u64_array(file, "Magics[2][NCH_SQUARE_NB]", &Magics[0][0], 2, NCH_SQUARE_NB);
+    write_u64_array(file, "SlidersAttackMask[2][NCH_SQUARE_NB]", &SlidersAttackMask[0][0], 2, NCH_SQUARE_NB);
+    write_int_array(file, "ReleventSquares[2][NCH_SQUARE_NB]", &ReleventSquares[0][0], 2, NCH_SQUARE_NB);
+    write_int_array(file, "SliderOffsets[2][NCH_SQUARE_NB]", &SliderOffsets[0][0], 2, NCH_SQUARE_NB);
+    write_u64_array(file, "RookTable[NCH_ROOK_TABLE_SIZE]", RookTable, 1, NCH_ROOK_TABLE_SIZE);
+    write_u64_array(file, "BishopTable[NCH_BISHOP_TABLE_SIZE]", BishopTable, 1, NCH_BISHOP_TABLE_SIZE);
+
+#if NCH_HAS_PEXT
+    fprintf(file, "#if NCH_HAS_PEXT\n\n");
+    write_u64_array(file, "RookPextTable[NCH_ROOK_TABLE_SIZE]", RookPextTable, 1, NCH_ROOK_TABLE_SIZE);
+    write_u64_array(file, "BishopPextTable[NCH_BISHOP_TABLE_SIZE]", BishopPextTable, 1, NCH_BISHOP_TABLE_SIZE);
+    fprintf(file, "#endif // NCH_HAS_PEXT\n");
+#endif
+
+    return ferror(file) ? -1 : 0;
+}
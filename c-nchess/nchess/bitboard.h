@@ -25,6 +25,8 @@
 #include "config.h"
 #include "types.h"
 
+#include <stdio.h>
+
 // This enum is used be Magics, ReleventSquares, and SlidersAttackMask tables
 // to differentiate between rooks and bishops.
 // the names NCH_RS and NCH_BS are not the best names but this is how it is
@@ -35,10 +37,20 @@ typedef enum{
 }SliderType;
 
 
+// The tables are filled by NCH_InitBitboards unless the library is built with
+// NCH_PRECOMPUTED_TABLES. In that case the tables are generated at build time
+// by NCH_WriteBitboardTables as const data, so they cost nothing at startup and
+// their read only pages are shared between processes.
+#ifdef NCH_PRECOMPUTED_TABLES
+    #define NCH_TABLE const
+#else
+    #define NCH_TABLE
+#endif
+
 // Attack tables for non-sliding pieces (pawns, knights, and kings)
-extern uint64 PawnAttacks[2][NCH_SQUARE_NB];               // 128 
-extern uint64 KnightAttacks[NCH_SQUARE_NB];                // 64
-extern uint64 KingAttacks[NCH_SQUARE_NB];                  // 64
+extern NCH_TABLE uint64 PawnAttacks[2][NCH_SQUARE_NB];               // 128 
+extern NCH_TABLE uint64 KnightAttacks[NCH_SQUARE_NB];                // 64
+extern NCH_TABLE uint64 KingAttacks[NCH_SQUARE_NB];                  // 64
 
 // Table representing the squares between two squares
 // bitboard returned will have the bits set between the two squares
@@ -46,25 +58,50 @@ extern uint64 KingAttacks[NCH_SQUARE_NB];                  // 64
 // the bitboard includes the trg square but not the src square. This
 // trick helpful to detect the possible squares pieces can move to when
 // the king is in check.
-extern uint64 BetweenTable[NCH_SQUARE_NB][NCH_SQUARE_NB];  // 4,096
+extern NCH_TABLE uint64 BetweenTable[NCH_SQUARE_NB][NCH_SQUARE_NB];  // 4,096
 
 // Table representing a line of squares from a square to the edge
 // of the board in a specific direction. This is helpful for move
 // generation to detect the possible squares a the pinned pieces
 // can move to.
-extern uint64 LineBB[NCH_SQUARE_NB][NCH_DIR_NB];  // 4,096
+extern NCH_TABLE uint64 LineBB[NCH_SQUARE_NB][NCH_DIR_NB];  // 4,096
 
 /*
     The rest tabels are for sliding pieces (rooks and bishops).
     Would like to thank Chess Programming youtube channel for the great
     explanation on how to implement magic bitboards.
+
+    The attacks of all squares are packed in one table per slider and
+    each square uses only 1 << relevant bits entries starting from its
+    offset in SliderOffsets (fancy magics). The index inside the square
+    entries comes from either the magic multiplication or the pext
+    instruction, depending on the backend picked by NCH_InitBitboards.
+    Each backend has its own tables since the order of the entries differs.
 */
-extern uint64 Magics[2][NCH_SQUARE_NB];                    // 128
-extern int ReleventSquares[2][NCH_SQUARE_NB];              // 128
-extern uint64 SlidersAttackMask[2][NCH_SQUARE_NB];         // 128
 
-extern uint64 RookTable[NCH_SQUARE_NB][4096];              // 262,144
-extern uint64 BishopTable[NCH_SQUARE_NB][512];             // 32,768
+#define NCH_ROOK_TABLE_SIZE 102400
+#define NCH_BISHOP_TABLE_SIZE 5248
+
+typedef enum{
+    NCH_SliderMagic,
+    NCH_SliderPext,
+}SliderBackend;
+
+extern NCH_TABLE uint64 Magics[2][NCH_SQUARE_NB];                    // 128
+extern NCH_TABLE int ReleventSquares[2][NCH_SQUARE_NB];              // 128
+extern NCH_TABLE uint64 SlidersAttackMask[2][NCH_SQUARE_NB];         // 128
+extern NCH_TABLE int SliderOffsets[2][NCH_SQUARE_NB];                // 128
+
+extern NCH_TABLE uint64 RookTable[NCH_ROOK_TABLE_SIZE];              // 102,400
+extern NCH_TABLE uint64 BishopTable[NCH_BISHOP_TABLE_SIZE];          // 5,248
+
+#if NCH_HAS_PEXT
+extern NCH_TABLE uint64 RookPextTable[NCH_ROOK_TABLE_SIZE];          // 102,400
+extern NCH_TABLE uint64 BishopPextTable[NCH_BISHOP_TABLE_SIZE];      // 5,248
+#endif
+
+// the backend used to index the slider tables.
+extern SliderBackend SliderBackendInUse;
 
 NCH_STATIC_FINLINE uint64
 bb_between(int from_, int to_){
@@ -121,20 +158,35 @@ bb_bishop_magic(int sqr_idx){
     return Magics[NCH_BS][sqr_idx];
 }
 
+NCH_STATIC_FINLINE int
+bb_magic_index(SliderType type, int sqr_idx, uint64 block){
+    block &= SlidersAttackMask[type][sqr_idx];
+    block *= Magics[type][sqr_idx];
+    return (int)(block >> (64 - ReleventSquares[type][sqr_idx]));
+}
+
+// if the compiler targets BMI2 pext is always used, otherwise the backend
+// is checked at runtime.
 NCH_STATIC_FINLINE uint64
 bb_rook_attacks(int sqr_idx, uint64 block){
-    block &= bb_rook_mask(sqr_idx);
-    block *= bb_rook_magic(sqr_idx);
-    block >>= 64 - bb_rook_relevant(sqr_idx);
-    return RookTable[sqr_idx][block];
+#if NCH_HAS_PEXT
+    #if !defined(__BMI2__)
+    if (SliderBackendInUse == NCH_SliderPext)
+    #endif
+        return RookPextTable[SliderOffsets[NCH_RS][sqr_idx] + pext(block, bb_rook_mask(sqr_idx))];
+#endif
+    return RookTable[SliderOffsets[NCH_RS][sqr_idx] + bb_magic_index(NCH_RS, sqr_idx, block)];
 }
 
 NCH_STATIC_FINLINE uint64
 bb_bishop_attacks(int sqr_idx, uint64 block){
-    block &= bb_bishop_mask(sqr_idx);
-    block *= bb_bishop_magic(sqr_idx);
-    block >>= 64 - bb_bishop_relevant(sqr_idx);
-    return BishopTable[sqr_idx][block];
+#if NCH_HAS_PEXT
+    #if !defined(__BMI2__)
+    if (SliderBackendInUse == NCH_SliderPext)
+    #endif
+        return BishopPextTable[SliderOffsets[NCH_BS][sqr_idx] + pext(block, bb_bishop_mask(sqr_idx))];
+#endif
+    return BishopTable[SliderOffsets[NCH_BS][sqr_idx] + bb_magic_index(NCH_BS, sqr_idx, block)];
 }
 
 NCH_STATIC_FINLINE uint64
@@ -151,4 +203,19 @@ bb_line(Square sqr, Diractions dir){
 void
 NCH_InitBitboards();
 
+// Switches the backend of the slider lookups. NCH_InitBitboards picks pext if
+// the cpu supports BMI2 and magics otherwise, this function is only needed to
+// force one of them. The tables of the backend are filled the first time it is
+// used. It must not be called while the tables are used by other threads.
+// Returns 0 on success and -1 if the backend is not supported.
+int
+NCH_SetSliderBackend(SliderBackend backend);
+
+// Writes all the tables of this file as C definitions of const arrays.
+// The output is the bitboard_tables.h that is included by bitboard.c
+// when the library is built with NCH_PRECOMPUTED_TABLES.
+// Returns 0 on success and -1 on failure.
+int
+NCH_WriteBitboardTables(FILE* file);
+
 #endif
\ No newline at end of file
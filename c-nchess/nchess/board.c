@@ -10,6 +10,7 @@
 #include "utils.h"
 #include "hash.h"
 #include "board_utils.h"
+#include "psqt.h"
 #include "makemove.h"
 #include "generate.h"
 
@@ -18,6 +19,14 @@
 #include <stdio.h>
 #include "memory.h"
 
+const uint8 NCH_CASTLE_SQUARES[NCH_SQUARE_NB] = {
+    [NCH_G1] = NCH_H1, [NCH_C1] = NCH_A1,
+    [NCH_G8] = NCH_H8, [NCH_C8] = NCH_A8,
+
+    [NCH_H1] = NCH_F1, [NCH_A1] = NCH_D1,
+    [NCH_H8] = NCH_F8, [NCH_A8] = NCH_D8,
+};
+
 NCH_STATIC_FINLINE void
 _init_board_flags_and_states(Board* board){
     Board_CASTLES(board) = Board_CASTLE_WK | Board_CASTLE_WQ | Board_CASTLE_BK | Board_CASTLE_BQ;
@@ -29,16 +38,6 @@ _init_board_flags_and_states(Board* board){
     Board_CAP_PIECE(board) = NCH_NO_PIECE;
     Board_SIDE(board) = NCH_White;
 
-    Board_CASTLE_SQUARES(board, NCH_G1) = NCH_H1;
-    Board_CASTLE_SQUARES(board, NCH_C1) = NCH_A1;
-    Board_CASTLE_SQUARES(board, NCH_G8) = NCH_H8;
-    Board_CASTLE_SQUARES(board, NCH_C8) = NCH_A8;
-
-    Board_CASTLE_SQUARES(board, NCH_H1) = NCH_F1;
-    Board_CASTLE_SQUARES(board, NCH_A1) = NCH_D1;
-    Board_CASTLE_SQUARES(board, NCH_H8) = NCH_F8;
-    Board_CASTLE_SQUARES(board, NCH_A8) = NCH_D8;
-
     Board_NMOVES(board) = 0;
 }
 
@@ -46,10 +45,11 @@ NCH_STATIC_FINLINE void
 _init_board(Board* board){
     set_board_occupancy(board);
     init_piecetables(board);
+    init_board_scores(board);
     _init_board_flags_and_states(board);
 
-    BoardDict_Init(&Board_DICT(board));
     MoveList_Init(&Board_MOVELIST(board));
+    board->nnue = NULL;
 }
 
 Board*
@@ -75,7 +75,6 @@ Board_NewEmpty(){
 void
 Board_FreeExtraOnly(Board* board){
     if (board){
-        BoardDict_FreeExtra(&Board_DICT(board));
         MoveList_Free(&Board_MOVELIST(board));
     }
 }
@@ -111,6 +110,7 @@ Board_Init(Board* board){
     // starting position does not cause a check to any side but it is better to call
     // the update_check function to make sure that the board is in a valid state.
     update_check(board);
+    init_board_key(board);
 }
 
 void
@@ -138,10 +138,14 @@ Board_InitEmpty(Board* board){
     // setting the value of the same variable twice like this but it is the easiest way
     // for now and it a new desing would be implemented in the future.
     Board_CASTLES(board) = 0;
+    init_board_key(board);
 }
 
 int
 Board_IsCheck(const Board* board){
+    if (!Board_PLY_BB(board, NCH_King))
+        return 0;
+
     return get_checkmap(
             board,
             Board_SIDE(board),
@@ -209,9 +213,34 @@ Board_IsInsufficientMaterial(const Board* board){
     return 0;
 }
 
+// Counts how many times the current position appeared before. Every node
+// in the move list stores the position before its move, so the node at index
+// i is the position at ply i. Only positions with the same side to play are
+// checked and the scan stops at the last capture or pawn move since no position
+// before it could be repeated. No memory is allocated and only a few nodes
+// are visited in practice.
+NCH_STATIC_INLINE int
+count_repetitions(const Board* board){
+    const MoveList* movelist = &Board_MOVELIST(board);
+    int len = movelist->len;
+    int end = len - Board_FIFTY_COUNTER(board);
+    if (end < 0)
+        end = 0;
+
+    uint64 key = Board_KEY(board);
+    int count = 0;
+
+    for (int i = len - 2; i >= end; i -= 2){
+        if (movelist->nodes[i].pos_info.key == key)
+            count++;
+    }
+
+    return count;
+}
+
 int
 Board_IsThreeFold(const Board* board){
-    return BoardDict_GetCount(&Board_DICT(board), Board_BBS_PTR(board)) > 2;
+    return count_repetitions(board) >= 2;
 }
 
 int
@@ -219,19 +248,19 @@ Board_IsFiftyMoves(const Board* board){
     return Board_FIFTY_COUNTER(board) >= 50;
 }
 
+uint64
+Board_ComputeKey(const Board* board){
+    return get_board_key(board);
+}
+
 int
 Board_Copy(const Board* src_board, Board* dst_board){
     *dst_board = *src_board;
+    dst_board->nnue = NULL;
 
-    int res = MoveList_CopyExtra(&Board_MOVELIST(src_board), &Board_MOVELIST(dst_board));
+    int res = MoveList_Copy(&Board_MOVELIST(src_board), &Board_MOVELIST(dst_board));
     if (res < 0)
         return -1;
-    
-    res = BoardDict_CopyExtra(&Board_DICT(src_board), &Board_DICT(dst_board));
-    if (res < 0){
-        MoveList_Free(&Board_MOVELIST(dst_board));
-        return -1;
-    }
 
     return 0;
 }
@@ -243,8 +272,27 @@ Board_NewCopy(const Board* src_board){
         return NULL;
 
     int res = Board_Copy(src_board, dst_board);
-    if (res < 0)
+    if (res < 0){
+        NCH_FREE(dst_board);
         return NULL;
+    }
+    return dst_board;
+}
+
+void
+Board_CopyPosition(const Board* src_board, Board* dst_board){
+    *dst_board = *src_board;
+    MoveList_Init(&Board_MOVELIST(dst_board));
+    dst_board->nnue = NULL;
+}
+
+Board*
+Board_NewCopyPosition(const Board* src_board){
+    Board* dst_board = NCH_MALLOC(sizeof(Board));
+    if (!dst_board)
+        return NULL;
+
+    Board_CopyPosition(src_board, dst_board);
     return dst_board;
 }
 
@@ -275,7 +323,5 @@ Board_State(const Board* board, int can_move){
 
 int
 Board_CanMove(const Board* board){
-    Move moves[256];
-    int nmoves = Board_GenerateLegalMoves(board, moves);
-    return nmoves > 0;
+    return Board_CountLegalMoves(board) > 0;
 }
\ No newline at end of file
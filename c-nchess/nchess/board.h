@@ -48,25 +48,41 @@ typedef struct
     // and the value at that index represents the piece on that square
     // This is useful to retrieve the piece on a square quickly instead of
     // searching through the bitboards.
-    Piece piecetables[NCH_SQUARE_NB];  
+    // Pieces are stored in a byte each to keep the board small.
+    uint8 piecetables[NCH_SQUARE_NB];  
+
+    // the material of every side, the game phase and the piece-square score
+    // of the position. They are updated with the piece table (see psqt.h).
+    int material[NCH_SIDES_NB];
+    int phase;
+    Score psqt;
 
     // stores all variables that gets copied when a step is taken 
     // like flags, castle rights, etc.
     PositionInfo info;
 
-    // These variables are used to store the information related to the move that was made
-    MoveList movelist; // move stack
-    BoardDict dict;   // position dictionary
-
     int nmoves;        // number of half moves
 
-    // A table that containes the source and the destination squares of the rooks
-    // when castling. like for example if the king goes to g1. then in the table
-    // g1 index would contain the rook source square h1 for example and h1 index
-    // would contain the rook destination square f1.
-    Square castle_squares[NCH_SQUARE_NB];
+    // The game history. The nodes are stored outside the board and allocated
+    // only when a move is made through the history, so copying the position
+    // alone is a single copy of a small struct (see Board_CopyPosition).
+    // It also keeps the key of every played position which is used for the
+    // repetition detection.
+    MoveList movelist;
+
+    // the accumulator of the network evaluation updated by the moves or NULL
+    // (see nnue.h). It belongs to the caller and it is not copied with the board.
+    struct NNUEAccumulator* nnue;
 }Board;
 
+// A table that containes the source and the destination squares of the rooks
+// when castling. like for example if the king goes to g1. then in the table
+// g1 index would contain the rook source square h1 for example and h1 index
+// would contain the rook destination square f1.
+// It is the same for every board so it is shared instead of being a part of
+// the board.
+extern const uint8 NCH_CASTLE_SQUARES[NCH_SQUARE_NB];
+
 /*
     Macros below used to access the fields of the board struct
     it is more efficient to use these macros instead of accessing the fields directly
@@ -97,6 +113,10 @@ typedef struct
 
 #define Board_PIECE(board, idx) (board)->piecetables[idx]
 
+#define Board_MATERIAL(board, side) (board)->material[side]
+#define Board_PHASE(board) (board)->phase
+#define Board_PSQT(board) (board)->psqt
+
 #define Board_INFO(board) (board)->info
 
 #define Board_FLAGS(board) Board_INFO(board).flags
@@ -107,14 +127,14 @@ typedef struct
 #define Board_ENP_TRG(board) Board_INFO(board).en_passant_trg
 #define Board_CAP_PIECE(board) Board_INFO(board).captured_piece
 #define Board_SIDE(board) Board_INFO(board).side
+#define Board_KEY(board) Board_INFO(board).key
 #define Board_OP_SIDE(board) NCH_OP_SIDE(Board_SIDE(board))
 
-#define Board_DICT(board) (board)->dict
 #define Board_MOVELIST(board) (board)->movelist
 
 #define Board_NMOVES(board) (board)->nmoves
 
-#define Board_CASTLE_SQUARES(board, sqr) (board)->castle_squares[sqr]
+#define Board_CASTLE_SQUARES(board, sqr) NCH_CASTLE_SQUARES[sqr]
 
 // returns the piece on the square idx
 #define Board_ON_SQUARE(board, idx) Board_PIECE(board, idx)
@@ -181,6 +201,11 @@ Board_NewEmpty();
 void
 Board_Free(Board* board);
 
+// frees the history of the board without freeing the board itself.
+// used for boards that are not allocated by Board_New like boards on the stack.
+void
+Board_FreeExtraOnly(Board* board);
+
 // initializes the board with the standard starting position
 // this functions used if the board is already allocated
 void
@@ -215,7 +240,14 @@ Board_IsThreeFold(const Board* board);
 int
 Board_IsFiftyMoves(const Board* board);
 
-// copies the board to the destination board
+// returns the Zobrist key of the position calculated from scratch.
+// The board keeps its key updated every step (see Board_KEY) so this
+// function is only needed after setting the board manually.
+uint64
+Board_ComputeKey(const Board* board);
+
+// copies the board to the destination board including its history.
+// the destination board must not own a history, it is overwritten.
 // returns 0 on success and -1 on failure
 int
 Board_Copy(const Board* src_board, Board* dst_board);
@@ -224,6 +256,17 @@ Board_Copy(const Board* src_board, Board* dst_board);
 Board*
 Board_NewCopy(const Board* src_board);
 
+// copies the position of the board without its history. it never allocates.
+// the destination board has an empty move list so it could not undo the
+// moves played before the copy and does not see their repetitions.
+// the destination board must not own a history, it is overwritten.
+void
+Board_CopyPosition(const Board* src_board, Board* dst_board);
+
+// copies the position of the board without its history and returns the new board
+Board*
+Board_NewCopyPosition(const Board* src_board);
+
 // checks if the player who has the play has any legal moves or not.
 // Return 1 if there is at least a legal move and False othewise. 
 int
@@ -16,11 +16,13 @@
 #include "types.h"
 #include "config.h"
 #include "utils.h"
+#include "hash.h"
  
 
 /*
-    The reset function run every time a step is made on the board,  
-    whether it is making a move or undoing one.  
+    The reset function removes the castle rights of kings and rooks that are
+    not on their starting squares. It runs when a board is loaded from a fen,
+    moves update the rights with a mask of the squares they touch.
 
     The update_check function also runs every step, but it is also used separately  
     when the board is intilized.
@@ -55,6 +57,10 @@ reset_castle_rights(Board* board){
 
 NCH_STATIC_FINLINE void
 update_check(Board* board){
+    // a board without a king (it could be set by a fen) is never in check.
+    if (!Board_PLY_BB(board, NCH_King))
+        return;
+
     uint64 check_map = get_checkmap(
         board,
         Board_SIDE(board),
@@ -66,4 +72,29 @@ update_check(Board* board){
         NCH_SETFLG(Board_FLAGS(board), more_than_one(check_map) ? Board_CHECK | Board_DOUBLECHECK : Board_CHECK);
 }
 
+NCH_STATIC_INLINE uint64
+get_board_key(const Board* board){
+    uint64 key = 0ULL;
+    int idx;
+    for (Piece p = NCH_WPawn; p < NCH_PIECE_NB; p++){
+        LOOP_U64_T(Board_BB(board, p)){
+            key ^= zobrist_piece(p, idx);
+        }
+    }
+
+    key ^= zobrist_castles(Board_CASTLES(board));
+    key ^= zobrist_enpassant(Board_ENP_IDX(board), Board_ENP_MAP(board));
+
+    if (Board_IS_BLACKTURN(board))
+        key ^= ZobristSide;
+
+    return key;
+}
+
+// sets the board key from scratch. used when the board is initialized.
+NCH_STATIC_INLINE void
+init_board_key(Board* board){
+    Board_KEY(board) = get_board_key(board);
+}
+
 #endif
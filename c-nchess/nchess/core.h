@@ -207,23 +207,28 @@ extern Diractions NCH_DIRACTION_TABLE[NCH_SQUARE_NB][NCH_SQUARE_NB];
 
 typedef struct
 {
-    uint8 castles; // castle rights
-    int flags;     // board flags
-    
+    // Zobrist key of the position. It covers the pieces, the side to play,
+    // the castle rights and the en passant file. It is updated incrementally
+    // every step and restored with the rest of the info on undo.
+    uint64 key;
+
     // These variables are used to store the information realted to en passant
     // The idx is the square of the pawn that moved twice and not the square that
     // the enemy pawn is attacking. The name is misleading and would be changed later.
     // The map is a bitboard where the target pawn and the attacker pawns are set to 1.
     // The trg is a bitboard where the target square the attacker would go to is set to 1.
-    Square en_passant_idx;
     uint64 en_passant_map;
     uint64 en_passant_trg;
 
+    int flags;         // board flags
     int fifty_counter; // counter for fifty moves rule
 
-    Piece captured_piece; // last captured piece. used for undoing moves
-
-    Side side; // side to play
+    // small fields are stored in a byte each and placed at the end
+    // to keep the struct compact.
+    uint8 en_passant_idx; // Square
+    uint8 captured_piece; // Piece. last captured piece. used for undoing moves
+    uint8 side;           // Side. side to play
+    uint8 castles;        // castle rights
 }PositionInfo;
 
 
@@ -0,0 +1,181 @@
+/*
+    expand.c
+
+    The definitions of the bitboard expansion functions.
+    Every version tests the bit of each square against a mask and turns the
+    result of the comparison into 0 or 1. The SIMD versions do that for
+    4 to 32 squares with a single comparison.
+*/
+
+#include "expand.h"
+#include "core.h"
+#include "bit_operations.h"
+
+#include <string.h>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define NCH_EXPAND_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define NCH_EXPAND_SSE2 1
+#endif
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)\
+    || defined(_M_X64) || defined(_M_IX86) || defined(_M_ARM64)
+    #define NCH_EXPAND_LITTLE_ENDIAN 1
+#endif
+
+#if defined(NCH_EXPAND_AVX2)
+
+NCH_STATIC_FINLINE void
+expand_u8(uint64 bb, uint8* out){
+    // every byte of the 32 bits is copied to 8 bytes then each byte
+    // is tested against its own bit.
+    const __m256i shuffle = _mm256_setr_epi8(
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+        2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3
+    );
+    const __m256i bits = _mm256_set1_epi64x((long long)0x8040201008040201ULL);
+    const __m256i one = _mm256_set1_epi8(1);
+
+    for (int i = 0; i < 2; i++){
+        __m256i v = _mm256_set1_epi32((int)(uint32)(bb >> (32 * i)));
+        v = _mm256_shuffle_epi8(v, shuffle);
+        v = _mm256_cmpeq_epi8(_mm256_and_si256(v, bits), bits);
+        _mm256_storeu_si256((__m256i*)(out + 32 * i), _mm256_and_si256(v, one));
+    }
+}
+
+NCH_STATIC_FINLINE void
+expand_i32(uint64 bb, int* out, __m256i one){
+    const __m256i first = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+
+    for (int i = 0; i < 2; i++){
+        __m256i v = _mm256_set1_epi32((int)(uint32)(bb >> (32 * i)));
+        __m256i bits = first;
+        for (int j = 0; j < 4; j++){
+            __m256i m = _mm256_cmpeq_epi32(_mm256_and_si256(v, bits), bits);
+            _mm256_storeu_si256((__m256i*)out, _mm256_and_si256(m, one));
+            bits = _mm256_slli_epi32(bits, 8);
+            out += 8;
+        }
+    }
+}
+
+NCH_STATIC_FINLINE void
+expand_int(uint64 bb, int* out){
+    expand_i32(bb, out, _mm256_set1_epi32(1));
+}
+
+NCH_STATIC_FINLINE void
+expand_float(uint64 bb, float* out){
+    // the bits of 1.0f are used as the "one" so the ints are already floats
+    expand_i32(bb, (int*)out, _mm256_castps_si256(_mm256_set1_ps(1.0f)));
+}
+
+#elif defined(NCH_EXPAND_SSE2)
+
+NCH_STATIC_FINLINE void
+expand_u8(uint64 bb, uint8* out){
+    // SSE2 has no byte shuffle so the two bytes of every 16 bits are spread
+    // with the unpack instructions. v becomes 8 copies of the low byte
+    // followed by 8 copies of the high byte.
+    const __m128i bits = _mm_set1_epi64x((long long)0x8040201008040201ULL);
+    const __m128i one = _mm_set1_epi8(1);
+
+    for (int i = 0; i < 4; i++){
+        __m128i v = _mm_cvtsi32_si128((int)(uint32)((bb >> (16 * i)) & 0xFFFF));
+        v = _mm_unpacklo_epi8(v, v);
+        v = _mm_unpacklo_epi16(v, v);
+        v = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 1, 0, 0));
+        v = _mm_cmpeq_epi8(_mm_and_si128(v, bits), bits);
+        _mm_storeu_si128((__m128i*)(out + 16 * i), _mm_and_si128(v, one));
+    }
+}
+
+NCH_STATIC_FINLINE void
+expand_i32(uint64 bb, int* out, __m128i one){
+    const __m128i first = _mm_setr_epi32(1, 2, 4, 8);
+
+    for (int i = 0; i < 2; i++){
+        __m128i v = _mm_set1_epi32((int)(uint32)(bb >> (32 * i)));
+        __m128i bits = first;
+        for (int j = 0; j < 8; j++){
+            __m128i m = _mm_cmpeq_epi32(_mm_and_si128(v, bits), bits);
+            _mm_storeu_si128((__m128i*)out, _mm_and_si128(m, one));
+            bits = _mm_slli_epi32(bits, 4);
+            out += 4;
+        }
+    }
+}
+
+NCH_STATIC_FINLINE void
+expand_int(uint64 bb, int* out){
+    expand_i32(bb, out, _mm_set1_epi32(1));
+}
+
+NCH_STATIC_FINLINE void
+expand_float(uint64 bb, float* out){
+    // the bits of 1.0f are used as the "one" so the ints are already floats
+    expand_i32(bb, (int*)out, _mm_castps_si128(_mm_set1_ps(1.0f)));
+}
+
+#else
+
+NCH_STATIC_FINLINE void
+expand_u8(uint64 bb, uint8* out){
+#if defined(NCH_EXPAND_LITTLE_ENDIAN)
+    // copies every byte of the bitboard to 8 bytes and keeps a single bit in
+    // each of them. adding 0x7F sets the top bit of a byte only if its bit
+    // is set and never carries to the next byte.
+    uint64 spread;
+    for (int i = 0; i < 8; i++){
+        spread = ((bb >> (8 * i)) & 0xFF) * 0x0101010101010101ULL;
+        spread &= 0x8040201008040201ULL;
+        spread = ((spread + 0x7F7F7F7F7F7F7F7FULL) >> 7) & 0x0101010101010101ULL;
+        memcpy(out + 8 * i, &spread, sizeof(spread));
+    }
+#else
+    for (int i = 0; i < NCH_SQUARE_NB; i++){
+        out[i] = (uint8)((bb >> i) & 1);
+    }
+#endif
+}
+
+// the bytes are expanded first and widened after that. it is much faster
+// than testing the bits one by one since the widening is vectorized.
+NCH_STATIC_FINLINE void
+expand_int(uint64 bb, int* out){
+    uint8 bytes[NCH_SQUARE_NB];
+    expand_u8(bb, bytes);
+    for (int i = 0; i < NCH_SQUARE_NB; i++){
+        out[i] = (int)bytes[i];
+    }
+}
+
+NCH_STATIC_FINLINE void
+expand_float(uint64 bb, float* out){
+    uint8 bytes[NCH_SQUARE_NB];
+    expand_u8(bb, bytes);
+    for (int i = 0; i < NCH_SQUARE_NB; i++){
+        out[i] = (float)bytes[i];
+    }
+}
+
+#endif
+
+void
+bb_expand_u8(uint64 bb, uint8* out, int reversed){
+    expand_u8(reversed ? reverse_bits(bb) : bb, out);
+}
+
+void
+bb_expand_i32(uint64 bb, int* out, int reversed){
+    expand_int(reversed ? reverse_bits(bb) : bb, out);
+}
+
+void
+bb_expand_f32(uint64 bb, float* out, int reversed){
+    expand_float(reversed ? reverse_bits(bb) : bb, out);
+}
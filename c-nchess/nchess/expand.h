@@ -0,0 +1,30 @@
+/*
+    expand.h
+
+    This file contains the functions that expand a bitboard into an array
+    of 64 items, one for every square, set to 1 if the bit of the square is
+    set and 0 otherwise. They are used to convert boards into arrays.
+
+    On x86-64 the expansion uses SSE2 (or AVX2 if the compiler targets it)
+    and works on many squares at once. Other platforms use a portable version.
+*/
+
+#ifndef NCHESS_SRC_EXPAND_H
+#define NCHESS_SRC_EXPAND_H
+
+#include "types.h"
+#include "config.h"
+
+// writes 64 bytes. if reversed is 1 the square 63 is written first.
+void
+bb_expand_u8(uint64 bb, uint8* out, int reversed);
+
+// writes 64 ints. if reversed is 1 the square 63 is written first.
+void
+bb_expand_i32(uint64 bb, int* out, int reversed);
+
+// writes 64 floats. if reversed is 1 the square 63 is written first.
+void
+bb_expand_f32(uint64 bb, float* out, int reversed);
+
+#endif // NCHESS_SRC_EXPAND_H
@@ -7,8 +7,12 @@
 #include "fen.h"
 #include "utils.h"
 #include "board_utils.h"
+#include "psqt.h"
+#include "thread.h"
+#include "memory.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #define PARSE(func)\
 while (*fen == ' ') {fen++;}\
@@ -28,74 +32,18 @@ end_of_str(char s){
     return s == '\0' || s == ' ';
 }
 
-NCH_STATIC_INLINE void
-char2piece(char c, Side* side, PieceType* piece){
-    switch (c)
-    {
-    case 'P':
-        *piece = NCH_Pawn;
-        *side = NCH_White;
-        break;
-
-    case 'N':
-        *piece = NCH_Knight;
-        *side = NCH_White;
-        break;
-    case 'B':
-        *piece = NCH_Bishop;
-        *side = NCH_White;
-        break;
-
-    case 'R':
-        *piece = NCH_Rook;
-        *side = NCH_White;
-        break;
-
-    case 'Q':
-        *piece = NCH_Queen;
-        *side = NCH_White;
-        break;
-
-    case 'K':
-        *piece = NCH_King;
-        *side = NCH_White;
-        break;
-
-    case 'p':
-        *piece = NCH_Pawn;
-        *side = NCH_Black;
-        break;
-
-    case 'n':
-        *piece = NCH_Knight;
-        *side = NCH_Black;
-        break;
-
-    case 'b':
-        *piece = NCH_Bishop;
-        *side = NCH_Black;
-        break;
-
-    case 'r':
-        *piece = NCH_Rook;
-        *side = NCH_Black;
-        break;
-
-    case 'q':
-        *piece = NCH_Queen;
-        *side = NCH_Black;
-        break;
-
-    case 'k':
-        *piece = NCH_King;
-        *side = NCH_Black;
-        break;
-
-    default:
-        *piece = NCH_NO_PIECE_TYPE;
-        *side = NCH_SIDES_NB;
-        break;
-    }
+// the piece of every char that could be in the placement field of a fen.
+// it is NCH_NO_PIECE for the other chars.
+NCH_STATIC const uint8 CHAR_PIECE[128] = {
+    ['P'] = NCH_WPawn, ['N'] = NCH_WKnight, ['B'] = NCH_WBishop,
+    ['R'] = NCH_WRook, ['Q'] = NCH_WQueen, ['K'] = NCH_WKing,
+    ['p'] = NCH_BPawn, ['n'] = NCH_BKnight, ['b'] = NCH_BBishop,
+    ['r'] = NCH_BRook, ['q'] = NCH_BQueen, ['k'] = NCH_BKing,
+};
+
+NCH_STATIC_INLINE Piece
+char_to_piece(char c){
+    return (Piece)CHAR_PIECE[(uint8)c & 0x7F];
 }
 
 NCH_STATIC_INLINE int
@@ -110,14 +58,13 @@ char2number(char c){
 
 NCH_STATIC_INLINE Square
 str2square(const char* s){
-    return ('h' - s[0]) + (char2number(s[1]) * 8); 
+    return ('h' - s[0]) + ((char2number(s[1]) - 1) * 8);
 }
 
 const char*
 parse_bb(Board* board, const char* fen){
     Square sqr = NCH_A8;
-    PieceType piece;
-    Side side;
+    Piece piece;
 
     for (Piece p = 0; p < NCH_PIECE_NB; p++){
         Board_BB(board, p) = 0ull;
@@ -129,9 +76,9 @@ parse_bb(Board* board, const char* fen){
             sqr -= char2number(*fen);
         }
         else if (*fen != '/'){
-            char2piece(*fen, &side, &piece);
-            if (piece != NCH_NO_PIECE_TYPE){
-                Board_BB_BYTYPE(board, side, piece) |= NCH_SQR(sqr);
+            piece = char_to_piece(*fen);
+            if (piece != NCH_NO_PIECE){
+                Board_BB(board, piece) |= NCH_SQR(sqr);
                 sqr--;
             }
         }
@@ -190,9 +137,11 @@ parse_enpassant(Board* board, const char* fen){
         if (!is_valid_square(enp_sqr))
             return NULL;
 
-        if (NCH_GET_ROWIDX(enp_sqr) == 6)
+        // the fen gives the square behind the pawn, the board
+        // stores the square of the pawn that moved two steps.
+        if (NCH_GET_ROWIDX(enp_sqr) == 5)
             enp_sqr -= 8;
-        else if (NCH_GET_ROWIDX(enp_sqr) == 3)
+        else if (NCH_GET_ROWIDX(enp_sqr) == 2)
             enp_sqr += 8;
         else
             return NULL;
@@ -267,7 +216,13 @@ Board_FromFen(const char* fen, Board* dst_board){
     }
     set_board_occupancy(dst_board);
     init_piecetables(dst_board);
+    init_board_scores(dst_board);
+
+    // moves only remove castle rights when a king or a rook square is touched
+    // so rights of pieces that are not on their squares are removed here.
+    reset_castle_rights(dst_board);
     update_check(dst_board);
+    init_board_key(dst_board);
     return 0;
 }
 
@@ -346,7 +301,9 @@ enpassant_to_fen(const Board* board, char* fen){
     else{
         Square sqr = Board_ENP_IDX(board);
         int col = NCH_GET_COLIDX(sqr);
-        *fen++ = num_to_char(col);
+        int row = NCH_GET_ROWIDX(sqr) == 3 ? 2 : 5;
+        *fen++ = 'h' - col;
+        *fen++ = num_to_char(row + 1);
     }
     return fen;
 }
@@ -402,4 +359,334 @@ Board_AsFen(const Board* board, char* des_fen){
     TO_FEN(enpassant_to_fen, ' ')
     TO_FEN(fifty_to_fen, ' ')
     TO_FEN(nmoves_to_fen, '\0')
-}
\ No newline at end of file
+}
+
+/*
+    Batch functions
+*/
+
+// the longest line that is read. longer lines are reported as errors.
+#define FEN_LINE_MAX 256
+
+// buffers smaller than this are read by a single thread.
+#define FEN_MIN_CHUNK_SIZE (1 << 16)
+
+NCH_STATIC_INLINE int
+is_space(char c){
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+NCH_STATIC_INLINE int
+is_line_empty(const char* line, const char* end){
+    while (line < end){
+        if (!is_space(*line))
+            return 0;
+        line++;
+    }
+    return 1;
+}
+
+NCH_STATIC_INLINE const char*
+line_end(const char* line, const char* end){
+    const char* nl = (const char*)memchr(line, '\n', end - line);
+    return nl ? nl : end;
+}
+
+// checks that the placement field has 8 ranks of 8 squares and only known chars.
+// parse_bb accepts anything so a line of text could be read as a position.
+NCH_STATIC int
+is_valid_placement(const char* fen){
+    int rank_squares = 0, ranks = 1;
+
+    while (!end_of_str(*fen)){
+        if (*fen == '/'){
+            if (rank_squares != 8)
+                return 0;
+            rank_squares = 0;
+            ranks++;
+        }
+        else if (is_number(*fen) && *fen != '0' && *fen != '9'){
+            rank_squares += char2number(*fen);
+        }
+        else{
+            if (char_to_piece(*fen) == NCH_NO_PIECE)
+                return 0;
+            rank_squares++;
+        }
+
+        if (rank_squares > 8)
+            return 0;
+        fen++;
+    }
+
+    return ranks == 8 && rank_squares == 8;
+}
+
+NCH_STATIC_INLINE int
+is_number_field(const char* field, const char* end){
+    if (field == end)
+        return 0;
+    while (field < end){
+        if (!is_number(*field))
+            return 0;
+        field++;
+    }
+    return 1;
+}
+
+// copies the fen fields of the line to a null terminated string and reads it.
+// returns 0 on success and -1 on failure.
+NCH_STATIC int
+fen_line_to_board(const char* line, const char* end, Board* board){
+    char fen[FEN_LINE_MAX];
+    char* out = fen;
+    const char* field_end;
+    int nfields = 0;
+
+    Board_InitEmpty(board);
+
+    while (line < end && *line != ',' && *line != ';'){
+        if (is_space(*line)){
+            line++;
+            continue;
+        }
+
+        field_end = line;
+        while (field_end < end && !is_space(*field_end) && *field_end != ',' && *field_end != ';'){
+            field_end++;
+        }
+
+        // the fields after the en passant square are only numbers
+        if (nfields >= 4 && !is_number_field(line, field_end))
+            break;
+
+        if (nfields == 6 || (out - fen) + (field_end - line) + 2 > FEN_LINE_MAX)
+            return -1;
+
+        if (nfields)
+            *out++ = ' ';
+        memcpy(out, line, field_end - line);
+        out += field_end - line;
+        nfields++;
+        line = field_end;
+    }
+    *out = '\0';
+
+    if (nfields < 3 || !is_valid_placement(fen))
+        return -1;
+
+    if (Board_FromFen(fen, board) < 0){
+        Board_InitEmpty(board);
+        return -1;
+    }
+    return 0;
+}
+
+typedef struct
+{
+    const char* begin;  // the chunk starts at the start of a line
+    const char* end;
+    long long nboards;  // non empty lines of the chunk
+    long long nlines;   // all lines of the chunk
+
+    // set before reading the boards
+    long long first_board;
+    long long first_line;
+
+    // shared by all chunks
+    Board* boards;
+    int* status;
+    long long* lines;
+    long long max_boards;
+}FenChunk;
+
+NCH_STATIC void
+fen_chunk_count(void* arg){
+    FenChunk* chunk = (FenChunk*)arg;
+    const char* line = chunk->begin;
+    const char* end;
+
+    chunk->nboards = 0;
+    chunk->nlines = 0;
+    while (line < chunk->end){
+        end = line_end(line, chunk->end);
+        if (!is_line_empty(line, end))
+            chunk->nboards++;
+        chunk->nlines++;
+        line = end + 1;
+    }
+}
+
+NCH_STATIC void
+fen_chunk_read(void* arg){
+    FenChunk* chunk = (FenChunk*)arg;
+    const char* line = chunk->begin;
+    const char* end;
+    long long idx = chunk->first_board;
+    long long line_number = chunk->first_line;
+
+    while (line < chunk->end && idx < chunk->max_boards){
+        end = line_end(line, chunk->end);
+        if (!is_line_empty(line, end)){
+            chunk->status[idx] = fen_line_to_board(line, end, chunk->boards + idx);
+            if (chunk->lines)
+                chunk->lines[idx] = line_number;
+            idx++;
+        }
+        line_number++;
+        line = end + 1;
+    }
+}
+
+// splits the buffer into chunks that start at the start of a line.
+// returns the chunks array and sets nchunks. returns NULL on failure.
+NCH_STATIC FenChunk*
+fen_split_chunks(const char* buffer, size_t len, int nthreads, int* nchunks){
+    if (nthreads <= 0)
+        nthreads = NCH_CPUCount();
+    if ((size_t)nthreads > len / FEN_MIN_CHUNK_SIZE)
+        nthreads = (int)(len / FEN_MIN_CHUNK_SIZE);
+    if (nthreads < 1)
+        nthreads = 1;
+
+    FenChunk* chunks = (FenChunk*)NCH_CALLOC(nthreads, sizeof(FenChunk));
+    if (!chunks)
+        return NULL;
+
+    const char* end = buffer + len;
+    const char* begin = buffer;
+    const char* split;
+    int n = 0;
+    for (int i = 0; i < nthreads && begin < end; i++){
+        split = i == nthreads - 1 ? end : buffer + len / nthreads * (i + 1);
+        if (split < begin)
+            split = begin;
+        if (split < end){
+            split = line_end(split, end);
+            if (split < end)
+                split++;
+        }
+
+        chunks[n].begin = begin;
+        chunks[n].end = split;
+        n++;
+        begin = split;
+    }
+
+    *nchunks = n;
+    return chunks;
+}
+
+long long
+Board_CountFenLines(const char* buffer, size_t len, int nthreads){
+    int nchunks;
+    FenChunk* chunks = fen_split_chunks(buffer, len, nthreads, &nchunks);
+    if (!chunks)
+        return -1;
+
+    NCH_RunChunks(chunks, nchunks, sizeof(FenChunk), fen_chunk_count);
+
+    long long total = 0;
+    for (int i = 0; i < nchunks; i++){
+        total += chunks[i].nboards;
+    }
+
+    NCH_FREE(chunks);
+    return total;
+}
+
+long long
+Board_FromFenLines(const char* buffer, size_t len, Board* boards, int* status,
+                   long long* lines, long long max_boards, int nthreads)
+{
+    int nchunks;
+    FenChunk* chunks = fen_split_chunks(buffer, len, nthreads, &nchunks);
+    if (!chunks)
+        return -1;
+
+    if (nchunks > 1)
+        NCH_RunChunks(chunks, nchunks, sizeof(FenChunk), fen_chunk_count);
+
+    long long first_board = 0, first_line = 1;
+    for (int i = 0; i < nchunks; i++){
+        chunks[i].first_board = first_board;
+        chunks[i].first_line = first_line;
+        chunks[i].boards = boards;
+        chunks[i].status = status;
+        chunks[i].lines = lines;
+        chunks[i].max_boards = max_boards;
+        first_board += chunks[i].nboards;
+        first_line += chunks[i].nlines;
+    }
+
+    NCH_RunChunks(chunks, nchunks, sizeof(FenChunk), fen_chunk_read);
+
+    // with a single chunk the lines were not counted before reading
+    if (nchunks == 1)
+        fen_chunk_count(chunks);
+
+    long long total = 0;
+    for (int i = 0; i < nchunks; i++){
+        total += chunks[i].nboards;
+    }
+
+    NCH_FREE(chunks);
+    return total < max_boards ? total : max_boards;
+}
+
+typedef struct
+{
+    const Board* boards;
+    long long n;
+    char* out;
+    long long len;
+}FenWriteChunk;
+
+NCH_STATIC void
+fen_chunk_write(void* arg){
+    FenWriteChunk* chunk = (FenWriteChunk*)arg;
+    char* out = chunk->out;
+
+    for (long long i = 0; i < chunk->n; i++){
+        Board_AsFen(chunk->boards + i, out);
+        out += strlen(out);
+        *out++ = '\n';
+    }
+
+    chunk->len = out - chunk->out;
+}
+
+long long
+Board_AsFenLines(const Board* boards, long long n, char* out, int nthreads){
+    if (nthreads <= 0)
+        nthreads = NCH_CPUCount();
+    if (nthreads > n / 1024)
+        nthreads = (int)(n / 1024);
+    if (nthreads < 1)
+        nthreads = 1;
+
+    FenWriteChunk* chunks = (FenWriteChunk*)NCH_CALLOC(nthreads, sizeof(FenWriteChunk));
+    if (!chunks)
+        return -1;
+
+    // every chunk writes to its own part of out and the parts are
+    // moved next to each other after all of them are done.
+    long long per_chunk = n / nthreads, first = 0;
+    for (int i = 0; i < nthreads; i++){
+        chunks[i].boards = boards + first;
+        chunks[i].n = i == nthreads - 1 ? n - first : per_chunk;
+        chunks[i].out = out + first * NCH_FEN_MAX_LENGTH;
+        first += chunks[i].n;
+    }
+
+    NCH_RunChunks(chunks, nthreads, sizeof(FenWriteChunk), fen_chunk_write);
+
+    long long len = chunks[0].len;
+    for (int i = 1; i < nthreads; i++){
+        memmove(out + len, chunks[i].out, chunks[i].len);
+        len += chunks[i].len;
+    }
+
+    NCH_FREE(chunks);
+    return len;
+}
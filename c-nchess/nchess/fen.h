@@ -37,10 +37,51 @@ Board_NewFen(const char* fen);
 int
 Board_FromFen(const char* fen, Board* dst_board);
 
+// the size of a buffer that could hold any FEN written by Board_AsFen
+// including the null terminator.
+#define NCH_FEN_MAX_LENGTH 128
+
 // Generates the FEN representation of the board to the give destenation char pointer (des_fen).
 // The FEN includs all standard parameters (piece placement, turn, castling rights,
 // en passant target, fifty moves and fullmove number).
 void
 Board_AsFen(const Board* board, char* des_fen);
 
+/*
+    Batch functions. They work on a buffer of FENs separated by new lines
+    like the content of an EPD or a CSV file and split the work between
+    threads. The buffer does not need a null terminator so it could be a
+    memory mapped file.
+
+    Every line is read up to the first ',' or ';'. Fields after the castle
+    rights and the en passant square are kept only if they are numbers so
+    the operations of EPD lines are ignored. Lines that have only spaces
+    are skipped.
+*/
+
+// returns the number of lines of the buffer that are not empty.
+// it is the number of boards Board_FromFenLines would read.
+long long
+Board_CountFenLines(const char* buffer, size_t len, int nthreads);
+
+// Reads the FEN of every non empty line of the buffer into the boards array.
+// A line that could not be read does not stop the others. its board is left
+// empty and its status is -1, the status of a good line is 0.
+// lines is optional (could be NULL). if given it gets the line number
+// (starting from 1) of every board.
+// The boards must not own a history, they are overwritten.
+// At most max_boards boards are read. nthreads <= 0 means the number of
+// processors.
+// returns the number of boards read and -1 on allocation failure.
+long long
+Board_FromFenLines(const char* buffer, size_t len, Board* boards, int* status,
+                   long long* lines, long long max_boards, int nthreads);
+
+// Writes the FEN of every board followed by a new line into out.
+// out must have space for n * NCH_FEN_MAX_LENGTH chars.
+// returns the number of chars written (there is no null terminator)
+// and -1 on allocation failure.
+long long
+Board_AsFenLines(const Board* boards, long long n, char* out, int nthreads);
+
 #endif
\ No newline at end of file
@@ -52,6 +52,10 @@ get_pinned_pieces(const Board* board, uint64* pinned_allowed_squares){
     uint64  all_occ = Board_ALL_OCC(board);
     int     enp_idx = Board_ENP_IDX(board);
     uint64  enp_map = Board_ENP_MAP(board);
+
+    // if there is no king on the board for some reason we don't want to crash.
+    if (king_idx >= 64)
+        return 0ULL;
     
     uint64 queen_like = bb_queen_attacks(king_idx, all_occ);
     uint64 around = (queen_like & self_occ); // currently playing player's pieces only
@@ -144,43 +148,46 @@ bb_to_moves(uint64 bb, int idx, Move* moves){
     return moves;
 }
 
-NCH_STATIC_INLINE void*
-generate_queen_moves(const Board* board, int idx, uint64 allowed_squares, Move* moves){
+NCH_STATIC_INLINE uint64
+get_queen_targets(const Board* board, int idx, uint64 allowed_squares){
     uint64 occ = Board_ALL_OCC(board);
-    uint64 bb = bb_queen_attacks(idx, occ) & allowed_squares;
-    return bb_to_moves(bb, idx, moves);
+    return bb_queen_attacks(idx, occ) & allowed_squares;
 }
 
-NCH_STATIC_INLINE void*
-generate_rook_moves(const Board* board, int idx, uint64 allowed_squares, Move* moves){
+NCH_STATIC_INLINE uint64
+get_rook_targets(const Board* board, int idx, uint64 allowed_squares){
     uint64 occ = Board_ALL_OCC(board);
-    uint64 bb = bb_rook_attacks(idx, occ) & allowed_squares;
-    return bb_to_moves(bb, idx, moves);
+    return bb_rook_attacks(idx, occ) & allowed_squares;
 }
 
-NCH_STATIC_INLINE void*
-generate_bishop_moves(const Board* board, int idx, uint64 allowed_squares, Move* moves){
+NCH_STATIC_INLINE uint64
+get_bishop_targets(const Board* board, int idx, uint64 allowed_squares){
     uint64 occ = Board_ALL_OCC(board);
-    uint64 bb = bb_bishop_attacks(idx, occ) & allowed_squares;
-    return bb_to_moves(bb, idx, moves);
+    return bb_bishop_attacks(idx, occ) & allowed_squares;
 }
 
-NCH_STATIC_INLINE void*
-generate_knight_moves(NCH_UNUSED(const Board* board), int idx, uint64 allowed_squares, Move* moves){
-    uint64 bb = bb_knight_attacks(idx) & allowed_squares;
-    return bb_to_moves(bb, idx, moves);
+NCH_STATIC_INLINE uint64
+get_knight_targets(NCH_UNUSED(const Board* board), int idx, uint64 allowed_squares){
+    return bb_knight_attacks(idx) & allowed_squares;
 }
 
-NCH_STATIC_INLINE void*
-generate_pawn_moves(const Board* board, int idx, uint64 allowed_squares, Move* moves){
+// returns 1 if a pawn of the side to play on idx moves to the last row.
+NCH_STATIC_INLINE int
+pawn_could_promote(const Board* board, int idx){
+    return Board_SIDE(board) == NCH_White ? NCH_GET_ROWIDX(idx) == 6
+                                          : NCH_GET_ROWIDX(idx) == 1;
+}
+
+// returns the squares a pawn could move to including the en passant target.
+NCH_STATIC_FINLINE uint64
+get_pawn_targets(const Board* board, int idx, uint64 allowed_squares, GenStage stage){
     Side ply_side = Board_SIDE(board);
     Side op_side = NCH_OP_SIDE(ply_side);
 
     int could2sqr = ply_side == NCH_White ? NCH_GET_ROWIDX(idx) == 1
                                           : NCH_GET_ROWIDX(idx) == 6;
 
-    int couldpromote = ply_side == NCH_White ? NCH_GET_ROWIDX(idx) == 6
-                                             : NCH_GET_ROWIDX(idx) == 1;
+    int couldpromote = pawn_could_promote(board, idx);
 
 
     uint64 op_occ = Board_OCC(board, op_side);
@@ -212,6 +219,25 @@ generate_pawn_moves(const Board* board, int idx, uint64 allowed_squares, Move* m
 
     bb &= allowed_squares;
 
+    // promotions are generated with the captures even if they are not capturing
+    // anything. so the quiet stage never generates them.
+    if (couldpromote){
+        if (stage == GenStage_Quiets)
+            return 0ULL;
+    }
+    else if (stage == GenStage_Captures){
+        bb &= op_occ | Board_ENP_TRG(board);
+    }
+    else if (stage == GenStage_Quiets){
+        bb &= ~(op_occ | Board_ENP_TRG(board));
+    }
+
+    return bb;
+}
+
+NCH_STATIC_FINLINE void*
+generate_pawn_moves(const Board* board, int idx, uint64 allowed_squares, GenStage stage, Move* moves){
+    uint64 bb = get_pawn_targets(board, idx, allowed_squares, stage);
     if (!bb)
         return moves;
 
@@ -219,7 +245,7 @@ generate_pawn_moves(const Board* board, int idx, uint64 allowed_squares, Move* m
 
     int target;
     
-    if (couldpromote){
+    if (pawn_could_promote(board, idx)){
         while (bb)
         {
             target = NCH_SQRIDX(bb);
@@ -250,49 +276,89 @@ generate_pawn_moves(const Board* board, int idx, uint64 allowed_squares, Move* m
     return moves;
 }
 
-typedef void* (*MoveGenFunction) (const Board* board, int idx, uint64 allowed_squares, Move* moves);
+typedef uint64 (*TargetsFunction) (const Board* board, int idx, uint64 allowed_squares);
 
-NCH_STATIC MoveGenFunction MoveGenFunctionTable[] = {
+// pawns are not in the table because they need the stage to split
+// the promotions from the quiet moves. see generate_any_move.
+NCH_STATIC TargetsFunction TargetsFunctionTable[] = {
+    NULL,
     NULL,
-    generate_pawn_moves,
-    generate_knight_moves,
-    generate_bishop_moves,
-    generate_rook_moves,
-    generate_queen_moves,
+    get_knight_targets,
+    get_bishop_targets,
+    get_rook_targets,
+    get_queen_targets,
 };
 
+// returns the squares a piece could move to in a stage. a capture is a move
+// to a square of the opponent and a quiet move is a move to an empty square.
+// pawns handle en passant and promotions on their own.
+NCH_STATIC_INLINE uint64
+get_stage_targets(const Board* board, GenStage stage){
+    if (stage == GenStage_Captures)
+        return Board_OCC(board, Board_OP_SIDE(board));
+    if (stage == GenStage_Quiets)
+        return ~Board_ALL_OCC(board);
+    return NCH_UINT64_MAX;
+}
+
 // generate any move for a piece on the board except the king.
 // that is why it is not a safe function and it is only used in the
 // in this file.
 NCH_STATIC_INLINE void*
-generate_any_move(const Board* board, int idx, uint64 allowed_squares, Move* moves){
+generate_any_move(const Board* board, int idx, uint64 allowed_squares, GenStage stage, Move* moves){
     PieceType p = Piece_TYPE(Board_PIECE(board, idx));
-    MoveGenFunction func = MoveGenFunctionTable[p];
-    return func(board, idx, allowed_squares, moves);
+    if (p == NCH_Pawn)
+        return generate_pawn_moves(board, idx, allowed_squares, stage, moves);
+
+    TargetsFunction func = TargetsFunctionTable[p];
+    return bb_to_moves(func(board, idx, allowed_squares & get_stage_targets(board, stage)), idx, moves);
 }
 
-NCH_STATIC_INLINE void*
-generate_king_moves(const Board* board, Move* moves){
+// counts the legal moves of any piece on the board except the king.
+// a promotion counts as four moves.
+NCH_STATIC_INLINE int
+count_any_move(const Board* board, int idx, uint64 allowed_squares){
+    PieceType p = Piece_TYPE(Board_PIECE(board, idx));
+    if (p == NCH_Pawn){
+        int n = count_bits(get_pawn_targets(board, idx, allowed_squares, GenStage_All));
+        return pawn_could_promote(board, idx) ? n * 4 : n;
+    }
+
+    TargetsFunction func = TargetsFunctionTable[p];
+    return count_bits(func(board, idx, allowed_squares));
+}
+
+// returns the squares the king could move to safely.
+NCH_STATIC_INLINE uint64
+get_king_targets(const Board* board, int king_idx, uint64 targets){
     Side side = Board_SIDE(board);
-    int king_idx = NCH_SQRIDX( Board_PLY_BB(board, NCH_King) );
 
-    // if there is no king on the board for some reason we don't want to crash.
-    if (king_idx >= 64)
-        return moves;
-        
     uint64 bb =  bb_king_attacks(king_idx)
               &  ~Board_OCC(board, side)
-              &  ~bb_king_attacks(NCH_SQRIDX(Board_OP_BB(board, NCH_King)));
+              &  ~bb_king_attacks(NCH_SQRIDX(Board_OP_BB(board, NCH_King)))
+              &  targets;
+    uint64 safe = 0ULL;
     int target;
     while (bb)
     {
         target = NCH_SQRIDX(bb);
         if (!get_checkmap(board, side, target, Board_ALL_OCC(board)))
-            *moves++ = _Move_New(king_idx, target, NCH_Knight, MoveType_Normal);
+            safe |= NCH_SQR(target);
         bb &= bb - 1;
     }
 
-    return moves;
+    return safe;
+}
+
+NCH_STATIC_INLINE void*
+generate_king_moves(const Board* board, uint64 targets, Move* moves){
+    int king_idx = NCH_SQRIDX( Board_PLY_BB(board, NCH_King) );
+
+    // if there is no king on the board for some reason we don't want to crash.
+    if (king_idx >= 64)
+        return moves;
+
+    return bb_to_moves(get_king_targets(board, king_idx, targets), king_idx, moves);
 }
 
 NCH_STATIC_INLINE void*
@@ -335,16 +401,22 @@ generate_castle_moves(const Board* board, Move* moves){
     return moves;
 }
 
-int
-Board_GenerateLegalMoves(const Board* board, Move* moves){
-    uint64 pinned_allowed_square[8];
-    Move* mh = moves;
+// computes everything the stages need that depends only on the position.
+// it is done once per node and shared between the stages.
+NCH_STATIC_INLINE void
+init_gen_info(const Board* board, GenInfo* info){
+    Side side = Board_SIDE(board);
+    info->allowed_squares = get_allowed_squares(board) &~ Board_OCC(board, side);
+    info->pinned_pieces = get_pinned_pieces(board, info->pinned_allowed_squares);
+}
 
+NCH_STATIC_FINLINE Move*
+generate_stage(const Board* board, const GenInfo* info, GenStage stage, Move* moves){
     Side side = Board_SIDE(board);
     uint64 self_occ = Board_OCC(board, side);
-    
-    uint64 allowed_squares = get_allowed_squares(board) &~ self_occ;
-    uint64 pinned_pieces = get_pinned_pieces(board, pinned_allowed_square);
+
+    uint64 allowed_squares = info->allowed_squares;
+    uint64 pinned_pieces = info->pinned_pieces;
     uint64 not_pinned_pieces = self_occ &~ (pinned_pieces | Board_BB_BYTYPE(board, side, NCH_King));
 
     if (allowed_squares){
@@ -352,7 +424,7 @@ Board_GenerateLegalMoves(const Board* board, Move* moves){
         while (not_pinned_pieces)
         {
             idx = NCH_SQRIDX(not_pinned_pieces);
-            moves = generate_any_move(board, idx, allowed_squares, moves);
+            moves = generate_any_move(board, idx, allowed_squares, stage, moves);
             not_pinned_pieces &= not_pinned_pieces - 1;
         }    
 
@@ -360,16 +432,148 @@ Board_GenerateLegalMoves(const Board* board, Move* moves){
         while (pinned_pieces)
         {
             idx = NCH_SQRIDX(pinned_pieces);
-            moves = generate_any_move(board, idx, pinned_allowed_square[i++] & allowed_squares, moves);
+            moves = generate_any_move(board, idx, info->pinned_allowed_squares[i++] & allowed_squares, stage, moves);
             pinned_pieces &= pinned_pieces - 1;
         }
 
-        moves = generate_castle_moves(board, moves);
+        if (stage != GenStage_Captures)
+            moves = generate_castle_moves(board, moves);
+    }
+
+    moves = generate_king_moves(board, get_stage_targets(board, stage), moves);
+    return moves;
+}
+
+int
+Board_GenerateLegalMoves(const Board* board, Move* moves){
+    GenInfo info;
+    init_gen_info(board, &info);
+    Move* end = generate_stage(board, &info, GenStage_All, moves);
+    return (int)(end - moves);
+}
+
+int
+Board_GenerateCaptures(const Board* board, Move* moves){
+    GenInfo info;
+    init_gen_info(board, &info);
+    Move* end = generate_stage(board, &info, GenStage_Captures, moves);
+    return (int)(end - moves);
+}
+
+int
+Board_GenerateQuiets(const Board* board, Move* moves){
+    GenInfo info;
+    init_gen_info(board, &info);
+    Move* end = generate_stage(board, &info, GenStage_Quiets, moves);
+    return (int)(end - moves);
+}
+
+int
+Board_GenerateEvasions(const Board* board, Move* moves){
+    if (!Board_IS_CHECK(board))
+        return 0;
+    return Board_GenerateLegalMoves(board, moves);
+}
+
+// counts the legal moves the same way Board_GenerateLegalMoves generates them
+// but only counts the bits of the targets. if counts is not NULL the moves
+// of each piece type are added to it. castles are counted as king moves.
+NCH_STATIC_FINLINE int
+count_legal_moves(const Board* board, int* counts){
+    GenInfo info;
+    init_gen_info(board, &info);
+
+    Side side = Board_SIDE(board);
+    uint64 self_occ = Board_OCC(board, side);
+    uint64 pinned_pieces = info.pinned_pieces;
+    uint64 not_pinned_pieces = self_occ &~ (pinned_pieces | Board_BB_BYTYPE(board, side, NCH_King));
+
+    int total = 0, n;
+    if (info.allowed_squares){
+        int idx;
+        while (not_pinned_pieces)
+        {
+            idx = NCH_SQRIDX(not_pinned_pieces);
+            n = count_any_move(board, idx, info.allowed_squares);
+            if (counts)
+                counts[Piece_TYPE(Board_PIECE(board, idx))] += n;
+            total += n;
+            not_pinned_pieces &= not_pinned_pieces - 1;
+        }
+
+        int i = 0;
+        while (pinned_pieces)
+        {
+            idx = NCH_SQRIDX(pinned_pieces);
+            n = count_any_move(board, idx, info.pinned_allowed_squares[i++] & info.allowed_squares);
+            if (counts)
+                counts[Piece_TYPE(Board_PIECE(board, idx))] += n;
+            total += n;
+            pinned_pieces &= pinned_pieces - 1;
+        }
+
+        Move castles[2];
+        n = (int)((Move*)generate_castle_moves(board, castles) - castles);
+        if (counts)
+            counts[NCH_King] += n;
+        total += n;
+    }
+
+    int king_idx = NCH_SQRIDX( Board_PLY_BB(board, NCH_King) );
+    if (king_idx < 64){
+        n = count_bits(get_king_targets(board, king_idx, NCH_UINT64_MAX));
+        if (counts)
+            counts[NCH_King] += n;
+        total += n;
+    }
+
+    return total;
+}
+
+int
+Board_CountLegalMoves(const Board* board){
+    return count_legal_moves(board, NULL);
+}
+
+int
+Board_CountLegalMovesByType(const Board* board, int* counts){
+    memset(counts, 0, sizeof(int) * NCH_PIECE_TYPE_NB);
+    return count_legal_moves(board, counts);
+}
+
+void
+MoveGen_Init(MoveGen* gen, const Board* board, int captures_only){
+    gen->board = board;
+    gen->len = 0;
+    gen->cur = 0;
+    init_gen_info(board, &gen->info);
+
+    // when the king is under check there are only a few legal moves and all of
+    // them are generated at once in one evasion stage.
+    if (Board_IS_CHECK(board)){
+        gen->stage = GenStage_All;
+        gen->last_stage = GenStage_All;
+    }
+    else{
+        gen->stage = GenStage_Captures;
+        gen->last_stage = captures_only ? GenStage_Captures : GenStage_Quiets;
+    }
+}
+
+int
+MoveGen_Next(MoveGen* gen, Move* move){
+    while (gen->cur == gen->len){
+        if (gen->stage == GenStage_Done)
+            return 0;
+
+        Move* end = generate_stage(gen->board, &gen->info, gen->stage, gen->moves);
+        gen->len = (int)(end - gen->moves);
+        gen->cur = 0;
+        gen->stage = gen->stage == gen->last_stage ? GenStage_Done : gen->stage + 1;
     }
 
-    moves = generate_king_moves(board, moves);
-    int n = (int)(moves - mh);
-    return n;
+    *move = gen->moves[gen->cur++];
+    return 1;
 }
 
 int
@@ -389,11 +593,11 @@ Board_GeneratePseudoMovesOf(const Board* board, Move* moves, Square sqr){
     Move* begin = moves;
     if (pt == NCH_King){
         moves = generate_castle_moves(board, moves);
-        moves = generate_king_moves(board, moves);
+        moves = generate_king_moves(board, NCH_UINT64_MAX, moves);
     }
     else{
         uint64 allowed_square = ~Board_OCC(board, side);
-        moves = generate_any_move(board, sqr, allowed_square, moves);
+        moves = generate_any_move(board, sqr, allowed_square, GenStage_All, moves);
     }
 
     int len = (int)(moves - begin);
@@ -14,10 +14,79 @@
 #include "board.h"
 #include "loops.h"
 
+// The stages of the staged move generation. The captures stage generates
+// captures, en passant and all the promotions (quiet promotions too) and
+// the quiets stage generates the rest of the moves including castles.
+// The two stages together generate the same moves as GenStage_All.
+typedef enum {
+    GenStage_All,
+    GenStage_Captures,
+    GenStage_Quiets,
+    GenStage_Done,
+}GenStage;
+
+// The part of the move generation that depends only on the position
+// (the check and the pins). It is computed once per node and shared
+// between the stages.
+typedef struct
+{
+    uint64 allowed_squares;
+    uint64 pinned_pieces;
+    uint64 pinned_allowed_squares[8];
+}GenInfo;
+
+// A lazy move generator that generates the moves stage by stage.
+// Captures and promotions first then the quiet moves. If the king is under
+// check all the evasions are generated at once in a single stage.
+typedef struct
+{
+    const Board* board;
+    GenInfo info;
+    GenStage stage;      // the next stage to generate
+    GenStage last_stage;
+    int len;
+    int cur;
+    Move moves[256];
+}MoveGen;
+
 // Generate all the legal moves for the current board.
 int
 Board_GenerateLegalMoves(const Board* board, Move* moves);
 
+// Generate the legal captures, en passant moves and promotions.
+int
+Board_GenerateCaptures(const Board* board, Move* moves);
+
+// Generate the legal moves that are not generated by Board_GenerateCaptures.
+int
+Board_GenerateQuiets(const Board* board, Move* moves);
+
+// Generate the legal moves if the king is under check. Returns 0 if
+// the king is not under check.
+int
+Board_GenerateEvasions(const Board* board, Move* moves);
+
+// Returns the number of legal moves without generating them.
+int
+Board_CountLegalMoves(const Board* board);
+
+// Same as Board_CountLegalMoves but also fills counts with the number of
+// legal moves of each piece type. counts must be of size NCH_PIECE_TYPE_NB
+// and it is indexed by PieceType. Castles are counted as king moves.
+int
+Board_CountLegalMovesByType(const Board* board, int* counts);
+
+// Initializes the staged generator. If captures_only is not zero the quiet
+// stage is skipped unless the king is under check where all the evasions
+// are generated. The board must not change while the generator is used.
+void
+MoveGen_Init(MoveGen* gen, const Board* board, int captures_only);
+
+// Writes the next move to move and returns 1. Returns 0 when there are
+// no moves left.
+int
+MoveGen_Next(MoveGen* gen, Move* move);
+
 // Generate all the pseudo moves for a piece on the board given its square.
 int
 Board_GeneratePseudoMovesOf(const Board* board, Move* moves, Square sqr);
@@ -1,12 +1,9 @@
 /*
     hash.h
 
-    This file contains the main struct that stores the board position in a hash
-    table for threefold repetition.
-
-    - The hash table is a basic fixed-size array with linked lists.
-    - The current naming convention uses BoardDict for the table and BoardNode for the
-      hash node, but this may change later.
+    This file contains the Zobrist keys used to hash a board position.
+    The keys are used for the repetitions and by the transposition table
+    (see tt.h).
 */
 
 #ifndef NCHESS_SRC_HASH_H
@@ -14,53 +11,45 @@
 
 #include "types.h"
 #include "core.h"
+#include "config.h"
 
-#define NCH_BOARD_DICT_SIZE 100
-
-typedef struct BoardNode
-{
-    int empty;
-    uint64 bitboards[NCH_PIECE_NB];
-    int count;
-
-    struct BoardNode* next;
-}BoardNode;
-
-typedef struct
-{
-    BoardNode nodes[NCH_BOARD_DICT_SIZE];
-}BoardDict;
-
-// Initializes the board dictionary.
-void
-BoardDict_Init(BoardDict* dict);
-
-// Frees all linked lists created outside the array.
-void
-BoardDict_FreeExtra(BoardDict* dict);
-
-// Returns the count of a given position.
-int
-BoardDict_GetCount(const BoardDict* dict, const uint64 bitboards[NCH_PIECE_NB]);
-
-// Adds a position to the dictionary. If the position already exists, increments
-// its counter by 1.
-int
-BoardDict_Add(BoardDict* dict, const uint64 bitboards[NCH_PIECE_NB]);
+/*
+    Zobrist keys.
 
-// Removes a position from the dictionary. If the position exists, decrements
-// its counter by 1.
-int
-BoardDict_Remove(BoardDict* dict, const uint64 bitboards[NCH_PIECE_NB]);
+    Each piece on each square, each castle rights combination, each en passant
+    file and the side to play has its own random key. The key of a position is
+    the XOR of all keys that describe it, so making a move only needs to XOR
+    the keys of what changed.
 
-// Deletes all linked lists outside the array and sets all nodes in the array to empty.
-// This function is equivalent to calling FreeExtra followed by Init.
+    The keys are generated with a fixed seed, so the same position has the same
+    key in every process.
+*/
+extern uint64 ZobristPieces[NCH_PIECE_NB][NCH_SQUARE_NB]; // NCH_NO_PIECE row is all zeros
+extern uint64 ZobristCastles[16];
+extern uint64 ZobristEnPassant[8];
+extern uint64 ZobristSide;
+
+NCH_STATIC_FINLINE uint64
+zobrist_piece(Piece p, Square sqr){
+    return ZobristPieces[p][sqr];
+}
+
+NCH_STATIC_FINLINE uint64
+zobrist_castles(uint8 castles){
+    return ZobristCastles[castles & 0xF];
+}
+
+// en passant is only hashed when an enemy pawn could actually take it.
+// enp_map containes the pawn that moved twice and the pawns attacking it,
+// so it has more than one bit only when the capture is possible.
+NCH_STATIC_FINLINE uint64
+zobrist_enpassant(Square enp_idx, uint64 enp_map){
+    return (enp_idx && more_than_one(enp_map)) ? ZobristEnPassant[NCH_GET_COLIDX(enp_idx)]
+                                                : 0ULL;
+}
+
+// Initializes the Zobrist keys. Called by NCH_Init.
 void
-BoardDict_Reset(BoardDict* dict);
-
-// Copies all linked lists outside the array to the destination dictionary.
-// This function is not responsible for copying the array of the dictionary itself.
-int
-BoardDict_CopyExtra(const BoardDict* src, BoardDict* dst);
+NCH_InitZobrist();
 
 #endif
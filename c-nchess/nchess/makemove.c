@@ -11,6 +11,8 @@
 #include "hash.h"
 #include "generate.h"
 #include "board_utils.h"
+#include "nnue.h"
+#include "psqt.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -21,6 +23,10 @@ set_piece(Board* board, Side side, Square sqr, Piece p){
     Board_BB(board, p) |= sqr_bb;
     Board_OCC(board, side) |= sqr_bb;
     Board_PIECE(board, sqr) = p;
+    Board_KEY(board) ^= zobrist_piece(p, sqr);
+    psqt_add_piece(board, side, sqr, p);
+    if (board->nnue)
+        NNUE_AddPiece(board->nnue, p, sqr);
 }
 
 NCH_STATIC_FINLINE void
@@ -30,6 +36,10 @@ remove_piece(Board* board, Side side, Square sqr){
     Board_BB(board, p) &= ~sqr_bb;
     Board_OCC(board, side) &= ~sqr_bb;
     Board_PIECE(board, sqr) = NCH_NO_PIECE;
+    Board_KEY(board) ^= zobrist_piece(p, sqr);
+    psqt_remove_piece(board, side, sqr, p);
+    if (board->nnue)
+        NNUE_RemovePiece(board->nnue, p, sqr);
 }
 
 NCH_STATIC_FINLINE void
@@ -40,6 +50,10 @@ move_piece(Board* board, Side side, Square from_, Square to_){
     Board_OCC(board, side) ^= move_bb;
     Board_PIECE(board, from_) = NCH_NO_PIECE;
     Board_PIECE(board, to_) = p;
+    Board_KEY(board) ^= zobrist_piece(p, from_) ^ zobrist_piece(p, to_);
+    psqt_move_piece(board, from_, to_, p);
+    if (board->nnue)
+        NNUE_MovePiece(board->nnue, p, from_, to_);
 }
 
 // makes a move on the board.
@@ -58,6 +72,10 @@ make_move(Board* board, Square from_, Square to_,
     if (captured_piece != NCH_NO_PIECE){
         Board_BB(board, captured_piece) &= ~NCH_SQR(to_);
         Board_OCC(board, op_side) &= ~NCH_SQR(to_);
+        Board_KEY(board) ^= zobrist_piece(captured_piece, to_);
+        psqt_remove_piece(board, op_side, to_, captured_piece);
+        if (board->nnue)
+            NNUE_RemovePiece(board->nnue, captured_piece, to_);
     }
     
     if (move_type != MoveType_Normal){
@@ -80,6 +98,13 @@ make_move(Board* board, Square from_, Square to_,
             Board_BB(board, pawn) &= ~NCH_SQR(to_);
             Board_BB(board, pro_piece) |= NCH_SQR(to_);
             Board_PIECE(board, to_) = pro_piece;
+            Board_KEY(board) ^= zobrist_piece(pawn, to_) ^ zobrist_piece(pro_piece, to_);
+            psqt_remove_piece(board, side, to_, pawn);
+            psqt_add_piece(board, side, to_, pro_piece);
+            if (board->nnue){
+                NNUE_RemovePiece(board->nnue, pawn, to_);
+                NNUE_AddPiece(board->nnue, pro_piece, to_);
+            }
         }
     }
     
@@ -152,6 +177,13 @@ undo_move(Board* board, Move move, Piece captured_piece){
             Board_BB(board, moveing_piece) &= ~NCH_SQR(from_);
             Board_BB(board, pawn) |= NCH_SQR(from_);
             Board_PIECE(board, from_) = pawn;
+            Board_KEY(board) ^= zobrist_piece(moveing_piece, from_) ^ zobrist_piece(pawn, from_);
+            psqt_remove_piece(board, side, from_, moveing_piece);
+            psqt_add_piece(board, side, from_, pawn);
+            if (board->nnue){
+                NNUE_RemovePiece(board->nnue, moveing_piece, from_);
+                NNUE_AddPiece(board->nnue, pawn, from_);
+            }
         }
     }
 
@@ -204,9 +236,27 @@ Board_IsMoveLegal(Board* board, Move move){
     return check_move_legality(board, &move, 0);
 }
 
-void
-_Board_MakeMove(Board* board, Move move){
-    MoveList_Append(&Board_MOVELIST(board), move, Board_INFO(board));
+// castle rights that are kept after a move from or to a square. a move that
+// touches a king or a rook square removes the rights of that piece.
+NCH_STATIC const uint8 castle_rights_mask[NCH_SQUARE_NB] = {
+    0xE, 0xF, 0xF, 0xC, 0xF, 0xF, 0xF, 0xD,
+    0xF, 0xF, 0xF, 0xF, 0xF, 0xF, 0xF, 0xF,
+    0xF, 0xF, 0xF, 0xF, 0xF, 0xF, 0xF, 0xF,
+    0xF, 0xF, 0xF, 0xF, 0xF, 0xF, 0xF, 0xF,
+    0xF, 0xF, 0xF, 0xF, 0xF, 0xF, 0xF, 0xF,
+    0xF, 0xF, 0xF, 0xF, 0xF, 0xF, 0xF, 0xF,
+    0xF, 0xF, 0xF, 0xF, 0xF, 0xF, 0xF, 0xF,
+    0xB, 0xF, 0xF, 0x3, 0xF, 0xF, 0xF, 0x7,
+};
+
+// plays a move and updates the position info.
+// it does not touch the move list or the number of moves.
+NCH_STATIC_FINLINE void
+play_move(Board* board, Move move){
+    // remove the en passant and castle keys of the current position. pieces
+    // keys are updated by make_move and the new keys are added at the end.
+    Board_KEY(board) ^= zobrist_enpassant(Board_ENP_IDX(board), Board_ENP_MAP(board))
+                      ^ zobrist_castles(Board_CASTLES(board));
 
     Board_FLAGS(board) = 0;
     Board_ENP_MAP(board) = 0;
@@ -214,19 +264,39 @@ _Board_MakeMove(Board* board, Move move){
     Board_ENP_TRG(board) = 0;
 
     Board_CAP_PIECE(board) = move_and_set_flags(board, move);
-    
-    BoardDict_Add(&Board_DICT(board), Board_BBS_PTR(board));
 
-    reset_castle_rights(board);
-    Board_NMOVES(board)++;
+    Board_CASTLES(board) &= castle_rights_mask[Move_FROM(move)]
+                          & castle_rights_mask[Move_TO(move)];
     Board_FIFTY_COUNTER(board) = NCH_CHKUNI(Board_FLAGS(board), Board_PAWNMOVED | Board_CAPTURE) 
                                 ? 0
                                 : Board_FIFTY_COUNTER(board) + 1;
 
     Board_SIDE(board) = NCH_OP_SIDE(Board_SIDE(board));
+    Board_KEY(board) ^= zobrist_enpassant(Board_ENP_IDX(board), Board_ENP_MAP(board))
+                      ^ zobrist_castles(Board_CASTLES(board))
+                      ^ ZobristSide;
     update_check(board);
 }
 
+void
+_Board_MakeMove(Board* board, Move move){
+    MoveList_Append(&Board_MOVELIST(board), move, Board_INFO(board));
+    play_move(board, move);
+    Board_NMOVES(board)++;
+}
+
+void
+Board_DoMove(Board* board, Move move, PositionInfo* undo){
+    *undo = Board_INFO(board);
+    play_move(board, move);
+}
+
+void
+Board_UndoMove(Board* board, Move move, const PositionInfo* undo){
+    undo_move(board, move, Board_CAP_PIECE(board));
+    Board_INFO(board) = *undo;
+}
+
 int
 Board_StepByMove(Board* board, Move move){
     if (!Board_CheckAndMakeMoveLegal(board, &move))
@@ -251,7 +321,6 @@ Board_Undo(Board* board){
     if (!node)
         return;
 
-    BoardDict_Remove(&Board_DICT(board), Board_BBS_PTR(board));
     undo_move(board, node->move, Board_CAP_PIECE(board));
 
     Board_INFO(board) = node->pos_info;
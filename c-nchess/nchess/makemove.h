@@ -20,6 +20,22 @@ void
 _Board_MakeMove(Board* board, Move move);
 
 
+// Makes a move without recording it in the move list. The position info
+// before the move is saved in undo and must be passed to Board_UndoMove.
+// Nothing is allocated and the number of moves is not changed, so it is meant
+// for perft and search where the game history is not needed. Positions played
+// this way are not seen by the repetition detection.
+// The move must be legal and have its MoveType set.
+void
+Board_DoMove(Board* board, Move move, PositionInfo* undo);
+
+
+// Undoes a move played by Board_DoMove using the undo info it saved.
+// Moves must be undone in the reverse order they were played.
+void
+Board_UndoMove(Board* board, Move move, const PositionInfo* undo);
+
+
 // Makes a move only if it is legal; otherwise, the move won't be played.
 // Returns 1 if the move has been played and 0 if not.
 int
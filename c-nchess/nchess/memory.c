@@ -9,6 +9,8 @@
 
 #ifndef NDEBUG
 
+#include "thread.h"
+
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -28,6 +30,9 @@ static size_t g_total_frees = 0;
 static size_t g_bytes_outstanding = 0;
 static int g_fail_on_leaks = 0;
 
+// the batch functions allocate from many threads
+static NCH_SpinLock g_lock = 0;
+
 static void tracker_add(void* ptr, size_t size, const char* file, int line, const char* func) {
     MemRecord* rec = (MemRecord*)malloc(sizeof(MemRecord));
     if (!rec) return; // best-effort
@@ -36,10 +41,13 @@ static void tracker_add(void* ptr, size_t size, const char* file, int line, cons
     rec->file = file;
     rec->func = func;
     rec->line = line;
+
+    nch_spin_lock(&g_lock);
     rec->next = g_head;
     g_head = rec;
     g_total_allocs++;
     g_bytes_outstanding += size;
+    nch_spin_unlock(&g_lock);
 }
 
 static MemRecord* tracker_find(void* ptr, MemRecord** prev_out) {
@@ -58,14 +66,17 @@ static MemRecord* tracker_find(void* ptr, MemRecord** prev_out) {
 
 static int tracker_remove(void* ptr) {
     MemRecord* prev = NULL;
+    nch_spin_lock(&g_lock);
     MemRecord* rec = tracker_find(ptr, &prev);
     if (!rec) {
+        nch_spin_unlock(&g_lock);
         fprintf(stderr, "[NCH DBG] free of unknown ptr=%p\n", ptr);
         return 0;
     }
     if (prev) prev->next = rec->next; else g_head = rec->next;
     g_total_frees++;
     if (g_bytes_outstanding >= rec->size) g_bytes_outstanding -= rec->size; else g_bytes_outstanding = 0;
+    nch_spin_unlock(&g_lock);
     free(rec);
     return 1;
 }
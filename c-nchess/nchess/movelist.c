@@ -8,38 +8,29 @@
 #include <stdlib.h>
 #include "types.h"
 #include <stdio.h>
+#include <string.h>
 #include "memory.h"
 
 void
 MoveList_Init(MoveList* movelist){
-    movelist->extra = NULL;
-    movelist->last_extra = NULL;
+    movelist->nodes = NULL;
     movelist->len = 0;
+    movelist->cap = 0;
 }
 
 int MoveList_Append(MoveList* movelist, Move move, PositionInfo pos_info){
-    MoveNode* node;
-    if (movelist->len < NCH_MOVELIST_SIZE){
-        node = movelist->nodes + movelist->len;
-    }
-    else{
-        node = (MoveNode*)NCH_MALLOC(sizeof(MoveNode));
-        if (!node) {
+    if (movelist->len == movelist->cap){
+        int cap = movelist->cap ? movelist->cap * 2 : NCH_MOVELIST_INIT_SIZE;
+        MoveNode* nodes = (MoveNode*)NCH_REALLOC(movelist->nodes, sizeof(MoveNode) * cap);
+        if (!nodes) {
             return -1;
         }
 
-        if (movelist->len == NCH_MOVELIST_SIZE) {
-            node->prev = NULL;
-            movelist->extra = node;
-            movelist->last_extra = node;
-        } else {
-            movelist->last_extra->next = node;
-            node->prev = movelist->last_extra;
-            movelist->last_extra = node;
-        }
+        movelist->nodes = nodes;
+        movelist->cap = cap;
     }
-    
-    node->next = NULL;
+
+    MoveNode* node = movelist->nodes + movelist->len;
     node->move = move;
     node->pos_info = pos_info;
     
@@ -47,111 +38,40 @@ int MoveList_Append(MoveList* movelist, Move move, PositionInfo pos_info){
     return 0;
 }
 
-void MoveList_Pop(MoveList* movelist) {
-    movelist->len--;
-    if (movelist->len < NCH_MOVELIST_SIZE){
-        return;
-    }
-
-    MoveNode* node = movelist->last_extra;
-
-    if (movelist->len == NCH_MOVELIST_SIZE) {
-        movelist->extra = NULL;
-        movelist->last_extra = NULL;
-    }
-    else{
-        movelist->last_extra = node->prev;
-        movelist->last_extra->next = NULL;
-    }
-
-    NCH_FREE(node);
-}
-
 MoveNode*
 MoveList_Get(MoveList* movelist, int idx){
-    if (idx >= movelist->len)
+    if (idx < 0 || idx >= movelist->len)
         return NULL;
-    
-    if (idx < NCH_MOVELIST_SIZE){
-        return movelist->nodes + idx;
-    }
 
-    int temp = NCH_MOVELIST_SIZE;
-    MoveNode* node = movelist->extra;
-    while (temp < idx){
-        if (node){
-            node = node->next;
-            temp++;
-        }
-        else{
-            return NULL;
-        }
-    }
-    
-    return node;    
+    return movelist->nodes + idx;
 }
 
 void
 MoveList_Free(MoveList* movelist){
-    if (movelist->extra){
-        MoveNode* node;
-        while (movelist->last_extra)
-        {
-            node = movelist->last_extra;
-            movelist->last_extra = node->prev;
-            NCH_FREE(node);
-        }
+    if (movelist->nodes){
+        NCH_FREE(movelist->nodes);
     }
+    MoveList_Init(movelist);
 }
 
 void
 MoveList_Reset(MoveList* movelist){
-    MoveList_Free(movelist);
     movelist->len = 0;
 }
 
 int
-MoveList_CopyExtra(const MoveList* src, MoveList* dst){
-    if (!src->extra)
+MoveList_Copy(const MoveList* src, MoveList* dst){
+    MoveList_Init(dst);
+    if (!src->len)
         return 0;
 
-    dst->extra = (MoveNode*)NCH_MALLOC(sizeof(MoveNode));
-    if (!dst->extra)
+    dst->nodes = (MoveNode*)NCH_MALLOC(sizeof(MoveNode) * src->len);
+    if (!dst->nodes)
         return -1;
 
-    *dst->extra = *src->extra;
-
-    MoveNode* sn = src->extra;
-    MoveNode* dn = dst->extra;
-
-    while (sn->next)
-    {
-        dn->next = (MoveNode*)NCH_MALLOC(sizeof(MoveNode));
-        if (!dn->next){
-            goto fail;
-        }
+    memcpy(dst->nodes, src->nodes, sizeof(MoveNode) * src->len);
+    dst->len = src->len;
+    dst->cap = src->len;
 
-        *dn->next = *sn->next;
-        dn->next->prev = dn;
-        
-        sn = sn->next;
-        dn = dn->next;
-    }
-    
-    dst->last_extra = dn;
-    
     return 0;
-
-    fail:
-        ; // Empty statement required for C99 compliance
-        MoveNode *temp;
-        dn = dst->extra;
-        while (dn)
-        {
-            temp = dn;
-            dn = dn->next;
-            NCH_FREE(temp);
-        }
-        
-        return -1;
-}
\ No newline at end of file
+}
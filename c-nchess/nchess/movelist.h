@@ -16,7 +16,9 @@
 #include "move.h"
 #include <stdlib.h>
 
-#define NCH_MOVELIST_SIZE 400
+// number of nodes allocated the first time a move is appended.
+// the list doubles its capacity every time it gets full.
+#define NCH_MOVELIST_INIT_SIZE 64
 
 /*
     Important:
@@ -29,31 +31,25 @@
 /*
     MoveNode
 
-    Represents a single move in a move list, along with its associated position 
-    information. Each MoveNode is part of a doubly linked list.
+    Represents a single move in a move list, along with the position
+    information before the move was played.
 */
 typedef struct MoveNode {
-    Move move;                // The move stored in this node.
     PositionInfo pos_info;    // Position information.
-
-    struct MoveNode* prev;    // Pointer to the previous MoveNode in the list.
-    struct MoveNode* next;    // Pointer to the next MoveNode in the list.
+    Move move;                // The move stored in this node.
 } MoveNode;
 
 /*
     MoveList
 
-    A data structure that holds a list of moves for a game. It maintains both 
-    a fixed-size array of MoveNodes and an optional linked list for additional 
-    moves when the array limit is exceeded.
+    The game history of a board. It is a growable array of MoveNodes that is
+    allocated on the first append, so a board that never plays a move through
+    the history (like the boards used by perft) never allocates.
 */
 typedef struct {
-    MoveNode nodes[NCH_MOVELIST_SIZE]; // An array of MoveNodes for fast access.
-    int len;                           // The current number of moves stored.
-
-    // Pointer to dynamically allocated extra MoveNodes if the array overflows.
-    MoveNode* extra;                   
-    MoveNode* last_extra;              // Pointer to the last allocated extra MoveNode.
+    MoveNode* nodes; // The nodes array. NULL until the first append.
+    int len;         // The current number of moves stored.
+    int cap;         // The number of nodes the array can hold.
 } MoveList;
 
 // Macros for accessing move properties from a MoveNode.
@@ -67,30 +63,34 @@ typedef struct {
 #define MoveNode_CASTLE_FLAGS(node) ((node)->pos_info.castle)
 #define MoveNode_GAME_FLAGS(node) ((node)->pos_info.gameflags)
 
-// Initializes a MoveList by resetting its length and clearing extra nodes.
+// Initializes an empty MoveList. It does not allocate.
 void MoveList_Init(MoveList* movelist);
 
-// Appends a new move to the MoveList.
-// Returns 0 on success, -1 if the MoveList is full.
+// Appends a new move to the MoveList. Grows the array if it is full.
+// Returns 0 on success, -1 if the memory allocation fails.
 int MoveList_Append(MoveList* movelist, Move move, PositionInfo pos_info);
 
 // Removes the last move from the MoveList.
 // Does not return the last node.
-void MoveList_Pop(MoveList* movelist);
+NCH_STATIC_INLINE void MoveList_Pop(MoveList* movelist) {
+    movelist->len--;
+}
 
 // Retrieves a MoveNode from the MoveList by index.
 // Returns a pointer to the MoveNode if found, NULL if the index is out of range.
 MoveNode* MoveList_Get(MoveList* movelist, int idx);
 
-// Frees any dynamically allocated memory used by the MoveList.
+// Frees the array of the MoveList and leaves it empty.
 void MoveList_Free(MoveList* movelist);
 
-// Resets the MoveList, clearing its contents.
+// Resets the MoveList, clearing its contents. The array is kept so it could
+// be reused without allocating again.
 void MoveList_Reset(MoveList* movelist);
 
-// Copies extra MoveNodes from one MoveList to another.
+// Copies the nodes of a MoveList to another one. dst must not own an array,
+// it is overwritten without being freed.
 // Returns 0 on success, -1 if copying fails.
-int MoveList_CopyExtra(const MoveList* src, MoveList* dst);
+int MoveList_Copy(const MoveList* src, MoveList* dst);
 
 // Returns a pointer to the last MoveNode if the list is not empty,
 // returns NULL otherwise.
@@ -98,10 +98,7 @@ NCH_STATIC_INLINE MoveNode* MoveList_Last(MoveList* movelist) {
     if (movelist->len <= 0)
         return NULL;
 
-    if (movelist->len <= NCH_MOVELIST_SIZE)
-        return movelist->nodes + movelist->len - 1;
-
-    return movelist->last_extra;
+    return movelist->nodes + movelist->len - 1;
 }
 
 #endif // NCHESS_SRC_MOVELIST_H
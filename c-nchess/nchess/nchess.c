@@ -9,4 +9,6 @@ NCH_Init(){
 #endif
     NCH_InitTables();
     NCH_InitBitboards();
+    NCH_InitZobrist();
+    NCH_InitPSQT();
 }
@@ -12,6 +12,14 @@
 #include "makemove.h"
 #include "move.h"
 #include "generate.h"
+#include "expand.h"
+#include "pack.h"
+#include "san.h"
+#include "pgn.h"
+#include "search.h"
+#include "tt.h"
+#include "nnue.h"
+#include "psqt.h"
 
 void
 NCH_Init();
@@ -0,0 +1,304 @@
+/*
+    nnue.c
+
+    The definitions of the NNUE functions. The updates and the output
+    layer work on 16 (AVX2) or 8 (SSE2) values at once, other targets
+    use the plain loops.
+*/
+
+#include "nnue.h"
+#include "bit_operations.h"
+#include "loops.h"
+#include "memory.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define NCH_NNUE_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define NCH_NNUE_SSE2 1
+#endif
+
+NCH_STATIC_FINLINE int
+feature_index(Side side, Piece p, Square sqr){
+    int theirs = Piece_SIDE(p) != side;
+    int rel_sqr = side == NCH_White ? sqr : sqr ^ 56;
+    return (theirs * 6 + Piece_TYPE(p) - 1) * NCH_SQUARE_NB + rel_sqr;
+}
+
+#if defined(NCH_NNUE_AVX2)
+
+#define VEC_SIZE 16
+
+NCH_STATIC_FINLINE void
+vec_add(int16* dst, const int16* w){
+    for (int i = 0; i < NCH_NNUE_HIDDEN; i += VEC_SIZE){
+        __m256i v = _mm256_loadu_si256((const __m256i*)(dst + i));
+        v = _mm256_add_epi16(v, _mm256_loadu_si256((const __m256i*)(w + i)));
+        _mm256_storeu_si256((__m256i*)(dst + i), v);
+    }
+}
+
+NCH_STATIC_FINLINE void
+vec_sub(int16* dst, const int16* w){
+    for (int i = 0; i < NCH_NNUE_HIDDEN; i += VEC_SIZE){
+        __m256i v = _mm256_loadu_si256((const __m256i*)(dst + i));
+        v = _mm256_sub_epi16(v, _mm256_loadu_si256((const __m256i*)(w + i)));
+        _mm256_storeu_si256((__m256i*)(dst + i), v);
+    }
+}
+
+NCH_STATIC_FINLINE void
+vec_sub_add(int16* dst, const int16* sub, const int16* add){
+    for (int i = 0; i < NCH_NNUE_HIDDEN; i += VEC_SIZE){
+        __m256i v = _mm256_loadu_si256((const __m256i*)(dst + i));
+        v = _mm256_sub_epi16(v, _mm256_loadu_si256((const __m256i*)(sub + i)));
+        v = _mm256_add_epi16(v, _mm256_loadu_si256((const __m256i*)(add + i)));
+        _mm256_storeu_si256((__m256i*)(dst + i), v);
+    }
+}
+
+// the sum of the clipped values times the weights
+NCH_STATIC_FINLINE int32
+vec_dot_clipped(const int16* values, const int16* w, int16 qa){
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i max = _mm256_set1_epi16(qa);
+    __m256i sum = _mm256_setzero_si256();
+
+    for (int i = 0; i < NCH_NNUE_HIDDEN; i += VEC_SIZE){
+        __m256i v = _mm256_loadu_si256((const __m256i*)(values + i));
+        v = _mm256_min_epi16(_mm256_max_epi16(v, zero), max);
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(v, _mm256_loadu_si256((const __m256i*)(w + i))));
+    }
+
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(s);
+}
+
+#elif defined(NCH_NNUE_SSE2)
+
+#define VEC_SIZE 8
+
+NCH_STATIC_FINLINE void
+vec_add(int16* dst, const int16* w){
+    for (int i = 0; i < NCH_NNUE_HIDDEN; i += VEC_SIZE){
+        __m128i v = _mm_loadu_si128((const __m128i*)(dst + i));
+        v = _mm_add_epi16(v, _mm_loadu_si128((const __m128i*)(w + i)));
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+    }
+}
+
+NCH_STATIC_FINLINE void
+vec_sub(int16* dst, const int16* w){
+    for (int i = 0; i < NCH_NNUE_HIDDEN; i += VEC_SIZE){
+        __m128i v = _mm_loadu_si128((const __m128i*)(dst + i));
+        v = _mm_sub_epi16(v, _mm_loadu_si128((const __m128i*)(w + i)));
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+    }
+}
+
+NCH_STATIC_FINLINE void
+vec_sub_add(int16* dst, const int16* sub, const int16* add){
+    for (int i = 0; i < NCH_NNUE_HIDDEN; i += VEC_SIZE){
+        __m128i v = _mm_loadu_si128((const __m128i*)(dst + i));
+        v = _mm_sub_epi16(v, _mm_loadu_si128((const __m128i*)(sub + i)));
+        v = _mm_add_epi16(v, _mm_loadu_si128((const __m128i*)(add + i)));
+        _mm_storeu_si128((__m128i*)(dst + i), v);
+    }
+}
+
+NCH_STATIC_FINLINE int32
+vec_dot_clipped(const int16* values, const int16* w, int16 qa){
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max = _mm_set1_epi16(qa);
+    __m128i sum = _mm_setzero_si128();
+
+    for (int i = 0; i < NCH_NNUE_HIDDEN; i += VEC_SIZE){
+        __m128i v = _mm_loadu_si128((const __m128i*)(values + i));
+        v = _mm_min_epi16(_mm_max_epi16(v, zero), max);
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(v, _mm_loadu_si128((const __m128i*)(w + i))));
+    }
+
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+#else
+
+// the values wrap around like the SIMD versions so an update is always
+// undone exactly by the opposite update.
+NCH_STATIC_FINLINE void
+vec_add(int16* dst, const int16* w){
+    for (int i = 0; i < NCH_NNUE_HIDDEN; i++){
+        dst[i] = (int16)(uint16)((uint16)dst[i] + (uint16)w[i]);
+    }
+}
+
+NCH_STATIC_FINLINE void
+vec_sub(int16* dst, const int16* w){
+    for (int i = 0; i < NCH_NNUE_HIDDEN; i++){
+        dst[i] = (int16)(uint16)((uint16)dst[i] - (uint16)w[i]);
+    }
+}
+
+NCH_STATIC_FINLINE void
+vec_sub_add(int16* dst, const int16* sub, const int16* add){
+    for (int i = 0; i < NCH_NNUE_HIDDEN; i++){
+        dst[i] = (int16)(uint16)((uint16)dst[i] - (uint16)sub[i] + (uint16)add[i]);
+    }
+}
+
+NCH_STATIC_FINLINE int32
+vec_dot_clipped(const int16* values, const int16* w, int16 qa){
+    int32 sum = 0;
+    for (int i = 0; i < NCH_NNUE_HIDDEN; i++){
+        int32 v = values[i] < 0 ? 0 : values[i] > qa ? qa : values[i];
+        sum += v * w[i];
+    }
+    return sum;
+}
+
+#endif
+
+void
+NNUE_AddPiece(NNUEAccumulator* acc, Piece p, Square sqr){
+    const NNUENetwork* net = acc->net;
+    vec_add(acc->values[NCH_White], net->ft_weights[feature_index(NCH_White, p, sqr)]);
+    vec_add(acc->values[NCH_Black], net->ft_weights[feature_index(NCH_Black, p, sqr)]);
+}
+
+void
+NNUE_RemovePiece(NNUEAccumulator* acc, Piece p, Square sqr){
+    const NNUENetwork* net = acc->net;
+    vec_sub(acc->values[NCH_White], net->ft_weights[feature_index(NCH_White, p, sqr)]);
+    vec_sub(acc->values[NCH_Black], net->ft_weights[feature_index(NCH_Black, p, sqr)]);
+}
+
+void
+NNUE_MovePiece(NNUEAccumulator* acc, Piece p, Square from_, Square to_){
+    const NNUENetwork* net = acc->net;
+    vec_sub_add(acc->values[NCH_White],
+                net->ft_weights[feature_index(NCH_White, p, from_)],
+                net->ft_weights[feature_index(NCH_White, p, to_)]);
+    vec_sub_add(acc->values[NCH_Black],
+                net->ft_weights[feature_index(NCH_Black, p, from_)],
+                net->ft_weights[feature_index(NCH_Black, p, to_)]);
+}
+
+void
+NNUE_Refresh(NNUEAccumulator* acc, const NNUENetwork* net, const Board* board){
+    acc->net = net;
+    memcpy(acc->values[NCH_White], net->ft_biases, sizeof(net->ft_biases));
+    memcpy(acc->values[NCH_Black], net->ft_biases, sizeof(net->ft_biases));
+
+    int idx;
+    uint64 occ = Board_ALL_OCC(board);
+    LOOP_U64_T(occ){
+        NNUE_AddPiece(acc, Board_PIECE(board, idx), idx);
+    }
+}
+
+void
+NNUE_Attach(Board* board, NNUEAccumulator* acc, const NNUENetwork* net){
+    NNUE_Refresh(acc, net, board);
+    board->nnue = acc;
+}
+
+int
+NNUE_Evaluate(const NNUEAccumulator* acc, Side side){
+    const NNUENetwork* net = acc->net;
+    int16 qa = (int16)net->qa;
+
+    long long sum = (long long)vec_dot_clipped(acc->values[side], net->out_weights, qa)
+                  + vec_dot_clipped(acc->values[NCH_OP_SIDE(side)], net->out_weights + NCH_NNUE_HIDDEN, qa)
+                  + net->out_bias;
+
+    return (int)(sum * net->scale / ((long long)net->qa * net->qb));
+}
+
+NCH_STATIC_INLINE uint32
+read_u32(const uint8* data){
+    return (uint32)data[0] | ((uint32)data[1] << 8) | ((uint32)data[2] << 16) | ((uint32)data[3] << 24);
+}
+
+NCH_STATIC_INLINE int16
+read_i16(const uint8* data){
+    return (int16)(uint16)((uint16)data[0] | ((uint16)data[1] << 8));
+}
+
+// reads n int16 and returns the position after them
+NCH_STATIC const uint8*
+read_i16_array(const uint8* data, int16* dst, int n){
+    for (int i = 0; i < n; i++){
+        dst[i] = read_i16(data + 2 * i);
+    }
+    return data + 2 * n;
+}
+
+int
+NNUE_LoadFromMemory(NNUENetwork* net, const void* data, size_t size){
+    const uint8* cursor = (const uint8*)data;
+    if (size != NCH_NNUE_FILE_SIZE || memcmp(cursor, NCH_NNUE_MAGIC, 8) != 0)
+        return -1;
+
+    uint32 hidden = read_u32(cursor + 8);
+    int32 qa = (int32)read_u32(cursor + 12);
+    int32 qb = (int32)read_u32(cursor + 16);
+    int32 scale = (int32)read_u32(cursor + 20);
+
+    // qa must be an int16 because the values are clipped with it
+    if (hidden != NCH_NNUE_HIDDEN || qa <= 0 || qa > 32767 || qb <= 0)
+        return -1;
+
+    net->qa = qa;
+    net->qb = qb;
+    net->scale = scale;
+
+    cursor += NCH_NNUE_HEADER_SIZE;
+    cursor = read_i16_array(cursor, &net->ft_weights[0][0], NCH_NNUE_FEATURES * NCH_NNUE_HIDDEN);
+    cursor = read_i16_array(cursor, net->ft_biases, NCH_NNUE_HIDDEN);
+    cursor = read_i16_array(cursor, net->out_weights, 2 * NCH_NNUE_HIDDEN);
+    net->out_bias = (int32)read_u32(cursor);
+
+    // every half is summed in an int32 by vec_dot_clipped. the clipped
+    // values are at most qa so the sum can not overflow below this bound.
+    for (int half = 0; half < 2; half++){
+        long long total = 0;
+        for (int i = 0; i < NCH_NNUE_HIDDEN; i++){
+            int16 w = net->out_weights[half * NCH_NNUE_HIDDEN + i];
+            total += w < 0 ? -w : w;
+        }
+        if (total * qa > INT32_MAX)
+            return -1;
+    }
+
+    return 0;
+}
+
+int
+NNUE_Load(NNUENetwork* net, const char* path){
+    FILE* file = fopen(path, "rb");
+    if (!file)
+        return -2;
+
+    // one byte more than a network is read to find the files that are too long
+    uint8* data = (uint8*)NCH_MALLOC(NCH_NNUE_FILE_SIZE + 1);
+    if (!data){
+        fclose(file);
+        return -2;
+    }
+
+    size_t size = fread(data, 1, NCH_NNUE_FILE_SIZE + 1, file);
+    int res = ferror(file) ? -2 : NNUE_LoadFromMemory(net, data, size);
+
+    fclose(file);
+    NCH_FREE(data);
+    return res;
+}
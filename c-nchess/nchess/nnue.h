@@ -0,0 +1,114 @@
+/*
+    nnue.h
+
+    This file contains an efficiently updatable neural network evaluation
+    (NNUE). The network is a single hidden layer seen from both sides:
+
+        768 inputs (12 pieces x 64 squares) -> 256 x 2 -> 1
+
+    The hidden layer of every side is kept in an accumulator. A board with
+    an accumulator attached updates it on every piece that is added,
+    removed or moved by the moves, and the moves undone update it back, so
+    the evaluation only computes the output layer.
+
+    The weights are int16. The hidden values are clipped to [0, qa] and
+    the output is (sum + bias) * scale / (qa * qb) in centipawns.
+*/
+
+#ifndef NCHESS_SRC_NNUE_H
+#define NCHESS_SRC_NNUE_H
+
+#include <stddef.h>
+
+#include "core.h"
+#include "board.h"
+#include "types.h"
+#include "config.h"
+
+#define NCH_NNUE_FEATURES 768
+#define NCH_NNUE_HIDDEN 256
+
+/*
+    The weight file. All the numbers are little endian.
+
+        char magic[8]         "NCHNNUE1"
+        uint32 hidden         must be NCH_NNUE_HIDDEN
+        int32 qa, qb, scale
+        int16 ft_weights[NCH_NNUE_FEATURES][hidden]
+        int16 ft_biases[hidden]
+        int16 out_weights[2 * hidden]  the side to play half first
+        int32 out_bias
+
+    The input of a piece seen from a side is
+        ((piece side != side) * 6 + piece type - 1) * 64 + square
+    where the square is flipped (square ^ 56) for black. The squares are
+    the NChess squares, h1 is 0 and a8 is 63.
+*/
+#define NCH_NNUE_MAGIC "NCHNNUE1"
+#define NCH_NNUE_HEADER_SIZE 24
+#define NCH_NNUE_FILE_SIZE (NCH_NNUE_HEADER_SIZE \
+                          + 2 * (NCH_NNUE_FEATURES * NCH_NNUE_HIDDEN + 3 * NCH_NNUE_HIDDEN) + 4)
+
+typedef struct
+{
+    int16 ft_weights[NCH_NNUE_FEATURES][NCH_NNUE_HIDDEN];
+    int16 ft_biases[NCH_NNUE_HIDDEN];
+    int16 out_weights[2 * NCH_NNUE_HIDDEN];
+    int32 out_bias;
+    int32 qa;
+    int32 qb;
+    int32 scale;
+}NNUENetwork;
+
+// the values come first so they have the alignment of the struct
+typedef struct NNUEAccumulator
+{
+    int16 values[NCH_SIDES_NB][NCH_NNUE_HIDDEN]; // the hidden layer seen from every side
+    const NNUENetwork* net;
+}NNUEAccumulator;
+
+// Reads a network from the bytes of a weight file. The networks where
+// qa times the sum of the absolute output weights of a half does not fit
+// an int32 are not valid.
+// returns 0 on success and -1 if the data is not a valid network.
+int
+NNUE_LoadFromMemory(NNUENetwork* net, const void* data, size_t size);
+
+// Reads a network from a weight file.
+// returns 0 on success, -1 if the file is not a valid network and -2 if
+// it could not be read.
+int
+NNUE_Load(NNUENetwork* net, const char* path);
+
+// Computes the accumulator of the board from all its pieces.
+void
+NNUE_Refresh(NNUEAccumulator* acc, const NNUENetwork* net, const Board* board);
+
+// Refreshes the accumulator and attaches it to the board. The moves played
+// and undone on the board keep it updated. It is not copied with the
+// board and the functions that set a whole position on the board like
+// Board_FromFen do not update it, NNUE_Refresh must be called after them.
+void
+NNUE_Attach(Board* board, NNUEAccumulator* acc, const NNUENetwork* net);
+
+NCH_STATIC_INLINE void
+NNUE_Detach(Board* board){
+    board->nnue = NULL;
+}
+
+// The updates of a piece. They are called by the moves of a board with an
+// accumulator attached.
+void
+NNUE_AddPiece(NNUEAccumulator* acc, Piece p, Square sqr);
+
+void
+NNUE_RemovePiece(NNUEAccumulator* acc, Piece p, Square sqr);
+
+void
+NNUE_MovePiece(NNUEAccumulator* acc, Piece p, Square from_, Square to_);
+
+// Evaluates the accumulator from the side perspective in centipawns.
+int
+NNUE_Evaluate(const NNUEAccumulator* acc, Side side);
+
+#endif // NCHESS_SRC_NNUE_H
@@ -0,0 +1,136 @@
+/*
+    pack.c
+
+    This file contains the definitions of the functions that pack and
+    unpack a board position.
+*/
+
+#include "pack.h"
+#include "bit_operations.h"
+#include "board_utils.h"
+#include "psqt.h"
+#include "utils.h"
+#include "loops.h"
+#include "movelist.h"
+#include "hash.h"
+
+#include <string.h>
+
+#define PACKED_STATE_MASK (0xF | (1 << PackedBoard_SIDE_SHIFT))
+
+NCH_STATIC_INLINE uint16
+saturate_u16(int value){
+    if (value < 0)
+        return 0;
+    return value > 0xFFFF ? 0xFFFF : (uint16)value;
+}
+
+int
+Board_Pack(const Board* board, PackedBoard* packed){
+    uint64 occ = Board_ALL_OCC(board);
+    if (count_bits(occ) > NCH_PACKED_MAX_PIECES)
+        return -1;
+
+    memset(packed, 0, sizeof(PackedBoard));
+    packed->occupancy = occ;
+
+    int idx;
+    int i = 0;
+    LOOP_U64_T(occ){
+        packed->pieces[i >> 1] |= (uint8)(Board_PIECE(board, idx) << ((i & 1) * 4));
+        i++;
+    }
+
+    packed->nmoves = saturate_u16(Board_NMOVES(board));
+    packed->fifty_counter = saturate_u16(Board_FIFTY_COUNTER(board));
+    packed->state = (uint8)(Board_CASTLES(board) | (Board_SIDE(board) << PackedBoard_SIDE_SHIFT));
+    packed->en_passant = Board_ENP_IDX(board);
+
+    return 0;
+}
+
+// returns 1 if the en passant square could come from the last move.
+// the pawn that moved two steps belongs to the side that is not playing.
+NCH_STATIC_INLINE int
+is_valid_enpassant(const Board* board, Square enp_sqr){
+    Side op_side = Board_OP_SIDE(board);
+    int row = op_side == NCH_White ? 3 : 4;
+    return NCH_GET_ROWIDX(enp_sqr) == row
+        && NCH_CHKFLG(Board_BB_BYTYPE(board, op_side, NCH_Pawn), NCH_SQR(enp_sqr));
+}
+
+int
+Board_Unpack(const PackedBoard* packed, Board* board){
+    uint64 occ = packed->occupancy;
+    int npieces = count_bits(occ);
+    if (npieces > NCH_PACKED_MAX_PIECES
+        || (packed->state & ~PACKED_STATE_MASK)
+        || packed->reserved[0] || packed->reserved[1])
+    {
+        return -1;
+    }
+
+    // the unused codes must be 0 so every position has a single packed form.
+    // an odd number of pieces leaves the high half of the last used byte.
+    for (int i = (npieces + 1) >> 1; i < NCH_PACKED_MAX_PIECES / 2; i++){
+        if (packed->pieces[i])
+            return -1;
+    }
+    if ((npieces & 1) && (packed->pieces[npieces >> 1] >> 4))
+        return -1;
+
+    memset(Board_BBS_PTR(board), 0, sizeof(Board_BBS_PTR(board)));
+    memset(board->piecetables, NCH_NO_PIECE, sizeof(board->piecetables));
+
+    // the key and the scores of the pieces are computed here instead of
+    // init_board_key and init_board_scores to go over the pieces once.
+    Board_MATERIAL(board, NCH_White) = 0;
+    Board_MATERIAL(board, NCH_Black) = 0;
+    Board_PHASE(board) = 0;
+    Board_PSQT(board) = 0;
+    uint64 key = 0ULL;
+    int idx;
+    int i = 0;
+    LOOP_U64_T(occ){
+        Piece p = (packed->pieces[i >> 1] >> ((i & 1) * 4)) & 0xF;
+        if (p < NCH_WPawn || p > NCH_BKing)
+            return -1;
+
+        Board_BB(board, p) |= NCH_SQR(idx);
+        Board_PIECE(board, idx) = p;
+        key ^= zobrist_piece(p, idx);
+        psqt_add_piece(board, Piece_SIDE(p), idx, p);
+        i++;
+    }
+
+    set_board_occupancy(board);
+
+    Board_SIDE(board) = (packed->state >> PackedBoard_SIDE_SHIFT) & 1;
+    Board_CASTLES(board) = packed->state & 0xF;
+    Board_FLAGS(board) = 0;
+    Board_CAP_PIECE(board) = NCH_NO_PIECE;
+    Board_FIFTY_COUNTER(board) = packed->fifty_counter;
+    Board_NMOVES(board) = packed->nmoves;
+
+    reset_enpassant_variable(board);
+    if (packed->en_passant){
+        Square enp_sqr = packed->en_passant;
+        if (!is_valid_square(enp_sqr) || !is_valid_enpassant(board, enp_sqr))
+            return -1;
+
+        set_board_enp_settings(board, Board_OP_SIDE(board), enp_sqr);
+    }
+
+    reset_castle_rights(board);
+    update_check(board);
+
+    key ^= zobrist_castles(Board_CASTLES(board));
+    key ^= zobrist_enpassant(Board_ENP_IDX(board), Board_ENP_MAP(board));
+    if (Board_IS_BLACKTURN(board))
+        key ^= ZobristSide;
+    Board_KEY(board) = key;
+    MoveList_Init(&Board_MOVELIST(board));
+    board->nnue = NULL;
+
+    return 0;
+}
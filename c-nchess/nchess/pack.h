@@ -0,0 +1,63 @@
+/*
+    pack.h
+
+    This file contains a compact fixed size form of a board position. It is
+    meant for storing many positions (datasets, files) where a FEN is too big
+    and too slow to read. A packed board is 32 bytes against the 60 to 90
+    chars of a FEN and reading it back needs no parsing.
+
+    Layout:
+        occupancy       the squares that have a piece.
+        pieces          a 4 bit piece code (NCH_WPawn to NCH_BKing) for every set
+                        bit of the occupancy from the lowest square to the
+                        highest. The first piece is in the low 4 bits of
+                        pieces[0], the second in its high 4 bits and so on.
+                        a position could have at most 32 pieces.
+        nmoves          number of half moves. saturates at 65535.
+        fifty_counter   saturates at 65535.
+        state           castle rights in the low 4 bits (Board_CASTLE_*)
+                        and the side to play in bit 4.
+        en_passant      the square of the pawn that moved two steps like
+                        Board_ENP_IDX, 0 if there is none.
+        reserved        always 0.
+
+    The fields are stored in the byte order of the machine (little endian on
+    every supported platform). The history of the board is not packed.
+*/
+
+#ifndef NCHESS_SRC_PACK_H
+#define NCHESS_SRC_PACK_H
+
+#include "board.h"
+#include "types.h"
+#include "config.h"
+
+#define NCH_PACKED_BOARD_SIZE 32
+#define NCH_PACKED_MAX_PIECES 32
+
+#define PackedBoard_SIDE_SHIFT 4
+
+typedef struct
+{
+    uint64 occupancy;
+    uint8 pieces[NCH_PACKED_MAX_PIECES / 2];
+    uint16 nmoves;
+    uint16 fifty_counter;
+    uint8 state;
+    uint8 en_passant;
+    uint8 reserved[2];
+}PackedBoard;
+
+// Packs the position of the board.
+// returns 0 on success and -1 if the board has more than 32 pieces.
+int
+Board_Pack(const Board* board, PackedBoard* packed);
+
+// Sets the board to the packed position. The packed board is checked
+// so a corrupted one is refused instead of creating a broken board.
+// The board must not own a history, it is overwritten.
+// returns 0 on success and -1 if the packed board is not valid.
+int
+Board_Unpack(const PackedBoard* packed, Board* board);
+
+#endif // NCHESS_SRC_PACK_H
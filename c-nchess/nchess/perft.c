@@ -9,6 +9,9 @@
 #include "generate.h"
 #include "io.h"
 #include "move.h"
+#include "thread.h"
+#include "memory.h"
+#include "tt.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -50,25 +53,80 @@ format_count(long long count, char* output, int pretty) {
 long long
 preft_recursive(Board* board, int depth){
     if (depth < 1) return 1;
+    if (depth == 1) return Board_CountLegalMoves(board);
 
     Move moves[256];
     int nmoves = Board_GenerateLegalMoves(board, moves);
     
-    if (depth == 1) return nmoves;
-    
+    PositionInfo undo;
     long long count = 0;
     for (int i = 0; i < nmoves; i++){
-        _Board_MakeMove(board, moves[i]);
+        Board_DoMove(board, moves[i], &undo);
         count += preft_recursive(board, depth - 1);
-        Board_Undo(board);
+        Board_UndoMove(board, moves[i], &undo);
     }
 
     return count;
 }
 
+/*
+    The counts of the subtrees are stored in the transposition table (see tt.h)
+    by the key of the position and its depth. Counts that do not fit in the
+    payload of an entry are not stored.
+*/
+
+NCH_STATIC_INLINE int
+perft_table_probe(TransTable* table, uint64 key, int depth, long long* count){
+    TTData data;
+    if (TT_Probe(table, key, &data) && TTData_DEPTH(data) == depth){
+        *count = (long long)TTData_PAYLOAD(data);
+        return 1;
+    }
+    return 0;
+}
+
+NCH_STATIC_INLINE void
+perft_table_store(TransTable* table, uint64 key, int depth, long long count){
+    if ((uint64)count <= TT_PAYLOAD_MASK)
+        TT_Store(table, key, (uint64)count, depth, TT_BOUND_EXACT);
+}
+
+// Recursive perft calculation that stores the counts of the subtrees in a table.
+// depth 1 is not stored since it costs only a move generation.
+NCH_STATIC long long
+perft_hashed(Board* board, int depth, TransTable* table){
+    if (depth < 2) return preft_recursive(board, depth);
+
+    long long count;
+    if (perft_table_probe(table, Board_KEY(board), depth, &count))
+        return count;
+
+    Move moves[256];
+    int nmoves = Board_GenerateLegalMoves(board, moves);
+
+    PositionInfo undo;
+    count = 0;
+    for (int i = 0; i < nmoves; i++){
+        Board_DoMove(board, moves[i], &undo);
+        count += perft_hashed(board, depth - 1, table);
+        Board_UndoMove(board, moves[i], &undo);
+    }
+
+    perft_table_store(table, Board_KEY(board), depth, count);
+    return count;
+}
+
+// counts the subtree with the hash table if there is one.
+NCH_STATIC_INLINE long long
+perft_count(Board* board, int depth, TransTable* table){
+    return table ? perft_hashed(board, depth, table)
+                 : preft_recursive(board, depth);
+}
+
 // Core perft implementation
 NCH_STATIC_INLINE long long
-perft_core(Board* board, int depth, char* buffer, size_t buffer_size, int pretty, void(*logger)(const char*)) {
+perft_core(Board* board, int depth, char* buffer, size_t buffer_size, int pretty,
+           void(*logger)(const char*), TransTable* table) {
     if (depth < 1) {
         return 0;
     }
@@ -78,6 +136,7 @@ perft_core(Board* board, int depth, char* buffer, size_t buffer_size, int pretty
     Move moves[256];
     int nmoves = Board_GenerateLegalMoves(board, moves);
     
+    PositionInfo undo;
     long long total = 0;
     char move_str[6];
     char formatted_count[30];
@@ -88,9 +147,9 @@ perft_core(Board* board, int depth, char* buffer, size_t buffer_size, int pretty
 
     // Process each move
     for (int i = 0; i < nmoves; i++){
-        _Board_MakeMove(board, moves[i]);
-        long long count = preft_recursive(board, depth - 1);
-        Board_Undo(board);
+        Board_DoMove(board, moves[i], &undo);
+        long long count = perft_count(board, depth - 1, table);
+        Board_UndoMove(board, moves[i], &undo);
         
         total += count;
 
@@ -141,27 +200,27 @@ void p(const char* s){
 
 long long
 Board_Perft(Board* board, int depth) {
-    return perft_core(board, depth, NULL, 0, 0, p);
+    return perft_core(board, depth, NULL, 0, 0, p, NULL);
 }
 
 long long
 Board_PerftPretty(Board* board, int depth) {
-    return perft_core(board, depth, NULL, 0, 1, p);
+    return perft_core(board, depth, NULL, 0, 1, p, NULL);
 }
 
 long long
 Board_PerftNoPrint(Board* board, int depth) {
-    return perft_core(board, depth, NULL, 0, 0, NULL);
+    return perft_core(board, depth, NULL, 0, 0, NULL, NULL);
 }
 
 long long
 Board_PerftAsString(Board* board, int depth, char* buffer, size_t buffer_size, int pretty) {
-    return perft_core(board, depth, buffer, buffer_size, pretty, NULL);
+    return perft_core(board, depth, buffer, buffer_size, pretty, NULL, NULL);
 }
 
 long long
 Board_PerftWithOptions(Board* board, int depth, int pretty, void(*logger)(const char*)) {
-    return perft_core(board, depth, NULL, 0, pretty, logger);
+    return perft_core(board, depth, NULL, 0, pretty, logger, NULL);
 }
 
 int
@@ -175,14 +234,349 @@ Board_PerftAndGetMoves(Board* board, int depth, Move* moves_out, long long* coun
     
     // Limit to array_size
     int result_count = nmoves < array_size ? nmoves : array_size;
+    PositionInfo undo;
     
     for (int i = 0; i < result_count; i++){
         moves_out[i] = moves[i];
         
-        _Board_MakeMove(board, moves[i]);
+        Board_DoMove(board, moves[i], &undo);
         counts_out[i] = preft_recursive(board, depth - 1);
-        Board_Undo(board);
+        Board_UndoMove(board, moves[i], &undo);
     }
 
     return result_count;
-}
\ No newline at end of file
+}
+
+long long
+Board_PerftWithHash(Board* board, int depth, int hash_size_mb, int pretty, void(*logger)(const char*)){
+    if (hash_size_mb <= 0)
+        return perft_core(board, depth, NULL, 0, pretty, logger, NULL);
+
+    TransTable table;
+    if (TT_Init(&table, hash_size_mb) < 0)
+        return -1;
+
+    long long total = perft_core(board, depth, NULL, 0, pretty, logger, &table);
+    TT_Free(&table);
+    return total;
+}
+
+long long
+Board_PerftDivide(Board* board, int depth, int hash_size_mb,
+                  void(*callback)(Move, long long, void*), void* ctx)
+{
+    if (depth < 1)
+        return 0;
+
+    TransTable table;
+    TransTable* table_ptr = NULL;
+    if (hash_size_mb > 0){
+        if (TT_Init(&table, hash_size_mb) < 0)
+            return -1;
+        table_ptr = &table;
+    }
+
+    Move moves[256];
+    int nmoves = Board_GenerateLegalMoves(board, moves);
+
+    PositionInfo undo;
+    long long count, total = 0;
+    for (int i = 0; i < nmoves; i++){
+        Board_DoMove(board, moves[i], &undo);
+        count = perft_count(board, depth - 1, table_ptr);
+        Board_UndoMove(board, moves[i], &undo);
+
+        total += count;
+        if (callback)
+            callback(moves[i], count, ctx);
+    }
+
+    if (table_ptr)
+        TT_Free(table_ptr);
+
+    return total;
+}
+
+NCH_STATIC void
+divide_to_file(Move move, long long count, void* ctx){
+    char move_str[6];
+    Move_AsString(move, move_str);
+    fprintf((FILE*)ctx, "%s %lld\n", move_str, count);
+    fflush((FILE*)ctx);
+}
+
+long long
+Board_PerftDivideToFile(Board* board, int depth, int hash_size_mb, FILE* out){
+    long long total = Board_PerftDivide(board, depth, hash_size_mb, divide_to_file, out);
+    if (total >= 0){
+        fprintf(out, "\ntotal %lld\n", total);
+        fflush(out);
+    }
+    return total;
+}
+
+/*
+    Parallel perft.
+
+    The work is split into tasks of one root move, or a root move and one of
+    its replies when the depth is at least 3 so there are enough tasks to keep
+    all threads busy. Each thread works on its own copy of the position and
+    takes the next task from a shared counter until no tasks are left.
+    The calling thread works as the first thread.
+*/
+
+typedef struct
+{
+    int root;      // index of the root move
+    Move moves[2]; // moves to play from the root position
+}PerftTask;
+
+typedef struct
+{
+    const Board* board;
+    int depth;      // depth left after playing the moves of a task
+    int task_moves; // number of moves in a task, 1 or 2
+    PerftTask* tasks;
+    long long ntasks;
+    volatile long long next_task;
+    volatile long long* counts; // count of each root move
+    TransTable* table;          // NULL if no hash table is used
+}PerftShared;
+
+typedef struct
+{
+    PerftShared* shared;
+    NCH_Thread thread;
+    PerftThreadStats stats;
+}PerftWorker;
+
+NCH_STATIC void
+perft_worker(void* arg){
+    PerftWorker* worker = (PerftWorker*)arg;
+    PerftShared* shared = worker->shared;
+    PerftThreadStats* stats = &worker->stats;
+
+    Board board;
+    Board_CopyPosition(shared->board, &board);
+
+    PositionInfo undo[2];
+    PerftTask* task;
+    long long count, idx;
+    double start_time = NCH_Time();
+
+    while (1){
+        idx = nch_atomic_fetch_add(&shared->next_task, 1);
+        if (idx >= shared->ntasks)
+            break;
+
+        task = shared->tasks + idx;
+        for (int i = 0; i < shared->task_moves; i++){
+            Board_DoMove(&board, task->moves[i], undo + i);
+        }
+
+        count = perft_count(&board, shared->depth, shared->table);
+
+        for (int i = shared->task_moves - 1; i >= 0; i--){
+            Board_UndoMove(&board, task->moves[i], undo + i);
+        }
+
+        nch_atomic_fetch_add(shared->counts + task->root, count);
+        stats->nodes += count;
+        stats->tasks++;
+    }
+
+    stats->seconds = NCH_Time() - start_time;
+}
+
+// Fills the tasks of the given root moves. Returns the number of tasks.
+NCH_STATIC long long
+perft_fill_tasks(const Board* board, Move* root_moves, int nroot, int task_moves, PerftTask* tasks){
+    long long ntasks = 0;
+    if (task_moves == 1){
+        for (int i = 0; i < nroot; i++){
+            tasks[ntasks].root = i;
+            tasks[ntasks].moves[0] = root_moves[i];
+            ntasks++;
+        }
+        return ntasks;
+    }
+
+    Board copy;
+    Board_CopyPosition(board, &copy);
+
+    Move replies[256];
+    PositionInfo undo;
+    int nreplies;
+    for (int i = 0; i < nroot; i++){
+        Board_DoMove(&copy, root_moves[i], &undo);
+        nreplies = Board_GenerateLegalMoves(&copy, replies);
+        for (int j = 0; j < nreplies; j++){
+            tasks[ntasks].root = i;
+            tasks[ntasks].moves[0] = root_moves[i];
+            tasks[ntasks].moves[1] = replies[j];
+            ntasks++;
+        }
+        Board_UndoMove(&copy, root_moves[i], &undo);
+    }
+    return ntasks;
+}
+
+int
+Board_PerftParallelAndGetMoves(const Board* board, int depth, int nthreads, int hash_size_mb,
+                               Move* moves_out, long long* counts_out, int array_size,
+                               PerftThreadStats* stats)
+{
+    if (depth < 1 || array_size <= 0)
+        return 0;
+
+    if (nthreads <= 0)
+        nthreads = NCH_CPUCount();
+
+    Move moves[256];
+    int nmoves = Board_GenerateLegalMoves(board, moves);
+    int result_count = nmoves < array_size ? nmoves : array_size;
+
+    int task_moves = depth >= 3 ? 2 : 1;
+    long long max_tasks = task_moves == 2 ? (long long)result_count * 256 : result_count;
+
+    PerftShared shared;
+    shared.board = board;
+    shared.depth = depth - task_moves;
+    shared.task_moves = task_moves;
+    shared.next_task = 0;
+    shared.table = NULL;
+
+    TransTable table;
+    PerftWorker* workers = NULL;
+    volatile long long* counts = NULL;
+    int out = -1;
+
+    shared.tasks = (PerftTask*)NCH_MALLOC(sizeof(PerftTask) * (max_tasks ? max_tasks : 1));
+    counts = (volatile long long*)NCH_CALLOC(result_count ? result_count : 1, sizeof(long long));
+    workers = (PerftWorker*)NCH_CALLOC(nthreads, sizeof(PerftWorker));
+    if (!shared.tasks || !counts || !workers)
+        goto end;
+
+    if (hash_size_mb > 0){
+        if (TT_Init(&table, hash_size_mb) < 0)
+            goto end;
+        shared.table = &table;
+    }
+
+    shared.ntasks = perft_fill_tasks(board, moves, result_count, task_moves, shared.tasks);
+    shared.counts = counts;
+
+    for (int i = 0; i < nthreads; i++){
+        workers[i].shared = &shared;
+    }
+
+    // if a thread could not be created its work is done by the others
+    int started = 1;
+    for (int i = 1; i < nthreads; i++){
+        if (NCH_ThreadCreate(&workers[i].thread, perft_worker, workers + i) < 0)
+            break;
+        started++;
+    }
+
+    perft_worker(workers);
+
+    for (int i = 1; i < started; i++){
+        NCH_ThreadJoin(&workers[i].thread);
+    }
+
+    for (int i = 0; i < result_count; i++){
+        moves_out[i] = moves[i];
+        counts_out[i] = counts[i];
+    }
+
+    if (stats){
+        for (int i = 0; i < nthreads; i++){
+            stats[i] = workers[i].stats;
+        }
+    }
+
+    out = result_count;
+
+    end:
+        if (shared.table)
+            TT_Free(shared.table);
+        if (shared.tasks)
+            NCH_FREE(shared.tasks);
+        if (counts)
+            NCH_FREE((void*)counts);
+        if (workers)
+            NCH_FREE(workers);
+        return out;
+}
+
+long long
+Board_PerftParallel(const Board* board, int depth, int nthreads, int hash_size_mb, PerftThreadStats* stats){
+    Move moves[256];
+    long long counts[256];
+    int nmoves = Board_PerftParallelAndGetMoves(board, depth, nthreads, hash_size_mb,
+                                                moves, counts, 256, stats);
+    if (nmoves < 0)
+        return -1;
+
+    long long total = 0;
+    for (int i = 0; i < nmoves; i++){
+        total += counts[i];
+    }
+    return total;
+}
+
+long long
+Board_PerftParallelWithOptions(const Board* board, int depth, int nthreads, int hash_size_mb,
+                               int pretty, void(*logger)(const char*))
+{
+    if (nthreads <= 0)
+        nthreads = NCH_CPUCount();
+
+    PerftThreadStats* stats = (PerftThreadStats*)NCH_CALLOC(nthreads, sizeof(PerftThreadStats));
+    if (!stats)
+        return -1;
+
+    Move moves[256];
+    long long counts[256];
+    double start_time = NCH_Time();
+    int nmoves = Board_PerftParallelAndGetMoves(board, depth, nthreads, hash_size_mb,
+                                                moves, counts, 256, stats);
+    double time_spent = NCH_Time() - start_time;
+    if (nmoves < 0){
+        NCH_FREE(stats);
+        return -1;
+    }
+
+    long long total = 0;
+    char move_str[6];
+    char formatted_count[30];
+    char line_buffer[100];
+
+    for (int i = 0; i < nmoves; i++){
+        total += counts[i];
+        if (logger){
+            Move_AsString(moves[i], move_str);
+            format_count(counts[i], formatted_count, pretty);
+            snprintf(line_buffer, sizeof(line_buffer), "%s: %s\n", move_str, formatted_count);
+            logger(line_buffer);
+        }
+    }
+
+    if (logger){
+        for (int i = 0; i < nthreads; i++){
+            format_count(stats[i].nodes, formatted_count, pretty);
+            double rate = stats[i].seconds > 0 ? (double)stats[i].nodes / stats[i].seconds : 0.0;
+            snprintf(line_buffer, sizeof(line_buffer), "Thread %d: %s nodes | %d tasks | %.0f nodes/s\n",
+                     i, formatted_count, stats[i].tasks, rate);
+            logger(line_buffer);
+        }
+
+        format_count(total, formatted_count, pretty);
+        snprintf(line_buffer, sizeof(line_buffer), "Total: %s | Time spent: %f seconds\n",
+                 formatted_count, time_spent);
+        logger(line_buffer);
+    }
+
+    NCH_FREE(stats);
+    return total;
+}
@@ -11,6 +11,8 @@
 
 #include "board.h"
 
+#include <stdio.h>
+
 
 // Computes the number of legal moves up to a given depth and prints the result.
 // Returns the total number of legal moves up to the given depth.
@@ -56,4 +58,71 @@ Board_PerftWithOptions(Board* board, int depth, int pretty, void(*logger)(const
 int
 Board_PerftAndGetMoves(Board* board, int depth, Move* moves, long long* counts, int array_size);
 
+
+// Same as Board_PerftWithOptions but stores the counts of the subtrees in a hash table
+// of hash_size_mb megabytes, so transpositions are counted only once. It is much faster
+// on deep perfts. If hash_size_mb is zero or less no table is used.
+// Returns the total number of legal moves up to the given depth or -1 if the
+// table could not be allocated.
+long long
+Board_PerftWithHash(Board* board, int depth, int hash_size_mb, int pretty, void(*logger)(const char*));
+
+
+// Computes perft and streams the count of each root move to the callback as soon as
+// it is known. callback receives the move, its count and ctx. could be NULL.
+// If hash_size_mb is more than zero a hash table of that size is used.
+// Returns the total number of legal moves up to the given depth or -1 if the
+// table could not be allocated.
+long long
+Board_PerftDivide(Board* board, int depth, int hash_size_mb,
+                  void(*callback)(Move, long long, void*), void* ctx);
+
+
+// Computes perft and writes a machine readable divide to the file. Each root move is
+// written as "<uci> <count>" on its own line as soon as it is counted, followed by an
+// empty line and "total <count>".
+// Returns the total number of legal moves up to the given depth or -1 if the
+// table could not be allocated.
+long long
+Board_PerftDivideToFile(Board* board, int depth, int hash_size_mb, FILE* out);
+
+
+// Statistics of a thread that worked on a parallel perft.
+typedef struct
+{
+    long long nodes; // number of leaf nodes counted by the thread
+    int tasks;       // number of tasks done by the thread
+    double seconds;  // time the thread spent working
+}PerftThreadStats;
+
+
+// Computes the number of legal moves up to a given depth using multiple threads.
+// The root moves (and their replies for depth >= 3) are split between the threads,
+// each thread works on its own copy of the position.
+// nthreads: number of threads. if it is zero or less the number of processors is used.
+// hash_size_mb: size of a hash table of subtree counts shared by the threads.
+//               if it is zero or less no table is used.
+// stats: array of nthreads entries filled with the stats of each thread. could be NULL.
+// Returns the total number of legal moves up to the given depth or -1 if
+// a memory allocation fails.
+long long
+Board_PerftParallel(const Board* board, int depth, int nthreads, int hash_size_mb, PerftThreadStats* stats);
+
+
+// Same as Board_PerftParallel but returns move/count pairs like Board_PerftAndGetMoves.
+// Returns the number of moves (and counts) stored in the arrays or -1 if
+// a memory allocation fails.
+int
+Board_PerftParallelAndGetMoves(const Board* board, int depth, int nthreads, int hash_size_mb,
+                               Move* moves, long long* counts, int array_size,
+                               PerftThreadStats* stats);
+
+
+// Same as Board_PerftParallel but logges the count of each move, the stats of each
+// thread and the total to the given logger like Board_PerftWithOptions.
+// If the logger is NULL, no logging will be done.
+long long
+Board_PerftParallelWithOptions(const Board* board, int depth, int nthreads, int hash_size_mb,
+                               int pretty, void(*logger)(const char*));
+
 #endif // NCHESS_SRC_PERFT_H
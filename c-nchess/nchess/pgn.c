@@ -0,0 +1,569 @@
+/*
+    pgn.c
+
+    This file contains the definitions of the PGN functions.
+*/
+
+#include "pgn.h"
+#include "san.h"
+#include "fen.h"
+#include "generate.h"
+#include "makemove.h"
+#include "movelist.h"
+#include "thread.h"
+#include "memory.h"
+
+#include <string.h>
+
+// buffers smaller than this are read by a single thread.
+#define PGN_MIN_CHUNK_SIZE (1 << 18)
+
+NCH_STATIC_INLINE int
+is_space(char c){
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+NCH_STATIC_INLINE int
+is_digit(char c){
+    return c >= '0' && c <= '9';
+}
+
+NCH_STATIC_INLINE int
+is_line_start(const char* first, const char* p){
+    return p == first || p[-1] == '\n';
+}
+
+// returns the start of the line after p or end if p is on the last line.
+NCH_STATIC_INLINE const char*
+next_line(const char* p, const char* end){
+    const char* nl = (const char*)memchr(p, '\n', end - p);
+    return nl ? nl + 1 : end;
+}
+
+NCH_STATIC_INLINE int
+is_result(const char* token, int len){
+    return (len == 1 && token[0] == '*')
+        || (len == 3 && (!memcmp(token, "1-0", 3) || !memcmp(token, "0-1", 3)))
+        || (len == 7 && !memcmp(token, "1/2-1/2", 7));
+}
+
+// skips the spaces, comments and the parentheses of the variations of
+// the movetext. depth is the number of variations p is in.
+// returns the start of the next token or end.
+NCH_STATIC const char*
+skip_to_token(const char* first, const char* p, const char* end, int* depth){
+    while (p < end){
+        char c = *p;
+        if (is_space(c)){
+            p++;
+        }
+        else if (c == '{'){
+            const char* close = (const char*)memchr(p, '}', end - p);
+            p = close ? close + 1 : end;
+        }
+        else if (c == ';' || (c == '%' && is_line_start(first, p))){
+            p = next_line(p, end);
+        }
+        else if (c == '('){
+            (*depth)++;
+            p++;
+        }
+        else if (c == ')'){
+            if (*depth > 0)
+                (*depth)--;
+            p++;
+        }
+        else{
+            return p;
+        }
+    }
+    return end;
+}
+
+NCH_STATIC_INLINE const char*
+token_end(const char* p, const char* end){
+    while (p < end && !is_space(*p) && *p != '{' && *p != '(' && *p != ')' && *p != ';'){
+        p++;
+    }
+    return p;
+}
+
+size_t
+PGN_NextGame(const char* buffer, size_t len, size_t pos, PGNGame* game){
+    const char* end = buffer + len;
+    const char* p = buffer + pos;
+
+    game->start = NULL;
+    game->movetext = NULL;
+    game->end = NULL;
+
+    // the empty lines and the escaped lines between games
+    while (p < end){
+        if (is_space(*p)){
+            p++;
+        }
+        else if (*p == '%' && is_line_start(buffer, p)){
+            p = next_line(p, end);
+        }
+        else{
+            break;
+        }
+    }
+    if (p >= end)
+        return len;
+
+    game->start = p;
+    while (p < end && *p == '['){
+        p = next_line(p, end);
+        while (p < end && is_space(*p)){
+            p++;
+        }
+    }
+    game->movetext = p;
+
+    int depth = 0;
+    const char* token;
+    while (p < end){
+        p = skip_to_token(buffer, p, end, &depth);
+        if (p >= end)
+            break;
+
+        // a game without a result ends where the tags of the next one start
+        if (*p == '[' && !depth && is_line_start(buffer, p))
+            break;
+
+        token = p;
+        p = token_end(p, end);
+        if (!depth && is_result(token, (int)(p - token)))
+            break;
+    }
+
+    game->end = p;
+    return (size_t)(p - buffer);
+}
+
+size_t
+PGN_GameBoundary(const char* buffer, size_t len, size_t pos){
+    const char* end = buffer + len;
+    const char* p = buffer + pos;
+    const char* q;
+
+    while (p < end){
+        p = (const char*)memchr(p, '[', end - p);
+        if (!p)
+            return len;
+
+        if (p == buffer)
+            return 0;
+
+        // the line before must be empty
+        if (p[-1] == '\n'){
+            q = p - 1;
+            if (q > buffer && q[-1] == '\r')
+                q--;
+            if (q == buffer || q[-1] == '\n')
+                return (size_t)(p - buffer);
+        }
+        p++;
+    }
+    return len;
+}
+
+int
+PGN_NextTag(const PGNGame* game, const char** cursor, PGNTag* tag){
+    const char* p = *cursor;
+    const char* end = game->movetext;
+    const char* line_end;
+
+    while (p < end){
+        while (p < end && is_space(*p)){
+            p++;
+        }
+        if (p >= end || *p != '[')
+            break;
+
+        line_end = next_line(p, end);
+        p++;
+        while (p < line_end && is_space(*p)){
+            p++;
+        }
+
+        tag->name = p;
+        while (p < line_end && !is_space(*p) && *p != '"' && *p != ']'){
+            p++;
+        }
+        tag->name_len = (int)(p - tag->name);
+
+        while (p < line_end && *p != '"'){
+            p++;
+        }
+
+        // a line that is not a tag is skipped
+        if (p < line_end && tag->name_len){
+            p++;
+            tag->value = p;
+            while (p < line_end && *p != '"'){
+                if (*p == '\\' && p + 1 < line_end)
+                    p++;
+                p++;
+            }
+            tag->value_len = (int)(p - tag->value);
+            *cursor = line_end;
+            return 1;
+        }
+
+        p = line_end;
+    }
+
+    *cursor = p;
+    return 0;
+}
+
+int
+PGN_FindTag(const PGNGame* game, const char* name, PGNTag* tag){
+    const char* cursor = game->start;
+    int name_len = (int)strlen(name);
+
+    while (PGN_NextTag(game, &cursor, tag)){
+        if (tag->name_len == name_len && !memcmp(tag->name, name, name_len))
+            return 1;
+    }
+    return 0;
+}
+
+// sets the board to the starting position of the game and keeps its
+// history buffer. returns 0 on success and -1 if the FEN tag is not valid.
+NCH_STATIC int
+set_start_position(const PGNGame* game, Board* board){
+    MoveList movelist = Board_MOVELIST(board);
+    MoveList_Reset(&movelist);
+
+    int res = 0;
+    PGNTag tag;
+    if (PGN_FindTag(game, "FEN", &tag)){
+        Board_InitEmpty(board);
+        if (tag.value_len >= NCH_FEN_MAX_LENGTH){
+            res = -1;
+        }
+        else{
+            char fen[NCH_FEN_MAX_LENGTH];
+            memcpy(fen, tag.value, tag.value_len);
+            fen[tag.value_len] = '\0';
+            res = Board_FromFen(fen, board);
+        }
+    }
+    else{
+        Board_Init(board);
+    }
+
+    Board_MOVELIST(board) = movelist;
+    return res;
+}
+
+int
+PGN_PlayGame(const PGNGame* game, Board* board, PGNMoveFunc func, void* arg){
+    if (set_start_position(game, board) < 0)
+        return -1;
+
+    Move moves[256], move;
+    int nmoves;
+    const char* p = game->movetext;
+    const char* end = game->end;
+    const char* token;
+    const char* q;
+    int depth = 0;
+
+    while (p < end){
+        p = skip_to_token(game->start, p, end, &depth);
+        if (p >= end)
+            break;
+
+        token = p;
+        p = token_end(p, end);
+        if (depth || *token == '$')
+            continue;
+
+        if (is_result(token, (int)(p - token)))
+            break;
+
+        // the move number could be glued to the move like "12.e4" or "12...e5".
+        // digits that are not followed by a dot are a castle like "0-0".
+        q = token;
+        while (q < p && is_digit(*q)){
+            q++;
+        }
+        if (q < p && *q == '.')
+            token = q;
+        while (token < p && *token == '.'){
+            token++;
+        }
+        if (token == p)
+            continue;
+
+        nmoves = Board_GenerateLegalMoves(board, moves);
+        if (Board_MoveFromSANInList(board, token, (int)(p - token), moves, nmoves, &move) < 0)
+            return -1;
+
+        if (func && func(board, move, arg))
+            return 1;
+
+        _Board_MakeMove(board, move);
+    }
+
+    return 0;
+}
+
+/*
+    PGN_ReadGames
+*/
+
+typedef struct
+{
+    const char* buffer;
+    size_t begin;
+    size_t end;
+    int with_positions;
+
+    long long ngames;
+    long long games_cap;
+    PGNGame* games;
+    int* status;
+    long long* game_moves; // the number of moves of every game
+
+    long long nmoves;
+    long long moves_cap;
+    Move* moves;
+
+    long long npositions;
+    long long positions_cap;
+    PackedBoard* positions;
+
+    int bad_position; // a position of the current game could not be packed
+    int failed;       // an allocation failed
+}PGNChunk;
+
+// makes sure the array has space for one more item.
+// returns 0 on success and -1 on failure.
+NCH_STATIC int
+grow_array(void** array, long long len, long long* cap, size_t item_size){
+    if (len < *cap)
+        return 0;
+
+    long long new_cap = *cap ? *cap * 2 : 64;
+    void* new_array = NCH_REALLOC(*array, (size_t)new_cap * item_size);
+    if (!new_array)
+        return -1;
+
+    *array = new_array;
+    *cap = new_cap;
+    return 0;
+}
+
+NCH_STATIC int
+chunk_add_position(PGNChunk* chunk, const Board* board){
+    if (grow_array((void**)&chunk->positions, chunk->npositions, &chunk->positions_cap, sizeof(PackedBoard)) < 0)
+        return -1;
+
+    PackedBoard* packed = chunk->positions + chunk->npositions++;
+    if (Board_Pack(board, packed) < 0){
+        memset(packed, 0, sizeof(PackedBoard));
+        chunk->bad_position = 1;
+    }
+    return 0;
+}
+
+NCH_STATIC int
+chunk_add_move(const Board* board, Move move, void* arg){
+    PGNChunk* chunk = (PGNChunk*)arg;
+
+    if (grow_array((void**)&chunk->moves, chunk->nmoves, &chunk->moves_cap, sizeof(Move)) < 0){
+        chunk->failed = 1;
+        return 1;
+    }
+    chunk->moves[chunk->nmoves++] = move;
+
+    if (chunk->with_positions && chunk_add_position(chunk, board) < 0){
+        chunk->failed = 1;
+        return 1;
+    }
+    return 0;
+}
+
+NCH_STATIC int
+chunk_add_game(PGNChunk* chunk, const PGNGame* game){
+    long long cap = chunk->games_cap;
+    if (grow_array((void**)&chunk->games, chunk->ngames, &cap, sizeof(PGNGame)) < 0)
+        return -1;
+
+    cap = chunk->games_cap;
+    if (grow_array((void**)&chunk->status, chunk->ngames, &cap, sizeof(int)) < 0)
+        return -1;
+
+    cap = chunk->games_cap;
+    if (grow_array((void**)&chunk->game_moves, chunk->ngames, &cap, sizeof(long long)) < 0)
+        return -1;
+
+    chunk->games_cap = cap;
+    chunk->games[chunk->ngames] = *game;
+    return 0;
+}
+
+NCH_STATIC void
+pgn_chunk_read(void* arg){
+    PGNChunk* chunk = (PGNChunk*)arg;
+    PGNGame game;
+    Board board;
+    Board_Init(&board);
+
+    size_t pos = chunk->begin;
+    while (pos < chunk->end){
+        pos = PGN_NextGame(chunk->buffer, chunk->end, pos, &game);
+        if (!game.start)
+            break;
+
+        if (chunk_add_game(chunk, &game) < 0){
+            chunk->failed = 1;
+            break;
+        }
+
+        long long first_move = chunk->nmoves;
+        chunk->bad_position = 0;
+
+        int res = PGN_PlayGame(&game, &board, chunk_add_move, chunk);
+        if (chunk->failed)
+            break;
+
+        if (chunk->with_positions && chunk_add_position(chunk, &board) < 0){
+            chunk->failed = 1;
+            break;
+        }
+
+        chunk->status[chunk->ngames] = (res < 0 || chunk->bad_position) ? -1 : 0;
+        chunk->game_moves[chunk->ngames] = chunk->nmoves - first_move;
+        chunk->ngames++;
+    }
+
+    Board_FreeExtraOnly(&board);
+}
+
+NCH_STATIC void
+pgn_chunk_free(PGNChunk* chunk){
+    NCH_FREE(chunk->games);
+    NCH_FREE(chunk->status);
+    NCH_FREE(chunk->game_moves);
+    NCH_FREE(chunk->moves);
+    NCH_FREE(chunk->positions);
+}
+
+// copies the games of the chunks one after another to out.
+// returns 0 on success and -1 on allocation failure.
+NCH_STATIC int
+pgn_merge_chunks(PGNChunk* chunks, int nchunks, int with_positions, PGNGames* out){
+    long long ngames = 0, nmoves = 0;
+    for (int i = 0; i < nchunks; i++){
+        ngames += chunks[i].ngames;
+        nmoves += chunks[i].nmoves;
+    }
+
+    // one item at least so an empty buffer is not an allocation failure
+    out->ngames = ngames;
+    out->games = (PGNGame*)NCH_MALLOC((ngames + 1) * sizeof(PGNGame));
+    out->status = (int*)NCH_MALLOC((ngames + 1) * sizeof(int));
+    out->offsets = (long long*)NCH_MALLOC((ngames + 1) * sizeof(long long));
+    out->moves = (Move*)NCH_MALLOC((nmoves + 1) * sizeof(Move));
+    out->positions = with_positions ? (PackedBoard*)NCH_MALLOC((nmoves + ngames + 1) * sizeof(PackedBoard))
+                                    : NULL;
+
+    if (!out->games || !out->status || !out->offsets || !out->moves
+        || (with_positions && !out->positions))
+    {
+        return -1;
+    }
+
+    long long game_idx = 0, move_idx = 0, position_idx = 0;
+    for (int i = 0; i < nchunks; i++){
+        PGNChunk* chunk = chunks + i;
+        if (chunk->ngames){
+            memcpy(out->games + game_idx, chunk->games, chunk->ngames * sizeof(PGNGame));
+            memcpy(out->status + game_idx, chunk->status, chunk->ngames * sizeof(int));
+        }
+        if (chunk->nmoves)
+            memcpy(out->moves + move_idx, chunk->moves, chunk->nmoves * sizeof(Move));
+        if (with_positions && chunk->npositions)
+            memcpy(out->positions + position_idx, chunk->positions, chunk->npositions * sizeof(PackedBoard));
+
+        for (long long g = 0; g < chunk->ngames; g++){
+            out->offsets[game_idx++] = move_idx;
+            move_idx += chunk->game_moves[g];
+        }
+        position_idx += chunk->npositions;
+    }
+    out->offsets[game_idx] = move_idx;
+
+    return 0;
+}
+
+int
+PGN_ReadGames(const char* buffer, size_t len, int with_positions, int nthreads, PGNGames* out){
+    memset(out, 0, sizeof(PGNGames));
+
+    if (nthreads <= 0)
+        nthreads = NCH_CPUCount();
+    if ((size_t)nthreads > len / PGN_MIN_CHUNK_SIZE)
+        nthreads = (int)(len / PGN_MIN_CHUNK_SIZE);
+    if (nthreads < 1)
+        nthreads = 1;
+
+    PGNChunk* chunks = (PGNChunk*)NCH_CALLOC(nthreads, sizeof(PGNChunk));
+    if (!chunks)
+        return -1;
+
+    size_t begin = 0, split;
+    int nchunks = 0;
+    for (int i = 0; i < nthreads && begin < len; i++){
+        split = i == nthreads - 1 ? len : PGN_GameBoundary(buffer, len, len / nthreads * (i + 1));
+        if (split < begin)
+            split = begin;
+
+        chunks[nchunks].buffer = buffer;
+        chunks[nchunks].begin = begin;
+        chunks[nchunks].end = split;
+        chunks[nchunks].with_positions = with_positions;
+        nchunks++;
+        begin = split;
+    }
+
+    NCH_RunChunks(chunks, nchunks, sizeof(PGNChunk), pgn_chunk_read);
+
+    int res = 0;
+    for (int i = 0; i < nchunks; i++){
+        if (chunks[i].failed)
+            res = -1;
+    }
+
+    if (res == 0)
+        res = pgn_merge_chunks(chunks, nchunks, with_positions, out);
+
+    for (int i = 0; i < nchunks; i++){
+        pgn_chunk_free(chunks + i);
+    }
+    NCH_FREE(chunks);
+
+    if (res < 0)
+        PGNGames_Free(out);
+
+    return res;
+}
+
+void
+PGNGames_Free(PGNGames* games){
+    if (!games)
+        return;
+
+    NCH_FREE(games->games);
+    NCH_FREE(games->status);
+    NCH_FREE(games->offsets);
+    NCH_FREE(games->moves);
+    NCH_FREE(games->positions);
+    memset(games, 0, sizeof(PGNGames));
+}
@@ -0,0 +1,111 @@
+/*
+    pgn.h
+
+    This file contains a reader of PGN files. It finds the games of a buffer
+    (it does not need a null terminator so it could be a memory mapped file),
+    reads their tags and replays their moves on a board.
+
+    Only the main line of a game is played. Comments ({...} and ;...),
+    variations ((...)), move numbers and NAGs ($1) are skipped. A game ends
+    with its result (1-0, 0-1, 1/2-1/2 or *) or where the tags of the next
+    game start.
+*/
+
+#ifndef NCHESS_SRC_PGN_H
+#define NCHESS_SRC_PGN_H
+
+#include <stddef.h>
+
+#include "board.h"
+#include "pack.h"
+#include "types.h"
+#include "config.h"
+
+typedef struct
+{
+    const char* start;    // the first char of the game. its first tag if it has tags
+    const char* movetext; // the first char after the tags
+    const char* end;      // one past the last char of the game
+}PGNGame;
+
+typedef struct
+{
+    const char* name;
+    int name_len;
+    const char* value;    // the value without the quotes. escapes (\" and \\) are kept
+    int value_len;
+}PGNTag;
+
+// called for every move of the main line with the board before the move.
+// returns 0 to continue and any other value to stop the game.
+typedef int (*PGNMoveFunc)(const Board* board, Move move, void* arg);
+
+// Finds the first game of the buffer that starts at or after pos.
+// returns the position right after the game. If there is no game left
+// game->start is NULL and len is returned.
+size_t
+PGN_NextGame(const char* buffer, size_t len, size_t pos, PGNGame* game);
+
+// Returns the position of the first game that starts at or after pos and
+// that follows an empty line, or len if there is none. Used to split a
+// buffer between threads without cutting a game.
+size_t
+PGN_GameBoundary(const char* buffer, size_t len, size_t pos);
+
+// Reads the next tag of the game. cursor must start at game->start and
+// it is moved after the tag.
+// returns 1 if a tag is read and 0 if there are no tags left.
+int
+PGN_NextTag(const PGNGame* game, const char** cursor, PGNTag* tag);
+
+// Finds a tag by its name. returns 1 if found and 0 otherwise.
+int
+PGN_FindTag(const PGNGame* game, const char* name, PGNTag* tag);
+
+// Sets the board to the starting position of the game (its FEN tag or the
+// standard position) and plays the moves of its main line.
+// The board must be initialized. Its history is cleared but its buffer is
+// kept so the same board could replay many games without allocating.
+// func could be NULL.
+// returns 0 if the game is played to its end, 1 if func stopped it and -1
+// if a move or the FEN tag could not be read. The moves before the bad one
+// are played.
+int
+PGN_PlayGame(const PGNGame* game, Board* board, PGNMoveFunc func, void* arg);
+
+/*
+    Reading many games at once. The buffer is split between threads at game
+    boundaries and every thread replays its games on its own board.
+*/
+
+typedef struct
+{
+    long long ngames;
+    PGNGame* games;
+
+    // 0 if the game is played to its end and -1 if it could not be read
+    int* status;
+
+    // ngames + 1 items. the moves of game i are moves[offsets[i]] to
+    // moves[offsets[i + 1] - 1].
+    long long* offsets;
+    Move* moves;
+
+    // NULL unless asked for. every game has one position more than its moves,
+    // the position before every move and the last one. the positions of
+    // game i start at positions[offsets[i] + i].
+    PackedBoard* positions;
+}PGNGames;
+
+// Reads and replays every game of the buffer. If with_positions is not 0
+// the position before every move is packed too. nthreads <= 0 means the
+// number of processors.
+// returns 0 on success and -1 on allocation failure.
+int
+PGN_ReadGames(const char* buffer, size_t len, int with_positions, int nthreads, PGNGames* out);
+
+// frees the arrays of the games read by PGN_ReadGames.
+void
+PGNGames_Free(PGNGames* games);
+
+#endif // NCHESS_SRC_PGN_H
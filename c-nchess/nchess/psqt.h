@@ -0,0 +1,92 @@
+/*
+    psqt.h
+
+    This file contains the material values and the piece-square tables.
+    Every board keeps the material of both sides, the piece-square score
+    and the game phase of its position. They are updated with the piece
+    table by the moves, so reading them costs nothing.
+
+    A piece-square score holds a midgame and an endgame score. The score
+    of a position is the two scores tapered by the game phase, which goes
+    from NCH_PSQT_PHASE_MAX with all the pieces on the board down to 0
+    with only the kings and the pawns.
+
+    The tables are the PeSTO tables with the material values taken out, so
+    the material difference plus the tapered score is the PeSTO evaluation.
+*/
+
+#ifndef NCHESS_SRC_PSQT_H
+#define NCHESS_SRC_PSQT_H
+
+#include "core.h"
+#include "board.h"
+#include "types.h"
+#include "config.h"
+
+// the phase of the starting position. promotions could go above it.
+#define NCH_PSQT_PHASE_MAX 24
+
+/*
+    A midgame and an endgame score packed in one integer, so adding two
+    scores adds both halves at once. The endgame score is in the high 16
+    bits and the midgame score in the low 16 bits.
+*/
+#define Score_NEW(mg, eg) ((Score)((uint32)(eg) << 16) + (Score)(mg))
+#define Score_MG(score) ((int)(int16)(uint16)(uint32)(score))
+#define Score_EG(score) ((int)(int16)(uint16)((uint32)((score) + 0x8000) >> 16))
+
+// the material value of every piece. kings are 0.
+extern const int PSQTMaterial[NCH_PIECE_NB];
+
+// the phase every piece adds to the position
+extern const int PSQTPhase[NCH_PIECE_NB];
+
+// the score of every piece on every square from white perspective. the
+// scores of the black pieces are negative. NCH_NO_PIECE row is all zeros.
+extern Score PSQTScores[NCH_PIECE_NB][NCH_SQUARE_NB];
+
+// Initializes the piece-square scores. Called by NCH_Init.
+void
+NCH_InitPSQT();
+
+// returns the piece-square score of the board tapered by its phase from
+// white perspective in centipawns. The material is not included.
+int
+Board_PSQTScore(const Board* board);
+
+NCH_STATIC_FINLINE void
+psqt_add_piece(Board* board, Side side, Square sqr, Piece p){
+    Board_MATERIAL(board, side) += PSQTMaterial[p];
+    Board_PHASE(board) += PSQTPhase[p];
+    Board_PSQT(board) += PSQTScores[p][sqr];
+}
+
+NCH_STATIC_FINLINE void
+psqt_remove_piece(Board* board, Side side, Square sqr, Piece p){
+    Board_MATERIAL(board, side) -= PSQTMaterial[p];
+    Board_PHASE(board) -= PSQTPhase[p];
+    Board_PSQT(board) -= PSQTScores[p][sqr];
+}
+
+NCH_STATIC_FINLINE void
+psqt_move_piece(Board* board, Square from_, Square to_, Piece p){
+    Board_PSQT(board) += PSQTScores[p][to_] - PSQTScores[p][from_];
+}
+
+// sets the material, the phase and the piece-square score of the board
+// from scratch. used when the board is initialized.
+NCH_STATIC_INLINE void
+init_board_scores(Board* board){
+    Board_MATERIAL(board, NCH_White) = 0;
+    Board_MATERIAL(board, NCH_Black) = 0;
+    Board_PHASE(board) = 0;
+    Board_PSQT(board) = 0;
+
+    for (Square sqr = 0; sqr < NCH_SQUARE_NB; sqr++){
+        Piece p = Board_PIECE(board, sqr);
+        if (p != NCH_NO_PIECE)
+            psqt_add_piece(board, Piece_SIDE(p), sqr, p);
+    }
+}
+
+#endif // NCHESS_SRC_PSQT_H
@@ -0,0 +1,361 @@
+/*
+    san.c
+
+    This file contains the definitions of the SAN functions.
+*/
+
+#include "san.h"
+#include "generate.h"
+#include "makemove.h"
+#include "utils.h"
+
+// a SAN move split into its parts. the squares, files and rows that are
+// not given are -1.
+typedef struct
+{
+    PieceType piece;
+    PieceType promotion; // NCH_NO_PIECE_TYPE if there is no promotion
+    int from_col;        // the column index of the disambiguation (h is 0)
+    int from_row;
+    Square to;
+    int castle;          // 0 if not castling, 1 for O-O and 2 for O-O-O
+}SANMove;
+
+NCH_STATIC const uint8 CHAR_PIECE_TYPE[128] = {
+    ['N'] = NCH_Knight, ['B'] = NCH_Bishop, ['R'] = NCH_Rook,
+    ['Q'] = NCH_Queen,  ['K'] = NCH_King,
+};
+
+NCH_STATIC_INLINE PieceType
+char_to_piece_type(char c){
+    return (PieceType)CHAR_PIECE_TYPE[(uint8)c & 0x7F];
+}
+
+NCH_STATIC_INLINE int
+is_file(char c){
+    return c >= 'a' && c <= 'h';
+}
+
+NCH_STATIC_INLINE int
+is_rank(char c){
+    return c >= '1' && c <= '8';
+}
+
+NCH_STATIC_INLINE int
+is_castle(const char* san, int len, char zero){
+    if (len != 3 && len != 5)
+        return 0;
+
+    for (int i = 0; i < len; i++){
+        if (san[i] != (i & 1 ? '-' : zero))
+            return 0;
+    }
+    return 1;
+}
+
+// splits the SAN into its parts. returns 0 on success and -1 if
+// it is not written correctly.
+NCH_STATIC int
+parse_san(const char* san, int len, SANMove* out){
+    // the suffixes tell nothing about the move
+    while (len > 0 && (san[len - 1] == '+' || san[len - 1] == '#'
+                    || san[len - 1] == '!' || san[len - 1] == '?'))
+    {
+        len--;
+    }
+
+    out->piece = NCH_Pawn;
+    out->promotion = NCH_NO_PIECE_TYPE;
+    out->from_col = -1;
+    out->from_row = -1;
+    out->to = NCH_NO_SQR;
+    out->castle = 0;
+
+    if (len < 2)
+        return -1;
+
+    if (is_castle(san, len, 'O') || is_castle(san, len, '0')){
+        out->piece = NCH_King;
+        out->castle = len == 3 ? 1 : 2;
+        return 0;
+    }
+
+    int i = 0;
+    PieceType type = char_to_piece_type(san[0]);
+    if (type != NCH_NO_PIECE_TYPE){
+        out->piece = type;
+        i++;
+    }
+
+    // the promotion comes after the target square like "e8=Q" or "e8Q"
+    if (out->piece == NCH_Pawn && len >= 3){
+        // lower case pieces are accepted too. 'b' is a file unless it follows '='
+        int has_equal = san[len - 2] == '=';
+        PieceType pro = char_to_piece_type(san[len - 1] & ~0x20);
+        if (pro != NCH_NO_PIECE_TYPE && pro != NCH_King && (has_equal || !is_file(san[len - 1]))){
+            out->promotion = pro;
+            len -= has_equal ? 2 : 1;
+        }
+        else if (has_equal){
+            return -1;
+        }
+    }
+
+    // the target square is always the last two chars
+    if (len - i < 2 || !is_file(san[len - 2]) || !is_rank(san[len - 1]))
+        return -1;
+
+    out->to = ('h' - san[len - 2]) + (san[len - 1] - '1') * 8;
+    len -= 2;
+
+    if (len > i && (san[len - 1] == 'x' || san[len - 1] == ':'))
+        len--;
+
+    // what is left is the disambiguation, a file, a rank or both
+    if (i < len && is_file(san[i])){
+        out->from_col = 'h' - san[i];
+        i++;
+    }
+    if (i < len && is_rank(san[i])){
+        out->from_row = san[i] - '1';
+        i++;
+    }
+
+    return i == len ? 0 : -1;
+}
+
+NCH_STATIC_INLINE int
+san_matches(const Board* board, const SANMove* san, Move move){
+    Square from = Move_FROM(move);
+
+    if (san->castle){
+        if (!Move_IsCastle(move))
+            return 0;
+
+        // the king goes to the g file on the king side and to the c file on the other
+        int col = NCH_GET_COLIDX(Move_TO(move));
+        return san->castle == 1 ? col == 1 : col == 5;
+    }
+
+    if (Move_TO(move) != san->to)
+        return 0;
+
+    if (Piece_TYPE(Board_ON_SQUARE(board, from)) != san->piece)
+        return 0;
+
+    // a pawn that is not capturing stays on its file and its SAN has no file
+    int from_col = san->from_col;
+    if (from_col < 0 && san->piece == NCH_Pawn)
+        from_col = NCH_GET_COLIDX(san->to);
+
+    if (from_col >= 0 && NCH_GET_COLIDX(from) != from_col)
+        return 0;
+
+    if (san->from_row >= 0 && NCH_GET_ROWIDX(from) != san->from_row)
+        return 0;
+
+    if (Move_IsPromotion(move))
+        return (int)san->promotion == Move_PRO_PIECE(move);
+
+    return san->promotion == NCH_NO_PIECE_TYPE;
+}
+
+int
+Board_MoveFromSANInList(const Board* board, const char* san, int len,
+                        const Move* moves, int nmoves, Move* dst_move)
+{
+    SANMove parsed;
+    if (parse_san(san, len, &parsed) < 0)
+        return -1;
+
+    int nfound = 0;
+    for (int i = 0; i < nmoves; i++){
+        if (san_matches(board, &parsed, moves[i])){
+            *dst_move = moves[i];
+            nfound++;
+        }
+    }
+
+    return nfound == 1 ? 0 : -1;
+}
+
+int
+Board_MoveFromSAN(const Board* board, const char* san, int len, Move* dst_move){
+    Move moves[256];
+    int nmoves = Board_GenerateLegalMoves(board, moves);
+    return Board_MoveFromSANInList(board, san, len, moves, nmoves, dst_move);
+}
+
+NCH_STATIC const char PIECE_TYPE_CHAR[NCH_PIECE_TYPE_NB] = {
+    '\0', '\0', 'N', 'B', 'R', 'Q', 'K'
+};
+
+NCH_STATIC_INLINE char
+file_char(Square sqr){
+    return (char)('h' - NCH_GET_COLIDX(sqr));
+}
+
+NCH_STATIC_INLINE char
+rank_char(Square sqr){
+    return (char)('1' + NCH_GET_ROWIDX(sqr));
+}
+
+// returns the index of the legal move with the same squares and promotion
+// as move or -1 if there is none. the type of move is not needed.
+NCH_STATIC_INLINE int
+find_legal_move(const Move* moves, int nmoves, Move move){
+    for (int i = 0; i < nmoves; i++){
+        if (Move_SAME_SQUARES(moves[i], move)
+            && (!Move_IsPromotion(moves[i]) || Move_PRO_PIECE(moves[i]) == Move_PRO_PIECE(move)))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// writes the SAN of a legal move without the check suffix and without the
+// null terminator. moves are the legal moves of the board, they are used to
+// find the other pieces that could go to the same square.
+// returns the number of chars written.
+NCH_STATIC int
+write_san(const Board* board, Move move, const Move* moves, int nmoves, char* dst){
+    Square from = Move_FROM(move);
+    Square to = Move_TO(move);
+    int n = 0;
+
+    if (Move_IsCastle(move)){
+        dst[n++] = 'O';
+        dst[n++] = '-';
+        dst[n++] = 'O';
+        if (NCH_GET_COLIDX(to) != 1){
+            dst[n++] = '-';
+            dst[n++] = 'O';
+        }
+        return n;
+    }
+
+    PieceType type = Piece_TYPE(Board_ON_SQUARE(board, from));
+    int capture = Move_IsEnPassant(move) || Board_ON_SQUARE(board, to) != NCH_NO_PIECE;
+
+    if (type == NCH_Pawn){
+        // a pawn capture is written with the file it comes from
+        if (capture)
+            dst[n++] = file_char(from);
+    }
+    else{
+        dst[n++] = PIECE_TYPE_CHAR[type];
+
+        // the file is enough unless another piece is on the same file,
+        // then the rank unless another piece is on the same rank too.
+        int ambiguous = 0, same_col = 0, same_row = 0;
+        for (int i = 0; i < nmoves; i++){
+            Square other = Move_FROM(moves[i]);
+            if (Move_TO(moves[i]) != to || other == from
+                || Piece_TYPE(Board_ON_SQUARE(board, other)) != type)
+            {
+                continue;
+            }
+
+            ambiguous = 1;
+            same_col |= NCH_GET_COLIDX(other) == NCH_GET_COLIDX(from);
+            same_row |= NCH_GET_ROWIDX(other) == NCH_GET_ROWIDX(from);
+        }
+
+        if (ambiguous){
+            if (!same_col || same_row)
+                dst[n++] = file_char(from);
+            if (same_col)
+                dst[n++] = rank_char(from);
+        }
+    }
+
+    if (capture)
+        dst[n++] = 'x';
+
+    dst[n++] = file_char(to);
+    dst[n++] = rank_char(to);
+
+    if (Move_IsPromotion(move)){
+        dst[n++] = '=';
+        dst[n++] = PIECE_TYPE_CHAR[Move_PRO_PIECE(move)];
+    }
+
+    return n;
+}
+
+// plays the move on the board to find if it gives check or mate and writes
+// the suffix. the board is back to its position when it returns.
+// returns the number of chars written.
+NCH_STATIC int
+write_check_suffix(Board* board, Move move, char* dst){
+    PositionInfo undo;
+    int n = 0;
+
+    Board_DoMove(board, move, &undo);
+    if (Board_IS_CHECK(board))
+        dst[n++] = Board_CountLegalMoves(board) ? '+' : '#';
+    Board_UndoMove(board, move, &undo);
+
+    return n;
+}
+
+int
+Move_AsSAN(const Board* board, Move move, char* dst){
+    return Board_MovesAsSAN(board, &move, 1, dst);
+}
+
+int
+Board_MovesAsSAN(const Board* board, const Move* moves, int nmoves, char* dst){
+    Move legal[256];
+    int nlegal = Board_GenerateLegalMoves(board, legal);
+
+    // the suffixes need the moves to be played, they are played on a copy
+    Board copy;
+    Board_CopyPosition(board, &copy);
+
+    int res = 0;
+    for (int i = 0; i < nmoves; i++){
+        char* san = dst + (size_t)i * NCH_SAN_MAX_LENGTH;
+        int idx = find_legal_move(legal, nlegal, moves[i]);
+        if (idx < 0){
+            san[0] = '\0';
+            res = -1;
+            continue;
+        }
+
+        int n = write_san(board, legal[idx], legal, nlegal, san);
+        n += write_check_suffix(&copy, legal[idx], san + n);
+        san[n] = '\0';
+    }
+
+    return res;
+}
+
+int
+Board_LineAsSAN(const Board* board, const Move* moves, int nmoves, char* dst){
+    Move legal[256];
+    PositionInfo undo;
+    Board copy;
+    Board_CopyPosition(board, &copy);
+
+    int nlegal = Board_GenerateLegalMoves(&copy, legal);
+    for (int i = 0; i < nmoves; i++){
+        char* san = dst + (size_t)i * NCH_SAN_MAX_LENGTH;
+        int idx = find_legal_move(legal, nlegal, moves[i]);
+        if (idx < 0)
+            return i;
+
+        Move move = legal[idx];
+        int n = write_san(&copy, move, legal, nlegal, san);
+
+        // the legal moves after the move tell if it is a mate
+        Board_DoMove(&copy, move, &undo);
+        nlegal = Board_GenerateLegalMoves(&copy, legal);
+        if (Board_IS_CHECK(&copy))
+            san[n++] = nlegal ? '+' : '#';
+        san[n] = '\0';
+    }
+
+    return nmoves;
+}
@@ -0,0 +1,68 @@
+/*
+    san.h
+
+    This file contains the functions that convert moves from and to the
+    Standard Algebraic Notation (SAN) used by PGN files like "Nbd7", "exd5",
+    "e8=Q+" and "O-O".
+
+    A SAN move only has a meaning on a board, the piece and the origin
+    square are found by matching it against the legal moves of the board.
+*/
+
+#ifndef NCHESS_SRC_SAN_H
+#define NCHESS_SRC_SAN_H
+
+#include "board.h"
+#include "move.h"
+#include "types.h"
+#include "config.h"
+
+// the size of a buffer that could hold any SAN move including the
+// null terminator. the longest is like "Qa1xb2+" or "exd8=Q#".
+#define NCH_SAN_MAX_LENGTH 8
+
+// Converts the SAN move of len chars (the string does not need a null
+// terminator) to the legal move of the board it describes.
+// The check and mate suffixes ('+', '#') and annotations ('!', '?') are
+// ignored. Castles could be written with 'O' or '0'. The promotion piece
+// could be written with or without '='.
+// returns 0 on success and -1 if the SAN does not describe exactly one
+// legal move.
+int
+Board_MoveFromSAN(const Board* board, const char* san, int len, Move* dst_move);
+
+// Same as Board_MoveFromSAN but it matches the SAN against the given
+// legal moves instead of generating them. It is used when the legal moves
+// of the board are already known.
+int
+Board_MoveFromSANInList(const Board* board, const char* san, int len,
+                        const Move* moves, int nmoves, Move* dst_move);
+
+// Writes the SAN of a legal move of the board to dst with a null terminator.
+// dst must have at least NCH_SAN_MAX_LENGTH chars. The move does not need
+// its MoveType. The SAN ends with '+' if the move gives check and with '#'
+// if it mates.
+// returns 0 on success and -1 if the move is not legal.
+int
+Move_AsSAN(const Board* board, Move move, char* dst);
+
+// Writes the SAN of many moves of the same board. The legal moves are
+// generated once and shared by all the moves, so it is much faster than
+// calling Move_AsSAN for every move. The SAN of move i starts at
+// dst[i * NCH_SAN_MAX_LENGTH].
+// returns 0 on success and -1 if any move is not legal. The SAN of a move
+// that is not legal is an empty string.
+int
+Board_MovesAsSAN(const Board* board, const Move* moves, int nmoves, char* dst);
+
+// Writes the SAN of moves that are played one after another starting from
+// the board, like the moves of a game. The board is not changed. The legal
+// moves of every position are generated once and they give both the
+// disambiguation of the next move and the mate suffix of the previous one.
+// The SAN of move i starts at dst[i * NCH_SAN_MAX_LENGTH].
+// returns the number of moves written. It stops at the first move that is
+// not legal.
+int
+Board_LineAsSAN(const Board* board, const Move* moves, int nmoves, char* dst);
+
+#endif // NCHESS_SRC_SAN_H
@@ -0,0 +1,827 @@
+/*
+    search.c
+
+    This file contains the definitions of the search functions.
+*/
+
+#include "search.h"
+#include "psqt.h"
+#include "generate.h"
+#include "makemove.h"
+#include "movelist.h"
+#include "hash.h"
+#include "thread.h"
+#include "memory.h"
+#include "bit_operations.h"
+
+#include <string.h>
+
+// the number of nodes between two checks of the time
+#define SEARCH_TIME_CHECK_INTERVAL 2048
+
+// the number of keys of the game history that are kept to find repetitions
+#define SEARCH_HISTORY_KEYS 512
+
+// the depth reduction of the null move
+#define SEARCH_NULL_REDUCTION 2
+
+// the history scores are halved when one of them gets above this
+#define SEARCH_HISTORY_MAX (1 << 20)
+
+// the order of the moves. the move of the last pv is searched first then
+// the captures, the killers and the rest by their history score.
+#define SCORE_PV (1 << 30)
+#define SCORE_CAPTURE (1 << 26)
+#define SCORE_KILLER_1 (SEARCH_HISTORY_MAX * 4 + 1)
+#define SCORE_KILLER_2 (SEARCH_HISTORY_MAX * 4)
+
+// the iterations skipped by the helper threads of a pool so they do not
+// all search the same depth. the helper i skips the depths d where
+// (d + SKIP_PHASE[i]) / SKIP_SIZE[i] is odd.
+#define SEARCH_SKIP_NB 20
+NCH_STATIC const int SKIP_SIZE[SEARCH_SKIP_NB]  = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+NCH_STATIC const int SKIP_PHASE[SEARCH_SKIP_NB] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+
+// what the threads of a pool share besides the table
+typedef struct
+{
+    volatile uint64 stop;     // set when the main thread is done
+    volatile long long nodes; // the nodes of all the threads. they are added every SEARCH_TIME_CHECK_INTERVAL nodes
+}SearchShared;
+
+typedef struct
+{
+    Board board;
+    NNUEAccumulator nnue; // attached to board if the searched board has one
+    TransTable* tt;      // NULL if there is no table
+    SearchShared* shared; // NULL if the search is not run by a pool
+    int id;              // the thread of the pool. 0 is the main thread
+    SearchEvalFunc eval;
+    void* eval_arg;
+
+    double deadline;     // 0 if there is no time limit
+    long long max_nodes; // 0 if there is no nodes limit
+    long long nodes;
+    long long reported_nodes; // the nodes already added to the shared nodes
+    int stop;
+    int can_stop;        // the limits are not checked in the first iteration
+
+    Move killers[NCH_SEARCH_MAX_PLY][2];
+    int history[NCH_SIDES_NB][NCH_SQUARE_NB][NCH_SQUARE_NB];
+
+    // the triangular pv table. the pv of ply i is pv[i][i] to pv[i][pv_len[i] - 1]
+    Move pv[NCH_SEARCH_MAX_PLY][NCH_SEARCH_MAX_PLY];
+    int pv_len[NCH_SEARCH_MAX_PLY];
+
+    // the pv of the last iteration. its moves are searched first.
+    Move prev_pv[NCH_SEARCH_MAX_PLY];
+    int prev_pv_len;
+
+    // the keys of the positions before the current one. the game history
+    // followed by the positions of the search.
+    uint64 keys[SEARCH_HISTORY_KEYS + NCH_SEARCH_MAX_PLY];
+    int nkeys;
+}Searcher;
+
+int
+Search_EvalMaterial(const Board* board, void* arg){
+    (void)arg;
+    int score = Board_MATERIAL(board, NCH_White) - Board_MATERIAL(board, NCH_Black);
+    return Board_IS_WHITETURN(board) ? score : -score;
+}
+
+int
+Search_EvalPSQT(const Board* board, void* arg){
+    (void)arg;
+    int score = Board_MATERIAL(board, NCH_White) - Board_MATERIAL(board, NCH_Black)
+              + Board_PSQTScore(board);
+    return Board_IS_WHITETURN(board) ? score : -score;
+}
+
+int
+Search_EvalNNUE(const Board* board, void* arg){
+    (void)arg;
+    int score = NNUE_Evaluate(board->nnue, Board_SIDE(board));
+    if (score >= NCH_SEARCH_MATE_BOUND)
+        return NCH_SEARCH_MATE_BOUND - 1;
+    if (score <= -NCH_SEARCH_MATE_BOUND)
+        return -NCH_SEARCH_MATE_BOUND + 1;
+    return score;
+}
+
+NCH_STATIC_INLINE int
+should_stop(Searcher* s){
+    if (s->stop)
+        return 1;
+
+    // the threads of a pool add their nodes to the shared nodes from time
+    // to time. the limits of a pool are only checked then.
+    long long nodes = s->nodes;
+    if (s->shared){
+        if ((s->nodes & (SEARCH_TIME_CHECK_INTERVAL - 1)) != 0)
+            return 0;
+
+        long long added = s->nodes - s->reported_nodes;
+        nodes = nch_atomic_fetch_add(&s->shared->nodes, added) + added;
+        s->reported_nodes = s->nodes;
+        if (nch_atomic_load(&s->shared->stop)){
+            s->stop = 1;
+            return 1;
+        }
+    }
+
+    if (!s->can_stop)
+        return 0;
+
+    if (s->max_nodes && nodes >= s->max_nodes){
+        s->stop = 1;
+    }
+    else if (s->deadline && (s->nodes & (SEARCH_TIME_CHECK_INTERVAL - 1)) == 0
+             && NCH_Time() >= s->deadline)
+    {
+        s->stop = 1;
+    }
+    return s->stop;
+}
+
+// returns 1 if the position was played before since the last capture or
+// pawn move. a single repetition is enough to call it a draw in the search.
+NCH_STATIC_INLINE int
+is_repetition(const Searcher* s){
+    uint64 key = Board_KEY(&s->board);
+    int end = s->nkeys - Board_FIFTY_COUNTER(&s->board);
+    if (end < 0)
+        end = 0;
+
+    for (int i = s->nkeys - 2; i >= end; i -= 2){
+        if (s->keys[i] == key)
+            return 1;
+    }
+    return 0;
+}
+
+// the mate scores are stored relative to the position instead of the root
+// so they stay correct when the position is reached at another ply.
+NCH_STATIC_INLINE int
+score_to_tt(int score, int ply){
+    if (score >= NCH_SEARCH_MATE_BOUND)
+        return score + ply;
+    if (score <= -NCH_SEARCH_MATE_BOUND)
+        return score - ply;
+    return score;
+}
+
+NCH_STATIC_INLINE int
+score_from_tt(int score, int ply){
+    if (score >= NCH_SEARCH_MATE_BOUND)
+        return score - ply;
+    if (score <= -NCH_SEARCH_MATE_BOUND)
+        return score + ply;
+    return score;
+}
+
+// the payload of a search entry is the best move in the low 16 bits and
+// the score in the next 16 bits.
+#define TT_MOVE(data) (Move)(TTData_PAYLOAD(data) & 0xFFFF)
+#define TT_SCORE(data) (int)(short)((TTData_PAYLOAD(data) >> 16) & 0xFFFF)
+
+NCH_STATIC_INLINE void
+tt_store(Searcher* s, int depth, int ply, int score, int bound, Move move){
+    uint64 payload = (uint64)move | ((uint64)(uint16)score_to_tt(score, ply) << 16);
+    TT_Store(s->tt, Board_KEY(&s->board), payload, depth, bound);
+}
+
+NCH_STATIC_INLINE int
+is_capture(const Board* board, Move move){
+    return Move_IsEnPassant(move) || Board_ON_SQUARE(board, Move_TO(move)) != NCH_NO_PIECE;
+}
+
+// the side to play has a piece other than pawns. the null move is not
+// tried without them because of the zugzwangs.
+NCH_STATIC_INLINE int
+has_pieces(const Board* board){
+    return (Board_PLY_BB(board, NCH_Knight) | Board_PLY_BB(board, NCH_Bishop)
+          | Board_PLY_BB(board, NCH_Rook)   | Board_PLY_BB(board, NCH_Queen)) != 0ULL;
+}
+
+// passes the turn to the other side. the side to play must not be under check.
+NCH_STATIC_INLINE void
+make_null_move(Board* board, PositionInfo* undo){
+    *undo = Board_INFO(board);
+    Board_KEY(board) ^= zobrist_enpassant(Board_ENP_IDX(board), Board_ENP_MAP(board))
+                      ^ ZobristSide;
+
+    Board_FLAGS(board) = 0;
+    Board_ENP_MAP(board) = 0;
+    Board_ENP_IDX(board) = 0;
+    Board_ENP_TRG(board) = 0;
+    Board_FIFTY_COUNTER(board)++;
+    Board_SIDE(board) = NCH_OP_SIDE(Board_SIDE(board));
+}
+
+NCH_STATIC_INLINE void
+undo_null_move(Board* board, const PositionInfo* undo){
+    Board_INFO(board) = *undo;
+}
+
+NCH_STATIC void
+score_moves(const Searcher* s, const Move* moves, int nmoves, int* scores, int ply, Move pv_move){
+    const Board* board = &s->board;
+    Side side = Board_SIDE(board);
+
+    for (int i = 0; i < nmoves; i++){
+        Move move = moves[i];
+        if (move == pv_move){
+            scores[i] = SCORE_PV;
+        }
+        else if (is_capture(board, move)){
+            // the most valuable victim first and the least valuable attacker first
+            PieceType victim = Move_IsEnPassant(move)
+                             ? NCH_Pawn
+                             : Piece_TYPE(Board_ON_SQUARE(board, Move_TO(move)));
+            PieceType attacker = Piece_TYPE(Board_ON_SQUARE(board, Move_FROM(move)));
+            scores[i] = SCORE_CAPTURE + victim * 16 - attacker;
+            if (Move_IsPromotion(move))
+                scores[i] += Move_PRO_PIECE(move) * 16;
+        }
+        else if (Move_IsPromotion(move) && Move_PRO_PIECE(move) == NCH_Queen){
+            scores[i] = SCORE_CAPTURE + NCH_Queen * 16;
+        }
+        else if (move == s->killers[ply][0]){
+            scores[i] = SCORE_KILLER_1;
+        }
+        else if (move == s->killers[ply][1]){
+            scores[i] = SCORE_KILLER_2;
+        }
+        else{
+            scores[i] = s->history[side][Move_FROM(move)][Move_TO(move)];
+        }
+    }
+}
+
+// moves the best move left to index i and returns it.
+NCH_STATIC_INLINE Move
+pick_move(Move* moves, int* scores, int nmoves, int i){
+    int best = i;
+    for (int j = i + 1; j < nmoves; j++){
+        if (scores[j] > scores[best])
+            best = j;
+    }
+
+    Move move = moves[best];
+    int score = scores[best];
+    moves[best] = moves[i];
+    scores[best] = scores[i];
+    moves[i] = move;
+    scores[i] = score;
+    return move;
+}
+
+NCH_STATIC void
+update_quiet_stats(Searcher* s, Move move, int depth, int ply){
+    if (s->killers[ply][0] != move){
+        s->killers[ply][1] = s->killers[ply][0];
+        s->killers[ply][0] = move;
+    }
+
+    int* entry = &s->history[Board_SIDE(&s->board)][Move_FROM(move)][Move_TO(move)];
+    *entry += depth * depth;
+    if (*entry > SEARCH_HISTORY_MAX){
+        int* history = &s->history[0][0][0];
+        for (int i = 0; i < NCH_SIDES_NB * NCH_SQUARE_NB * NCH_SQUARE_NB; i++){
+            history[i] /= 2;
+        }
+    }
+}
+
+NCH_STATIC_INLINE void
+update_pv(Searcher* s, Move move, int ply){
+    s->pv[ply][ply] = move;
+    for (int i = ply + 1; i < s->pv_len[ply + 1]; i++){
+        s->pv[ply][i] = s->pv[ply + 1][i];
+    }
+    s->pv_len[ply] = s->pv_len[ply + 1] > ply + 1 ? s->pv_len[ply + 1] : ply + 1;
+}
+
+// searches the captures (or all the evasions under check) until the
+// position is quiet.
+NCH_STATIC int
+quiescence(Searcher* s, int alpha, int beta, int ply){
+    Board* board = &s->board;
+    s->pv_len[ply] = ply;
+    s->nodes++;
+
+    if (should_stop(s))
+        return 0;
+
+    int in_check = Board_IS_CHECK(board);
+    if (ply >= NCH_SEARCH_MAX_PLY - 1)
+        return in_check ? 0 : s->eval(board, s->eval_arg);
+
+    Move moves[256];
+    int scores[256];
+    int nmoves;
+    int best;
+
+    if (in_check){
+        best = -NCH_SEARCH_MATE + ply;
+        nmoves = Board_GenerateEvasions(board, moves);
+    }
+    else{
+        best = s->eval(board, s->eval_arg);
+        if (best >= beta)
+            return best;
+        if (best > alpha)
+            alpha = best;
+        nmoves = Board_GenerateCaptures(board, moves);
+    }
+
+    score_moves(s, moves, nmoves, scores, ply, 0);
+
+    PositionInfo undo;
+    for (int i = 0; i < nmoves; i++){
+        Move move = pick_move(moves, scores, nmoves, i);
+
+        Board_DoMove(board, move, &undo);
+        int score = -quiescence(s, -beta, -alpha, ply + 1);
+        Board_UndoMove(board, move, &undo);
+
+        if (s->stop)
+            return 0;
+
+        if (score > best){
+            best = score;
+            if (score > alpha){
+                if (score >= beta)
+                    return score;
+                alpha = score;
+            }
+        }
+    }
+
+    return best;
+}
+
+NCH_STATIC int
+negamax(Searcher* s, int alpha, int beta, int depth, int ply, int on_pv, int allow_null){
+    Board* board = &s->board;
+    s->pv_len[ply] = ply;
+
+    // a check is searched one ply deeper so the search does not end under check
+    int in_check = Board_IS_CHECK(board);
+    if (in_check)
+        depth++;
+
+    if (depth <= 0)
+        return quiescence(s, alpha, beta, ply);
+
+    s->nodes++;
+    if (should_stop(s))
+        return 0;
+
+    if (ply){
+        if (Board_IsFiftyMoves(board) || is_repetition(s) || Board_IsInsufficientMaterial(board))
+            return 0;
+
+        if (ply >= NCH_SEARCH_MAX_PLY - 1)
+            return in_check ? 0 : s->eval(board, s->eval_arg);
+    }
+
+    int pv_node = beta - alpha > 1;
+    int alpha_start = alpha;
+    Move tt_move = 0;
+    PositionInfo undo;
+
+    if (s->tt){
+        TTData data;
+        if (TT_Probe(s->tt, Board_KEY(board), &data)){
+            tt_move = TT_MOVE(data);
+
+            // the pv nodes are always searched so the pv is not cut
+            if (!pv_node && TTData_DEPTH(data) >= depth){
+                int score = score_from_tt(TT_SCORE(data), ply);
+                int bound = TTData_BOUND(data);
+                if (bound == TT_BOUND_EXACT
+                    || (bound == TT_BOUND_LOWER && score >= beta)
+                    || (bound == TT_BOUND_UPPER && score <= alpha))
+                {
+                    return score;
+                }
+            }
+        }
+    }
+
+    // if passing the turn still fails high the position is good enough
+    // to cut without searching the moves
+    if (allow_null && !pv_node && !in_check && depth >= 3 && has_pieces(board)
+        && s->eval(board, s->eval_arg) >= beta)
+    {
+        s->keys[s->nkeys++] = Board_KEY(board);
+        make_null_move(board, &undo);
+        int score = -negamax(s, -beta, -beta + 1, depth - 1 - SEARCH_NULL_REDUCTION, ply + 1, 0, 0);
+        undo_null_move(board, &undo);
+        s->nkeys--;
+
+        if (s->stop)
+            return 0;
+
+        if (score >= beta)
+            return score >= NCH_SEARCH_MATE_BOUND ? beta : score;
+    }
+
+    Move moves[256];
+    int scores[256];
+    int nmoves = Board_GenerateLegalMoves(board, moves);
+    if (!nmoves)
+        return in_check ? -NCH_SEARCH_MATE + ply : 0;
+
+    Move pv_move = on_pv && ply < s->prev_pv_len ? s->prev_pv[ply] : tt_move;
+    score_moves(s, moves, nmoves, scores, ply, pv_move);
+
+    int best = -NCH_SEARCH_INF;
+    Move best_move = 0;
+    s->keys[s->nkeys++] = Board_KEY(board);
+
+    for (int i = 0; i < nmoves; i++){
+        Move move = pick_move(moves, scores, nmoves, i);
+        int quiet = !is_capture(board, move) && !Move_IsPromotion(move);
+        int score;
+
+        Board_DoMove(board, move, &undo);
+
+        if (i == 0){
+            score = -negamax(s, -beta, -alpha, depth - 1, ply + 1, on_pv && move == pv_move, 1);
+        }
+        else{
+            // the late quiet moves are searched shallower first and searched
+            // again at the full depth only if they look better than the best
+            int reduction = 0;
+            if (depth >= 3 && i >= 3 && quiet && !in_check && !Board_IS_CHECK(board)
+                && scores[i] < SCORE_KILLER_2)
+            {
+                reduction = i >= 8 ? 2 : 1;
+            }
+
+            score = -negamax(s, -alpha - 1, -alpha, depth - 1 - reduction, ply + 1, 0, 1);
+            if (reduction && score > alpha)
+                score = -negamax(s, -alpha - 1, -alpha, depth - 1, ply + 1, 0, 1);
+            if (score > alpha && score < beta)
+                score = -negamax(s, -beta, -alpha, depth - 1, ply + 1, 0, 1);
+        }
+
+        Board_UndoMove(board, move, &undo);
+
+        if (s->stop)
+            break;
+
+        if (score > best){
+            best = score;
+            best_move = move;
+            if (score > alpha){
+                alpha = score;
+                update_pv(s, move, ply);
+
+                if (score >= beta){
+                    if (quiet)
+                        update_quiet_stats(s, move, depth, ply);
+                    break;
+                }
+            }
+        }
+    }
+
+    s->nkeys--;
+    if (s->stop)
+        return 0;
+
+    if (s->tt){
+        int bound = best >= beta ? TT_BOUND_LOWER
+                  : best > alpha_start ? TT_BOUND_EXACT
+                  : TT_BOUND_UPPER;
+        tt_store(s, depth, ply, best, bound, best_move);
+    }
+
+    return best;
+}
+
+NCH_STATIC void
+search_init(Searcher* s, const Board* board, const SearchLimits* limits, TransTable* tt,
+            SearchEvalFunc eval, void* eval_arg, double start)
+{
+    memset(s, 0, sizeof(Searcher));
+    Board_CopyPosition(board, &s->board);
+    if (board->nnue){
+        s->nnue = *board->nnue;
+        s->board.nnue = &s->nnue;
+    }
+
+    s->tt = tt;
+    s->eval = eval ? eval : board->nnue ? Search_EvalNNUE : Search_EvalMaterial;
+    s->eval_arg = eval_arg;
+
+    if (limits){
+        s->deadline = limits->movetime > 0 ? start + limits->movetime : 0;
+        s->max_nodes = limits->nodes > 0 ? limits->nodes : 0;
+    }
+
+    // only the positions since the last capture or pawn move could repeat
+    const MoveList* movelist = &Board_MOVELIST(board);
+    int n = movelist->len;
+    if (n > Board_FIFTY_COUNTER(board))
+        n = Board_FIFTY_COUNTER(board);
+    if (n > SEARCH_HISTORY_KEYS)
+        n = SEARCH_HISTORY_KEYS;
+
+    for (int i = 0; i < n; i++){
+        s->keys[i] = movelist->nodes[movelist->len - n + i].pos_info.key;
+    }
+    s->nkeys = n;
+}
+
+NCH_STATIC_INLINE int
+search_max_depth(const SearchLimits* limits){
+    int max_depth = NCH_SEARCH_MAX_PLY - 1;
+    if (limits && limits->depth > 0 && limits->depth < max_depth)
+        max_depth = limits->depth;
+    return max_depth;
+}
+
+// runs the iterations of the searcher and writes the last completed one
+// to result. the helpers of a pool skip some of the depths.
+NCH_STATIC void
+iterate(Searcher* s, int max_depth, double start, SearchResult* result){
+    const int skip = (s->id - 1) % SEARCH_SKIP_NB;
+
+    for (int depth = 1; depth <= max_depth; depth++){
+        if (s->id && ((depth + SKIP_PHASE[skip]) / SKIP_SIZE[skip]) % 2)
+            continue;
+
+        int score = negamax(s, -NCH_SEARCH_INF, NCH_SEARCH_INF, depth, 0, 1, 0);
+        if (s->stop)
+            break;
+
+        result->best_move = s->pv[0][0];
+        result->score = score;
+        result->depth = depth;
+        result->pv_len = s->pv_len[0];
+        memcpy(result->pv, s->pv[0], s->pv_len[0] * sizeof(Move));
+
+        memcpy(s->prev_pv, s->pv[0], s->pv_len[0] * sizeof(Move));
+        s->prev_pv_len = s->pv_len[0];
+        s->can_stop = 1;
+
+        // a deeper iteration could not find a faster mate
+        if (score >= NCH_SEARCH_MATE_BOUND || score <= -NCH_SEARCH_MATE_BOUND){
+            if (NCH_SEARCH_MATE - (score > 0 ? score : -score) <= depth)
+                break;
+        }
+
+        // the next iteration takes longer than all the ones before it so it
+        // is not started if it could not finish in time
+        if (s->deadline && NCH_Time() - start >= (s->deadline - start) / 2)
+            break;
+    }
+
+    result->nodes = s->nodes;
+    result->seconds = NCH_Time() - start;
+}
+
+NCH_STATIC_INLINE void
+finish_result(SearchResult* result, const TransTable* tt, double start){
+    result->seconds = NCH_Time() - start;
+    result->nps = result->seconds > 0 ? (long long)(result->nodes / result->seconds) : 0;
+    result->hashfull = tt ? TT_Hashfull(tt) : 0;
+}
+
+int
+Board_Search(const Board* board, const SearchLimits* limits, TransTable* tt,
+             SearchEvalFunc eval, void* eval_arg, SearchResult* result)
+{
+    double start = NCH_Time();
+    memset(result, 0, sizeof(SearchResult));
+
+    if (!Board_CanMove(board)){
+        result->score = Board_IsCheck(board) ? -NCH_SEARCH_MATE : 0;
+        return 1;
+    }
+
+    Searcher* s = (Searcher*)NCH_MALLOC(sizeof(Searcher));
+    if (!s)
+        return -1;
+
+    search_init(s, board, limits, tt, eval, eval_arg, start);
+    if (tt)
+        TT_NewSearch(tt);
+
+    iterate(s, search_max_depth(limits), start, result);
+    finish_result(result, tt, start);
+
+    NCH_FREE(s);
+    return 0;
+}
+
+typedef struct
+{
+    NCH_Thread thread;
+    SearchPool* pool;
+    Searcher* searcher;
+    SearchResult result;
+}SearchWorker;
+
+struct SearchPool
+{
+    int nthreads;
+    int nstarted;          // the helper threads that are running
+    SearchWorker* workers; // the worker 0 is run by the thread that calls SearchPool_Search
+
+    NCH_Mutex mutex;
+    NCH_Cond start_cond;   // signaled when a search starts or the pool is freed
+    NCH_Cond done_cond;    // signaled when the last helper is done
+    unsigned int job;      // incremented by every search
+    int running;           // the helpers that did not finish the current search
+    int quit;
+
+    // the current search
+    SearchShared shared;
+    int max_depth;
+    double start;
+};
+
+NCH_STATIC void
+pool_worker(void* arg){
+    SearchWorker* worker = (SearchWorker*)arg;
+    SearchPool* pool = worker->pool;
+    unsigned int job = 0;
+
+    NCH_MutexLock(&pool->mutex);
+    for (;;){
+        while (pool->job == job && !pool->quit)
+            NCH_CondWait(&pool->start_cond, &pool->mutex);
+
+        if (pool->quit)
+            break;
+
+        job = pool->job;
+        NCH_MutexUnlock(&pool->mutex);
+
+        iterate(worker->searcher, pool->max_depth, pool->start, &worker->result);
+
+        NCH_MutexLock(&pool->mutex);
+        if (--pool->running == 0)
+            NCH_CondBroadcast(&pool->done_cond);
+    }
+    NCH_MutexUnlock(&pool->mutex);
+}
+
+SearchPool*
+SearchPool_New(int nthreads){
+    if (nthreads < 1)
+        nthreads = NCH_CPUCount();
+
+    SearchPool* pool = (SearchPool*)NCH_CALLOC(1, sizeof(SearchPool));
+    if (!pool)
+        return NULL;
+
+    if (NCH_MutexInit(&pool->mutex) < 0){
+        NCH_FREE(pool);
+        return NULL;
+    }
+    if (NCH_CondInit(&pool->start_cond) < 0){
+        NCH_MutexDestroy(&pool->mutex);
+        NCH_FREE(pool);
+        return NULL;
+    }
+    if (NCH_CondInit(&pool->done_cond) < 0){
+        NCH_CondDestroy(&pool->start_cond);
+        NCH_MutexDestroy(&pool->mutex);
+        NCH_FREE(pool);
+        return NULL;
+    }
+
+    // from here SearchPool_Free cleans up whatever is allocated
+    pool->workers = (SearchWorker*)NCH_CALLOC(nthreads, sizeof(SearchWorker));
+    if (!pool->workers){
+        SearchPool_Free(pool);
+        return NULL;
+    }
+    pool->nthreads = nthreads;
+
+    for (int i = 0; i < nthreads; i++){
+        pool->workers[i].pool = pool;
+        pool->workers[i].searcher = (Searcher*)NCH_MALLOC(sizeof(Searcher));
+        if (!pool->workers[i].searcher){
+            SearchPool_Free(pool);
+            return NULL;
+        }
+    }
+
+    for (int i = 1; i < nthreads; i++){
+        if (NCH_ThreadCreate(&pool->workers[i].thread, pool_worker, pool->workers + i) < 0){
+            SearchPool_Free(pool);
+            return NULL;
+        }
+        pool->nstarted++;
+    }
+
+    return pool;
+}
+
+void
+SearchPool_Free(SearchPool* pool){
+    if (!pool)
+        return;
+
+    NCH_MutexLock(&pool->mutex);
+    pool->quit = 1;
+    NCH_CondBroadcast(&pool->start_cond);
+    NCH_MutexUnlock(&pool->mutex);
+
+    for (int i = 1; i <= pool->nstarted; i++){
+        NCH_ThreadJoin(&pool->workers[i].thread);
+    }
+
+    if (pool->workers){
+        for (int i = 0; i < pool->nthreads; i++){
+            if (pool->workers[i].searcher)
+                NCH_FREE(pool->workers[i].searcher);
+        }
+        NCH_FREE(pool->workers);
+    }
+
+    NCH_CondDestroy(&pool->done_cond);
+    NCH_CondDestroy(&pool->start_cond);
+    NCH_MutexDestroy(&pool->mutex);
+    NCH_FREE(pool);
+}
+
+int
+SearchPool_Threads(const SearchPool* pool){
+    return pool->nthreads;
+}
+
+int
+SearchPool_Search(SearchPool* pool, const Board* board, const SearchLimits* limits,
+                  TransTable* tt, SearchEvalFunc eval, void* eval_arg,
+                  SearchResult* result, SearchThreadStats* stats)
+{
+    double start = NCH_Time();
+    memset(result, 0, sizeof(SearchResult));
+    if (stats)
+        memset(stats, 0, pool->nthreads * sizeof(SearchThreadStats));
+
+    if (!Board_CanMove(board)){
+        result->score = Board_IsCheck(board) ? -NCH_SEARCH_MATE : 0;
+        return 1;
+    }
+
+    // every thread searches its own copy of the board. only the main
+    // thread checks the limits, the helpers stop when it is done.
+    pool->shared.stop = 0;
+    pool->shared.nodes = 0;
+    for (int i = 0; i < pool->nthreads; i++){
+        SearchWorker* worker = pool->workers + i;
+        search_init(worker->searcher, board, i ? NULL : limits, tt, eval, eval_arg, start);
+        worker->searcher->id = i;
+        worker->searcher->shared = &pool->shared;
+        memset(&worker->result, 0, sizeof(SearchResult));
+    }
+
+    if (tt)
+        TT_NewSearch(tt);
+    pool->max_depth = search_max_depth(limits);
+    pool->start = start;
+
+    NCH_MutexLock(&pool->mutex);
+    pool->running = pool->nthreads - 1;
+    pool->job++;
+    NCH_CondBroadcast(&pool->start_cond);
+    NCH_MutexUnlock(&pool->mutex);
+
+    iterate(pool->workers[0].searcher, pool->max_depth, start, &pool->workers[0].result);
+    nch_atomic_store(&pool->shared.stop, 1);
+
+    NCH_MutexLock(&pool->mutex);
+    while (pool->running)
+        NCH_CondWait(&pool->done_cond, &pool->mutex);
+    NCH_MutexUnlock(&pool->mutex);
+
+    int best = 0;
+    long long nodes = 0;
+    for (int i = 0; i < pool->nthreads; i++){
+        const SearchResult* res = &pool->workers[i].result;
+        nodes += res->nodes;
+        if (res->depth > pool->workers[best].result.depth)
+            best = i;
+
+        if (stats){
+            stats[i].nodes = res->nodes;
+            stats[i].depth = res->depth;
+            stats[i].seconds = res->seconds;
+        }
+    }
+
+    *result = pool->workers[best].result;
+    result->nodes = nodes;
+    finish_result(result, tt, start);
+    return 0;
+}
@@ -0,0 +1,136 @@
+/*
+    search.h
+
+    This file contains an alpha-beta searcher built on the move generator.
+    It is an iterative deepening principal variation search (PVS) with a
+    transposition table (see tt.h), a quiescence search of the captures,
+    null move pruning, late move reductions and killer and history move
+    ordering.
+
+    The evaluation is a callback so any evaluation function could be
+    plugged in. The search stops at a depth, a time or a number of nodes.
+    A board with an NNUE accumulator attached is evaluated by its network
+    unless another evaluation is given.
+
+    SearchPool runs the same search on many threads (Lazy SMP). Every
+    thread searches its own copy of the board and they share only the
+    transposition table, the helper threads skip some iterations so they
+    fill the table ahead of the main thread.
+*/
+
+#ifndef NCHESS_SRC_SEARCH_H
+#define NCHESS_SRC_SEARCH_H
+
+#include "board.h"
+#include "move.h"
+#include "tt.h"
+#include "nnue.h"
+#include "types.h"
+#include "config.h"
+
+// the deepest ply the search could reach including the quiescence search
+#define NCH_SEARCH_MAX_PLY 128
+
+// the score of a mate at the root. a mate in n plies is scored
+// NCH_SEARCH_MATE - n so faster mates are preferred.
+#define NCH_SEARCH_MATE 32000
+
+// any score above this (or below its negative) is a mate
+#define NCH_SEARCH_MATE_BOUND (NCH_SEARCH_MATE - NCH_SEARCH_MAX_PLY)
+
+#define NCH_SEARCH_INF (NCH_SEARCH_MATE + 1)
+
+// Evaluates the board from the side to play perspective in centipawns.
+// The board is never in a finished state when it is called. The score must
+// be between -NCH_SEARCH_MATE_BOUND and NCH_SEARCH_MATE_BOUND.
+typedef int (*SearchEvalFunc)(const Board* board, void* arg);
+
+typedef struct
+{
+    int depth;        // the deepest iteration. 0 or less means no limit
+    double movetime;  // the time limit in seconds. 0 or less means no limit
+    long long nodes;  // the nodes limit. 0 or less means no limit
+}SearchLimits;
+
+typedef struct
+{
+    Move best_move;   // 0 if the board has no legal moves
+    int score;        // the score of the best move from the side to play perspective
+    int depth;        // the depth of the last completed iteration
+    long long nodes;  // the nodes searched by all the iterations
+    double seconds;
+    long long nps;    // the nodes per second
+    int hashfull;     // how full the table is after the search in permille
+    int pv_len;
+    Move pv[NCH_SEARCH_MAX_PLY]; // the principal variation starting with the best move
+}SearchResult;
+
+// The default evaluation. It counts the material of both sides.
+int
+Search_EvalMaterial(const Board* board, void* arg);
+
+// Evaluates the board with the material and the piece-square tables (see
+// psqt.h). Both are kept by the board so it costs as little as the material.
+int
+Search_EvalPSQT(const Board* board, void* arg);
+
+// Evaluates the board with its attached NNUE accumulator. It is the default
+// evaluation of the boards that have one.
+int
+Search_EvalNNUE(const Board* board, void* arg);
+
+// Searches the board and writes the best move to result. The board is not
+// changed. Its history is used to detect the repetitions.
+// The first iteration is always completed even if a limit is reached first.
+// tt could be NULL to search without a transposition table. The table could
+// be kept between searches, a new generation is started by every search.
+// eval could be NULL to use Search_EvalNNUE if the board has an accumulator
+// attached and Search_EvalMaterial otherwise. The search keeps its own copy
+// of the accumulator, the one of the board is not changed.
+// returns 0 on success, 1 if the board has no legal moves (the score is
+// the score of the mate or the stalemate) and -1 if the memory of the
+// search could not be allocated.
+int
+Board_Search(const Board* board, const SearchLimits* limits, TransTable* tt,
+             SearchEvalFunc eval, void* eval_arg, SearchResult* result);
+
+// the statistics of one thread of a SearchPool search
+typedef struct
+{
+    long long nodes;
+    int depth;        // the deepest iteration completed by the thread
+    double seconds;   // the time from the start of the search until the thread stopped
+}SearchThreadStats;
+
+// The threads of a SearchPool are started once and wait for the next
+// search, so a search does not pay for starting them.
+typedef struct SearchPool SearchPool;
+
+// Creates a pool of nthreads threads. The thread that calls
+// SearchPool_Search is one of them so only nthreads - 1 are started.
+// nthreads less than 1 means the number of logical processors.
+// returns NULL if the memory or the threads could not be allocated.
+SearchPool*
+SearchPool_New(int nthreads);
+
+// Stops the threads and frees the pool.
+void
+SearchPool_Free(SearchPool* pool);
+
+int
+SearchPool_Threads(const SearchPool* pool);
+
+// Searches the board with all the threads of the pool. It is Board_Search
+// where the limits are checked by the calling thread and the helpers stop
+// when it is done. The result is the one of the thread that completed the
+// deepest iteration and the nodes are the nodes of all the threads.
+// eval is called from all the threads at once.
+// stats could be NULL, otherwise it has SearchPool_Threads items.
+// A pool runs one search at a time.
+// returns the same as Board_Search.
+int
+SearchPool_Search(SearchPool* pool, const Board* board, const SearchLimits* limits,
+                  TransTable* tt, SearchEvalFunc eval, void* eval_arg,
+                  SearchResult* result, SearchThreadStats* stats);
+
+#endif // NCHESS_SRC_SEARCH_H
@@ -0,0 +1,207 @@
+/*
+    thread.c
+
+    This file contains the definitions of the thread functions for
+    pthreads and Win32.
+*/
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "thread.h"
+#include "memory.h"
+
+#if defined(_WIN32)
+
+#include <windows.h>
+#include <process.h>
+
+NCH_STATIC unsigned __stdcall
+thread_entry(void* arg){
+    NCH_Thread* thread = (NCH_Thread*)arg;
+    thread->func(thread->arg);
+    return 0;
+}
+
+int
+NCH_ThreadCreate(NCH_Thread* thread, NCH_ThreadFunc func, void* arg){
+    thread->func = func;
+    thread->arg = arg;
+    uintptr_t handle = _beginthreadex(NULL, 0, thread_entry, thread, 0, NULL);
+    if (!handle)
+        return -1;
+
+    thread->handle = (NCH_ThreadHandle)handle;
+    return 0;
+}
+
+void
+NCH_ThreadJoin(NCH_Thread* thread){
+    WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+    CloseHandle((HANDLE)thread->handle);
+}
+
+int
+NCH_MutexInit(NCH_Mutex* mutex){
+    InitializeSRWLock((PSRWLOCK)mutex);
+    return 0;
+}
+
+void
+NCH_MutexDestroy(NCH_Mutex* mutex){
+    (void)mutex; // an SRWLOCK has nothing to free
+}
+
+void
+NCH_MutexLock(NCH_Mutex* mutex){
+    AcquireSRWLockExclusive((PSRWLOCK)mutex);
+}
+
+void
+NCH_MutexUnlock(NCH_Mutex* mutex){
+    ReleaseSRWLockExclusive((PSRWLOCK)mutex);
+}
+
+int
+NCH_CondInit(NCH_Cond* cond){
+    InitializeConditionVariable((PCONDITION_VARIABLE)cond);
+    return 0;
+}
+
+void
+NCH_CondDestroy(NCH_Cond* cond){
+    (void)cond;
+}
+
+void
+NCH_CondWait(NCH_Cond* cond, NCH_Mutex* mutex){
+    SleepConditionVariableSRW((PCONDITION_VARIABLE)cond, (PSRWLOCK)mutex, INFINITE, 0);
+}
+
+void
+NCH_CondBroadcast(NCH_Cond* cond){
+    WakeAllConditionVariable((PCONDITION_VARIABLE)cond);
+}
+
+int
+NCH_CPUCount(){
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (int)info.dwNumberOfProcessors : 1;
+}
+
+double
+NCH_Time(){
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart / (double)freq.QuadPart;
+}
+
+#else
+
+#include <unistd.h>
+#include <time.h>
+
+NCH_STATIC void*
+thread_entry(void* arg){
+    NCH_Thread* thread = (NCH_Thread*)arg;
+    thread->func(thread->arg);
+    return NULL;
+}
+
+int
+NCH_ThreadCreate(NCH_Thread* thread, NCH_ThreadFunc func, void* arg){
+    thread->func = func;
+    thread->arg = arg;
+    if (pthread_create(&thread->handle, NULL, thread_entry, thread) != 0)
+        return -1;
+
+    return 0;
+}
+
+void
+NCH_ThreadJoin(NCH_Thread* thread){
+    pthread_join(thread->handle, NULL);
+}
+
+int
+NCH_MutexInit(NCH_Mutex* mutex){
+    return pthread_mutex_init(mutex, NULL) == 0 ? 0 : -1;
+}
+
+void
+NCH_MutexDestroy(NCH_Mutex* mutex){
+    pthread_mutex_destroy(mutex);
+}
+
+void
+NCH_MutexLock(NCH_Mutex* mutex){
+    pthread_mutex_lock(mutex);
+}
+
+void
+NCH_MutexUnlock(NCH_Mutex* mutex){
+    pthread_mutex_unlock(mutex);
+}
+
+int
+NCH_CondInit(NCH_Cond* cond){
+    return pthread_cond_init(cond, NULL) == 0 ? 0 : -1;
+}
+
+void
+NCH_CondDestroy(NCH_Cond* cond){
+    pthread_cond_destroy(cond);
+}
+
+void
+NCH_CondWait(NCH_Cond* cond, NCH_Mutex* mutex){
+    pthread_cond_wait(cond, mutex);
+}
+
+void
+NCH_CondBroadcast(NCH_Cond* cond){
+    pthread_cond_broadcast(cond);
+}
+
+int
+NCH_CPUCount(){
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
+
+double
+NCH_Time(){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+#endif
+
+void
+NCH_RunChunks(void* chunks, int nchunks, size_t chunk_size, NCH_ThreadFunc func){
+    char* first = (char*)chunks;
+    NCH_Thread* threads = nchunks > 1 ? (NCH_Thread*)NCH_MALLOC((nchunks - 1) * sizeof(NCH_Thread)) : NULL;
+
+    int started = 0;
+    while (threads && started < nchunks - 1){
+        if (NCH_ThreadCreate(threads + started, func, first + (started + 1) * chunk_size) < 0)
+            break;
+        started++;
+    }
+
+    func(first);
+
+    for (int i = 0; i < started; i++){
+        NCH_ThreadJoin(threads + i);
+    }
+    for (int i = started + 1; i < nchunks; i++){
+        func(first + i * chunk_size);
+    }
+
+    if (threads)
+        NCH_FREE(threads);
+}
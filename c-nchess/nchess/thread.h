@@ -0,0 +1,162 @@
+/*
+    thread.h
+
+    A small portable layer over the threads of the system (pthreads or Win32)
+    and the few atomic operations needed by the parallel functions like
+    Board_PerftParallel. The mutex and the condition variable are for the
+    threads that stay alive between jobs like the threads of SearchPool.
+*/
+
+#ifndef NCHESS_SRC_THREAD_H
+#define NCHESS_SRC_THREAD_H
+
+#include "types.h"
+#include "config.h"
+
+#if defined(_WIN32)
+    #include <intrin.h>
+    typedef void* NCH_ThreadHandle; // HANDLE
+    typedef void* NCH_Mutex;        // SRWLOCK
+    typedef void* NCH_Cond;         // CONDITION_VARIABLE
+#else
+    #include <pthread.h>
+    typedef pthread_t NCH_ThreadHandle;
+    typedef pthread_mutex_t NCH_Mutex;
+    typedef pthread_cond_t NCH_Cond;
+#endif
+
+// the function a thread runs. it receives the arg given to NCH_ThreadCreate.
+typedef void (*NCH_ThreadFunc)(void* arg);
+
+typedef struct
+{
+    NCH_ThreadHandle handle;
+    NCH_ThreadFunc func;
+    void* arg;
+}NCH_Thread;
+
+// Starts a new thread that runs func(arg). The thread struct must stay alive
+// until NCH_ThreadJoin is called.
+// Returns 0 on success and -1 on failure.
+int
+NCH_ThreadCreate(NCH_Thread* thread, NCH_ThreadFunc func, void* arg);
+
+// Waits for the thread to finish.
+void
+NCH_ThreadJoin(NCH_Thread* thread);
+
+// Runs func on every one of the nchunks chunks of chunk_size bytes that
+// start at chunks. The first chunk runs on the calling thread and every
+// other chunk on its own thread. The chunks that could not get a thread
+// run on the calling thread after the first one. Returns when all the
+// chunks are done.
+void
+NCH_RunChunks(void* chunks, int nchunks, size_t chunk_size, NCH_ThreadFunc func);
+
+// Initializes a mutex. Returns 0 on success and -1 on failure.
+int
+NCH_MutexInit(NCH_Mutex* mutex);
+
+void
+NCH_MutexDestroy(NCH_Mutex* mutex);
+
+void
+NCH_MutexLock(NCH_Mutex* mutex);
+
+void
+NCH_MutexUnlock(NCH_Mutex* mutex);
+
+// Initializes a condition variable. Returns 0 on success and -1 on failure.
+int
+NCH_CondInit(NCH_Cond* cond);
+
+void
+NCH_CondDestroy(NCH_Cond* cond);
+
+// Unlocks the mutex and waits until the condition is signaled, then locks
+// the mutex again. It could wake up without a signal so the condition must
+// be checked in a loop.
+void
+NCH_CondWait(NCH_Cond* cond, NCH_Mutex* mutex);
+
+// Wakes up all the threads waiting on the condition.
+void
+NCH_CondBroadcast(NCH_Cond* cond);
+
+// Returns the number of logical processors. Returns 1 if it is unknown.
+int
+NCH_CPUCount();
+
+// Returns a wall clock time in seconds. Only the difference between
+// two calls is meaningful.
+double
+NCH_Time();
+
+/*
+    Atomic operations. All of them are relaxed, they are only used for
+    counters and for values that are checked for consistency by the reader
+    like the entries of the perft hash table.
+
+    The spin lock is for the rare short sections that many threads could
+    enter at once like the records of the debug memory tracker.
+*/
+
+typedef volatile long NCH_SpinLock; // 0 when it is free
+
+#if defined(_MSC_VER)
+
+NCH_STATIC_FINLINE long long
+nch_atomic_fetch_add(volatile long long* ptr, long long value){
+    return _InterlockedExchangeAdd64(ptr, value);
+}
+
+NCH_STATIC_FINLINE uint64
+nch_atomic_load(volatile uint64* ptr){
+    return *ptr;
+}
+
+NCH_STATIC_FINLINE void
+nch_atomic_store(volatile uint64* ptr, uint64 value){
+    *ptr = value;
+}
+
+NCH_STATIC_FINLINE void
+nch_spin_lock(NCH_SpinLock* lock){
+    while (_InterlockedExchange(lock, 1)){}
+}
+
+NCH_STATIC_FINLINE void
+nch_spin_unlock(NCH_SpinLock* lock){
+    _InterlockedExchange(lock, 0);
+}
+
+#else
+
+NCH_STATIC_FINLINE long long
+nch_atomic_fetch_add(volatile long long* ptr, long long value){
+    return __atomic_fetch_add(ptr, value, __ATOMIC_RELAXED);
+}
+
+NCH_STATIC_FINLINE uint64
+nch_atomic_load(volatile uint64* ptr){
+    return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+}
+
+NCH_STATIC_FINLINE void
+nch_atomic_store(volatile uint64* ptr, uint64 value){
+    __atomic_store_n(ptr, value, __ATOMIC_RELAXED);
+}
+
+NCH_STATIC_FINLINE void
+nch_spin_lock(NCH_SpinLock* lock){
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE)){}
+}
+
+NCH_STATIC_FINLINE void
+nch_spin_unlock(NCH_SpinLock* lock){
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+#endif
+
+#endif // NCHESS_SRC_THREAD_H
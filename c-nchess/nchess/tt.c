@@ -0,0 +1,146 @@
+/*
+    tt.c
+
+    This file contains the definitions of the transposition table functions.
+*/
+
+#if !defined(_WIN32) && !defined(_DEFAULT_SOURCE)
+    #define _DEFAULT_SOURCE
+#endif
+
+#include "tt.h"
+
+#include <string.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+#endif
+
+// the size of the large pages of Linux (transparent huge pages)
+#define TT_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// the number of clusters counted by TT_Hashfull
+#define TT_HASHFULL_CLUSTERS 250
+
+#if defined(_WIN32)
+
+// large pages need the SeLockMemoryPrivilege. without it they could not
+// be allocated and the regular pages are used.
+NCH_STATIC void*
+tt_alloc(TransTable* tt, size_t size){
+    SIZE_T large_page = GetLargePageMinimum();
+    if (large_page){
+        size_t large_size = (size + large_page - 1) / large_page * large_page;
+        void* mem = VirtualAlloc(NULL, large_size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                                 PAGE_READWRITE);
+        if (mem){
+            tt->memory = mem;
+            tt->memory_size = large_size;
+            tt->large_pages = 1;
+            return mem;
+        }
+    }
+
+    void* mem = VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    tt->memory = mem;
+    tt->memory_size = size;
+    tt->large_pages = 0;
+    return mem;
+}
+
+NCH_STATIC void
+tt_dealloc(TransTable* tt){
+    VirtualFree(tt->memory, 0, MEM_RELEASE);
+}
+
+#else
+
+// the memory is mapped with room to align it to a huge page. the pages are
+// zeroed by the system and only allocated when they are touched.
+NCH_STATIC void*
+tt_alloc(TransTable* tt, size_t size){
+    size_t map_size = size + TT_HUGE_PAGE_SIZE;
+    void* mem = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+        return NULL;
+
+    tt->memory = mem;
+    tt->memory_size = map_size;
+    tt->large_pages = 0;
+
+    uintptr_t aligned = ((uintptr_t)mem + TT_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(TT_HUGE_PAGE_SIZE - 1);
+
+#if defined(MADV_HUGEPAGE)
+    if (madvise((void*)aligned, size, MADV_HUGEPAGE) == 0)
+        tt->large_pages = 1;
+#endif
+
+    return (void*)aligned;
+}
+
+NCH_STATIC void
+tt_dealloc(TransTable* tt){
+    munmap(tt->memory, tt->memory_size);
+}
+
+#endif
+
+int
+TT_Init(TransTable* tt, int size_mb){
+    uint64 nclusters = 1;
+    uint64 bytes = (uint64)(size_mb > 0 ? size_mb : 1) * 1024 * 1024;
+    while (nclusters * 2 * sizeof(TTCluster) <= bytes){
+        nclusters *= 2;
+    }
+
+    size_t size = (size_t)(nclusters * sizeof(TTCluster));
+    tt->clusters = (TTCluster*)tt_alloc(tt, size);
+    if (!tt->clusters)
+        return -1;
+
+    tt->mask = nclusters - 1;
+    tt->generation = 0;
+    return 0;
+}
+
+void
+TT_Free(TransTable* tt){
+    if (tt->clusters){
+        tt_dealloc(tt);
+        tt->clusters = NULL;
+        tt->memory = NULL;
+    }
+}
+
+void
+TT_Clear(TransTable* tt){
+    memset(tt->clusters, 0, (size_t)(tt->mask + 1) * sizeof(TTCluster));
+    tt->generation = 0;
+}
+
+void
+TT_NewSearch(TransTable* tt){
+    tt->generation = (tt->generation + 1) & (NCH_TT_GENERATIONS - 1);
+}
+
+int
+TT_Hashfull(const TransTable* tt){
+    uint64 nclusters = tt->mask + 1;
+    if (nclusters > TT_HASHFULL_CLUSTERS)
+        nclusters = TT_HASHFULL_CLUSTERS;
+
+    int count = 0;
+    for (uint64 i = 0; i < nclusters; i++){
+        const TTEntry* entries = tt->clusters[i].entries;
+        for (int j = 0; j < NCH_TT_CLUSTER_SIZE; j++){
+            uint64 data = entries[j].data;
+            if (data && TTData_GENERATION(data) == tt->generation)
+                count++;
+        }
+    }
+
+    return (int)(count * 1000 / (nclusters * NCH_TT_CLUSTER_SIZE));
+}
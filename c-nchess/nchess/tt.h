@@ -0,0 +1,165 @@
+/*
+    tt.h
+
+    This file contains the transposition table shared by the search and
+    perft. It is a power of two number of clusters of 4 entries, every
+    cluster fills a 64 byte cache line so a probe touches a single line.
+
+    The table is shared between threads without locks. An entry stores its
+    key xored with its data, so an entry written by two threads at the same
+    time does not match any key and is treated as a miss.
+
+    Every entry keeps the generation of the search that wrote it. When a
+    cluster is full the entry with the lowest depth is replaced, older
+    generations count as shallower so the table does not fill with entries
+    of old searches.
+*/
+
+#ifndef NCHESS_SRC_TT_H
+#define NCHESS_SRC_TT_H
+
+#include <stddef.h>
+
+#include "types.h"
+#include "config.h"
+#include "thread.h"
+
+#define NCH_TT_CLUSTER_SIZE 4
+
+// the number of generations before they wrap around
+#define NCH_TT_GENERATIONS 64
+
+/*
+    The data of an entry. The payload is free for the user of the table,
+    the search stores a move and a score and perft stores a count.
+
+        bits 0 - 47:  payload
+        bits 48 - 55: depth
+        bits 56 - 61: generation
+        bits 62 - 63: bound
+*/
+typedef uint64 TTData;
+
+#define TT_PAYLOAD_BITS 48
+#define TT_PAYLOAD_MASK ((1ULL << TT_PAYLOAD_BITS) - 1)
+
+#define TTData_PAYLOAD(data) ((data) & TT_PAYLOAD_MASK)
+#define TTData_DEPTH(data) (int)(((data) >> 48) & 0xFF)
+#define TTData_GENERATION(data) (int)(((data) >> 56) & 0x3F)
+#define TTData_BOUND(data) (int)((data) >> 62)
+
+// the bound of the score of a search entry. perft entries are exact.
+// an empty entry has no bound so every stored entry has one.
+#define TT_BOUND_NONE 0
+#define TT_BOUND_UPPER 1
+#define TT_BOUND_LOWER 2
+#define TT_BOUND_EXACT 3
+
+typedef struct
+{
+    volatile uint64 key;  // key ^ data
+    volatile uint64 data;
+}TTEntry;
+
+typedef struct
+{
+    TTEntry entries[NCH_TT_CLUSTER_SIZE];
+}TTCluster;
+
+typedef struct
+{
+    TTCluster* clusters;
+    uint64 mask;          // number of clusters - 1
+    uint8 generation;
+
+    // how the memory is allocated so it could be freed
+    void* memory;
+    size_t memory_size;
+    int large_pages;      // 1 if the table is backed by large pages
+}TransTable;
+
+// Allocates a table of at most size_mb megabytes. The table is empty.
+// Large pages are used if the system gives them (transparent huge pages on
+// Linux and large pages on Windows if the process has the privilege).
+// returns 0 on success and -1 if the memory could not be allocated.
+int
+TT_Init(TransTable* tt, int size_mb);
+
+// Frees the memory of the table.
+void
+TT_Free(TransTable* tt);
+
+// Removes all the entries of the table.
+void
+TT_Clear(TransTable* tt);
+
+// Starts a new generation. It is called before every search so the entries
+// of the searches before are replaced first.
+void
+TT_NewSearch(TransTable* tt);
+
+// Returns how full the table is in permille, counting only the entries of
+// the current generation. Only the first clusters are counted.
+int
+TT_Hashfull(const TransTable* tt);
+
+NCH_STATIC_FINLINE TTData
+TTData_New(uint64 payload, int depth, int bound, int generation){
+    return (payload & TT_PAYLOAD_MASK)
+         | ((uint64)(depth & 0xFF) << 48)
+         | ((uint64)(generation & 0x3F) << 56)
+         | ((uint64)bound << 62);
+}
+
+NCH_STATIC_FINLINE TTCluster*
+tt_cluster(const TransTable* tt, uint64 key){
+    return tt->clusters + (key & tt->mask);
+}
+
+// Finds the entry of the key. returns 1 and writes its data if it is found
+// and 0 otherwise.
+NCH_STATIC_INLINE int
+TT_Probe(const TransTable* tt, uint64 key, TTData* data){
+    TTEntry* entries = tt_cluster(tt, key)->entries;
+    for (int i = 0; i < NCH_TT_CLUSTER_SIZE; i++){
+        uint64 edata = nch_atomic_load(&entries[i].data);
+        uint64 ekey = nch_atomic_load(&entries[i].key);
+        if ((ekey ^ edata) == key && edata){
+            *data = edata;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Stores the data of the key. The entry of the same key is replaced,
+// otherwise an empty entry or the one with the lowest depth where every
+// generation of age counts as some plies less.
+NCH_STATIC_INLINE void
+TT_Store(TransTable* tt, uint64 key, uint64 payload, int depth, int bound){
+    TTEntry* entries = tt_cluster(tt, key)->entries;
+    TTEntry* replace = entries;
+    int replace_value = 1 << 30;
+
+    for (int i = 0; i < NCH_TT_CLUSTER_SIZE; i++){
+        uint64 edata = nch_atomic_load(&entries[i].data);
+        uint64 ekey = nch_atomic_load(&entries[i].key);
+        if (!edata || (ekey ^ edata) == key){
+            replace = entries + i;
+            break;
+        }
+
+        int age = (tt->generation - TTData_GENERATION(edata)) & (NCH_TT_GENERATIONS - 1);
+        int value = TTData_DEPTH(edata) - 4 * age;
+        if (value < replace_value){
+            replace_value = value;
+            replace = entries + i;
+        }
+    }
+
+    TTData data = TTData_New(payload, depth, bound, tt->generation);
+    nch_atomic_store(&replace->key, key ^ data);
+    nch_atomic_store(&replace->data, data);
+}
+
+#endif // NCHESS_SRC_TT_H
@@ -14,4 +14,10 @@ typedef unsigned char uint8;
 typedef unsigned short uint16;
 typedef unsigned int uint32;
 
+typedef short int16;
+typedef int int32;
+
+// a midgame and an endgame score packed together (see psqt.h)
+typedef int32 Score;
+
 #endif // NCHESS_SRC_TYPES_H
\ No newline at end of file
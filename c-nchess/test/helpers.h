@@ -62,7 +62,5 @@ int boards_are_equal(const Board* b1, const Board* b2);
 // Helper function to compare move nodes
 int move_nodes_are_equal(const MoveNode* n1, const MoveNode* n2);
 
-// Helper function to compare board dict nodes
-int board_nodes_are_equal(const BoardNode* n1, const BoardNode* n2);
 
 #endif // NCHESS_TEST_HELPERS_H
@@ -76,6 +76,12 @@ int main(void) {
     test_fen_suite(&results);
     test_hash_suite(&results);
     test_io_suite(&results);
+    test_pack_suite(&results);
+    test_pgn_suite(&results);
+    test_search_suite(&results);
+    test_tt_suite(&results);
+    test_nnue_suite(&results);
+    test_psqt_suite(&results);
     
     // Print final results
     print_final_results(&results);
@@ -108,78 +114,14 @@ int move_nodes_are_equal(const MoveNode* n1, const MoveNode* n2) {
         && (n1->move == n2->move);
 }
 
-int board_nodes_are_equal(const BoardNode* n1, const BoardNode* n2) {
-    return !memcmp(n1->bitboards, n2->bitboards, sizeof(n1->bitboards))
-        && (n1->count == n2->count)
-        && (n1->empty == n2->empty);
-}
-
-static int check_dict_recursive(const BoardNode* n1, const BoardNode* n2) {
-    if (!n1 && !n2)
-        return 1;
-    
-    if (n1 && n2) {
-        if (!board_nodes_are_equal(n1, n2))
-            return 0;
-        
-        if (n1->next)
-            return check_dict_recursive(n1->next, n2->next);
-        
-        return 1;
-    }
-    
-    return 0;
-}
-
 int boards_are_equal(const Board* b1, const Board* b2) {
     // Check movelist
     if (b1->movelist.len != b2->movelist.len)
         return 0;
     
-    int max_len = NCH_MOVELIST_SIZE > b1->movelist.len ? 
-                  b1->movelist.len : NCH_MOVELIST_SIZE;
-    
-    const MoveNode *mn_1, *mn_2;
-    for (int i = 0; i < max_len; i++) {
-        mn_1 = &b1->movelist.nodes[i];
-        mn_2 = &b2->movelist.nodes[i];
-        
-        if (!move_nodes_are_equal(mn_1, mn_2))
-            return 0;
-    }
-    
-    if (b1->movelist.extra) {
-        if (!b2->movelist.extra)
-            return 0;
-        
-        mn_1 = b1->movelist.extra;
-        mn_2 = b2->movelist.extra;
-        
-        while (mn_1 && mn_2) {
-            if (!move_nodes_are_equal(mn_1, mn_2))
-                return 0;
-            
-            mn_1 = mn_1->next;
-            mn_2 = mn_2->next;
-        }
-        
-        if (mn_1 || mn_2)
-            return 0;
-    }
-    
-    // Check dict
-    const BoardNode *bn_1, *bn_2;
-    for (int i = 0; i < NCH_BOARD_DICT_SIZE; i++) {
-        bn_1 = &b1->dict.nodes[i];
-        bn_2 = &b2->dict.nodes[i];
-        
-        if (!board_nodes_are_equal(bn_1, bn_2))
+    for (int i = 0; i < b1->movelist.len; i++) {
+        if (!move_nodes_are_equal(&b1->movelist.nodes[i], &b2->movelist.nodes[i]))
             return 0;
-        
-        if (bn_1->next) {
-            if (!check_dict_recursive(bn_1, bn_2))
-                return 0;
-        }
     }
     
     // Check board state
@@ -37,6 +37,12 @@ void test_generate_suite(TestResults* results);
 void test_hash_suite(TestResults* results);
 void test_io_suite(TestResults* results);
 void test_move_suite(TestResults* results);
+void test_nnue_suite(TestResults* results);
+void test_pack_suite(TestResults* results);
 void test_perft_suite(TestResults* results);
+void test_psqt_suite(TestResults* results);
+void test_pgn_suite(TestResults* results);
+void test_search_suite(TestResults* results);
+void test_tt_suite(TestResults* results);
 
 #endif // NCHESS_TEST_MAIN_H
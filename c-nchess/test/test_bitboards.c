@@ -1,5 +1,6 @@
 #include "main.h"
 #include "helpers.h"
+#include "magic_utils.h"
 
 // Test basic bitboard operations
 static int test_bitboard_creation(void) {
@@ -173,6 +174,76 @@ static int test_bitboard_symmetry(void) {
     return 1;
 }
 
+// checks every occupancy of every square against the attacks computed on the fly
+static int check_slider_tables(void) {
+    uint64 mask, occupancy;
+    int bits;
+    for (int sqr = 0; sqr < NCH_SQUARE_NB; sqr++){
+        mask = bb_rook_mask(sqr);
+        bits = count_bits(mask);
+        for (int i = 0; i < (1 << bits); i++){
+            occupancy = set_occupancy(i, bits, mask);
+            // squares outside the mask must not change the result
+            ASSERT_EQ(bb_rook_attacks(sqr, occupancy | ~mask), get_rook_mask_on_fly(sqr, occupancy));
+        }
+
+        mask = bb_bishop_mask(sqr);
+        bits = count_bits(mask);
+        for (int i = 0; i < (1 << bits); i++){
+            occupancy = set_occupancy(i, bits, mask);
+            ASSERT_EQ(bb_bishop_attacks(sqr, occupancy | ~mask), get_bishop_mask_on_fly(sqr, occupancy));
+        }
+    }
+    return 1;
+}
+
+// Test the packed slider tables with both the magic and the pext backends
+static int test_bitboard_slider_backends(void) {
+    SliderBackend initial = SliderBackendInUse;
+
+    ASSERT_EQ(SliderOffsets[NCH_RS][63] + (1 << bb_rook_relevant(63)), NCH_ROOK_TABLE_SIZE);
+    ASSERT_EQ(SliderOffsets[NCH_BS][63] + (1 << bb_bishop_relevant(63)), NCH_BISHOP_TABLE_SIZE);
+
+    int ok = 1;
+    if (NCH_SetSliderBackend(NCH_SliderMagic) == 0)
+        ok &= check_slider_tables();
+    if (NCH_SetSliderBackend(NCH_SliderPext) == 0)
+        ok &= check_slider_tables();
+
+    NCH_SetSliderBackend(initial);
+    return ok;
+}
+
+// Test the expansion of bitboards into arrays against a bit by bit expansion
+static int test_bitboard_expand(void) {
+    uint64 samples[] = {
+        0ULL, NCH_UINT64_MAX, 1ULL, 0x8000000000000000ULL,
+        0x8040201008040201ULL, 0x00FF00FF00FF00FFULL, 0x123456789ABCDEF0ULL,
+        NCH_BOARD_W_PAWNS_STARTPOS | NCH_BOARD_B_ROOKS_STARTPOS
+    };
+
+    uint8 bytes[NCH_SQUARE_NB];
+    int ints[NCH_SQUARE_NB];
+    float floats[NCH_SQUARE_NB];
+    int expected;
+
+    for (int k = 0; k < (int)(sizeof(samples) / sizeof(samples[0])); k++){
+        for (int reversed = 0; reversed < 2; reversed++){
+            bb_expand_u8(samples[k], bytes, reversed);
+            bb_expand_i32(samples[k], ints, reversed);
+            bb_expand_f32(samples[k], floats, reversed);
+
+            for (int i = 0; i < NCH_SQUARE_NB; i++){
+                expected = (int)((samples[k] >> (reversed ? 63 - i : i)) & 1);
+                ASSERT_EQ(bytes[i], expected);
+                ASSERT_EQ(ints[i], expected);
+                ASSERT(floats[i] == (float)expected);
+            }
+        }
+    }
+    return 1;
+}
+
 // Test suite runner
 void test_bitboard_suite(TestResults* results) {
     TestFunc tests[] = {
@@ -184,8 +255,10 @@ void test_bitboard_suite(TestResults* results) {
         test_bitboard_clearing,
         test_bitboard_complex_position,
         test_bitboard_after_capture,
-        test_bitboard_symmetry
+        test_bitboard_symmetry,
+        test_bitboard_slider_backends,
+        test_bitboard_expand
     };
     
-    run_test_suite("BitBoard Tests", tests, 9, results);
+    run_test_suite("BitBoard Tests", tests, 11, results);
 }
\ No newline at end of file
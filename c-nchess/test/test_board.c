@@ -157,6 +157,56 @@ static int test_board_fifty_counter(void) {
     return 1;
 }
 
+// Test castle rights of pieces off their squares are removed on fen load
+static int test_board_fen_castle_rights(void) {
+    Board* board = Board_NewFen("r3k2r/8/8/8/8/8/8/1R2K2R w KQkq - 0 1");
+    ASSERT_NOT_NULL(board);
+    
+    ASSERT(Board_IS_CASTLE_WK(board));
+    ASSERT(!Board_IS_CASTLE_WQ(board));
+    ASSERT(Board_IS_CASTLE_BK(board));
+    ASSERT(Board_IS_CASTLE_BQ(board));
+    
+    // capturing a rook on its square removes the rights of its side
+    ASSERT(Board_Step(board, "h1h8"));
+    ASSERT(!Board_IS_CASTLE_WK(board));
+    ASSERT(!Board_IS_CASTLE_BK(board));
+    ASSERT(Board_IS_CASTLE_BQ(board));
+    
+    Board_Free(board);
+    return 1;
+}
+
+// Test DoMove and UndoMove give the same position as a step and an undo
+static int test_board_do_undo_move(void) {
+    Board* board = Board_NewFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    ASSERT_NOT_NULL(board);
+    Board* stepped = Board_NewCopy(board);
+    ASSERT_NOT_NULL(stepped);
+    
+    Move moves[256];
+    int nmoves = Board_GenerateLegalMoves(board, moves);
+    PositionInfo undo;
+    
+    for (int i = 0; i < nmoves; i++) {
+        Board_DoMove(board, moves[i], &undo);
+        _Board_MakeMove(stepped, moves[i]);
+        
+        ASSERT(!memcmp(board->bitboards, stepped->bitboards, sizeof(board->bitboards)));
+        ASSERT(!memcmp(board->piecetables, stepped->piecetables, sizeof(board->piecetables)));
+        ASSERT(!memcmp(&board->info, &stepped->info, sizeof(PositionInfo)));
+        ASSERT_EQ(board->movelist.len, 0);
+        
+        Board_UndoMove(board, moves[i], &undo);
+        Board_Undo(stepped);
+        ASSERT(boards_are_equal(board, stepped));
+    }
+    
+    Board_Free(board);
+    Board_Free(stepped);
+    return 1;
+}
+
 // Test board state game over detection
 static int test_board_state_checkmate(void) {
     Board* board = Board_NewFen("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3");
@@ -198,9 +248,11 @@ void test_board_suite(TestResults* results) {
         test_board_state_after_moves,
         test_board_castle_rights,
         test_board_fifty_counter,
+        test_board_fen_castle_rights,
+        test_board_do_undo_move,
         test_board_state_checkmate,
         test_board_state_stalemate
     };
     
-    run_test_suite("Board State Tests", tests, 12, results);
+    run_test_suite("Board State Tests", tests, 14, results);
 }
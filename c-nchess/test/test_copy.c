@@ -111,6 +111,40 @@ static int test_copy_movelist(void) {
     return 1;
 }
 
+// Test copying the position without the history
+static int test_copy_position(void) {
+    Board* board = Board_New();
+    ASSERT_NOT_NULL(board);
+    
+    Board_Step(board, "e2e4");
+    Board_Step(board, "c7c5");
+    Board_Step(board, "g1f3");
+    
+    Board copy;
+    Board_CopyPosition(board, &copy);
+    
+    ASSERT_EQ(copy.movelist.len, 0);
+    ASSERT(copy.movelist.nodes == NULL);
+    ASSERT_EQ(Board_NMOVES(&copy), Board_NMOVES(board));
+    ASSERT(!memcmp(copy.bitboards, board->bitboards, sizeof(copy.bitboards)));
+    ASSERT(!memcmp(copy.piecetables, board->piecetables, sizeof(copy.piecetables)));
+    ASSERT(!memcmp(&copy.info, &board->info, sizeof(PositionInfo)));
+    
+    // the copy could play and undo its own moves
+    ASSERT(Board_Step(&copy, "d7d6"));
+    ASSERT_EQ(copy.movelist.len, 1);
+    Board_Undo(&copy);
+    ASSERT(!memcmp(&copy.info, &board->info, sizeof(PositionInfo)));
+    
+    // undo does nothing when there is no history
+    Board_Undo(&copy);
+    ASSERT(!memcmp(copy.bitboards, board->bitboards, sizeof(copy.bitboards)));
+    
+    Board_FreeExtraOnly(&copy);
+    Board_Free(board);
+    return 1;
+}
+
 // Test copy from FEN position
 static int test_copy_from_fen(void) {
     Board* board = Board_NewFen("r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4");
@@ -240,6 +274,7 @@ void test_copy_suite(TestResults* results) {
         test_copy_after_moves,
         test_copy_bitboard_modification,
         test_copy_movelist,
+        test_copy_position,
         test_copy_from_fen,
         test_copy_castle_rights,
         test_copy_simple_verification,
@@ -248,5 +283,5 @@ void test_copy_suite(TestResults* results) {
         test_copy_multiple
     };
     
-    run_test_suite("Board Copy Tests", tests, 11, results);
+    run_test_suite("Board Copy Tests", tests, 12, results);
 }
\ No newline at end of file
@@ -97,6 +97,23 @@ static int test_fen_en_passant_square(void) {
     return 1;
 }
 
+// Test FEN en passant round-trip and the capture it allows
+static int test_fen_en_passant_roundtrip(void) {
+    const char* fen = "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3";
+    if (!test_fen_roundtrip(fen))
+        return 0;
+
+    Board board;
+    Board_Init(&board);
+    ASSERT(Board_FromFen(fen, &board) == 0);
+    ASSERT_EQ(Board_ENP_IDX(&board), NCH_F5);
+    ASSERT(Board_Step(&board, "e5f6"));
+    ASSERT_EQ(Board_PIECE(&board, NCH_F5), NCH_NO_PIECE);
+
+    Board_FreeExtraOnly(&board);
+    return 1;
+}
+
 // Test FEN empty position
 static int test_fen_empty(void) {
     return test_fen_roundtrip("8/8/8/8/8/8/8/8 w - - 0 1");
@@ -146,6 +163,109 @@ static int test_fen_invalid(void) {
     return 1;
 }
 
+// Test reading a buffer of FEN, EPD and CSV lines with bad and empty lines
+static int test_fen_lines(void) {
+    const char* buffer =
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1\n"
+        "\n"
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - bm Qxf6; id \"kiwi\";\r\n"
+        "hello world\n"
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 10 44,0.5,1\n"
+        "8/8/8/8/8/8/8 w - - 0 1\n"
+        "   \t \n"
+        "4k3/8/8/8/8/8/8/4K3 w - -";
+
+    const char* expected[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        NULL,
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 10 44",
+        NULL,
+        "4k3/8/8/8/8/8/8/4K3 w - - 0 1",
+    };
+    long long expected_lines[] = {1, 3, 4, 5, 6, 8};
+
+    size_t len = strlen(buffer);
+    ASSERT_EQ(Board_CountFenLines(buffer, len, 1), 6);
+
+    Board boards[6];
+    int status[6];
+    long long lines[6];
+    ASSERT_EQ(Board_FromFenLines(buffer, len, boards, status, lines, 6, 1), 6);
+
+    char fen[NCH_FEN_MAX_LENGTH];
+    for (int i = 0; i < 6; i++){
+        ASSERT_EQ(lines[i], expected_lines[i]);
+        ASSERT_EQ(status[i], expected[i] ? 0 : -1);
+        if (expected[i]){
+            Board_AsFen(boards + i, fen);
+            ASSERT_STR_EQ(fen, expected[i]);
+        }
+    }
+
+    // a smaller array stops the reading
+    ASSERT_EQ(Board_FromFenLines(buffer, len, boards, status, NULL, 2, 1), 2);
+    return 1;
+}
+
+// Test reading and writing many lines with many threads
+static int test_fen_lines_threads(void) {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 10 44",
+        "rnbqkb1r/pp1p1ppp/2p5/4P3/2B5/8/PPP1NnPP/RNBQK2R b KQkq - 1 8",
+        "bad line",
+    };
+    const int nfens = 5;
+    const long long n = 20000;
+
+    char* buffer = (char*)malloc(n * NCH_FEN_MAX_LENGTH);
+    Board* boards = (Board*)malloc(n * sizeof(Board));
+    Board* boards_mt = (Board*)malloc(n * sizeof(Board));
+    int* status = (int*)malloc(n * sizeof(int));
+    int* status_mt = (int*)malloc(n * sizeof(int));
+    long long* lines_mt = (long long*)malloc(n * sizeof(long long));
+    char* written = (char*)malloc(n * NCH_FEN_MAX_LENGTH);
+    char* written_mt = (char*)malloc(n * NCH_FEN_MAX_LENGTH);
+    ASSERT(buffer && boards && boards_mt && status && status_mt && lines_mt && written && written_mt);
+
+    size_t len = 0;
+    for (long long i = 0; i < n; i++){
+        len += sprintf(buffer + len, "%s\n", fens[i % nfens]);
+    }
+
+    ASSERT_EQ(Board_CountFenLines(buffer, len, 4), n);
+    ASSERT_EQ(Board_FromFenLines(buffer, len, boards, status, NULL, n, 1), n);
+    ASSERT_EQ(Board_FromFenLines(buffer, len, boards_mt, status_mt, lines_mt, n, 4), n);
+
+    int ok = 1;
+    for (long long i = 0; i < n && ok; i++){
+        ok = status[i] == status_mt[i]
+          && status[i] == (i % nfens == nfens - 1 ? -1 : 0)
+          && lines_mt[i] == i + 1
+          && Board_KEY(boards + i) == Board_KEY(boards_mt + i);
+    }
+
+    long long written_len = Board_AsFenLines(boards, n, written, 1);
+    long long written_len_mt = Board_AsFenLines(boards_mt, n, written_mt, 4);
+    ok = ok && written_len == written_len_mt && !memcmp(written, written_mt, written_len);
+
+    // the boards are compared by the fens they write. the good lines are
+    // written back as they were read
+    ok = ok && !strncmp(written, buffer, strlen(fens[0]) + 1);
+
+    free(buffer);
+    free(boards);
+    free(boards_mt);
+    free(status);
+    free(status_mt);
+    free(lines_mt);
+    free(written);
+    free(written_mt);
+    return ok;
+}
+
 // Test suite runner
 void test_fen_suite(TestResults* results) {
     TestFunc tests[] = {
@@ -159,14 +279,17 @@ void test_fen_suite(TestResults* results) {
         test_fen_no_castling,
         test_fen_partial_castling,
         test_fen_en_passant_square,
+        test_fen_en_passant_roundtrip,
         test_fen_empty,
         test_fen_only_kings,
         test_fen_midgame,
         test_fen_endgame,
         test_fen_high_counts,
         test_fen_black_turn,
-        test_fen_invalid
+        test_fen_invalid,
+        test_fen_lines,
+        test_fen_lines_threads
     };
     
-    run_test_suite("FEN Tests", tests, 17, results);
+    run_test_suite("FEN Tests", tests, 20, results);
 }
\ No newline at end of file
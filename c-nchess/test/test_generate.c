@@ -178,6 +178,121 @@ static int test_generate_promotions(void) {
     return 1;
 }
 
+static const char* staged_fens[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+    "4k3/8/8/8/8/8/8/4K2q w - - 0 1",
+};
+
+static int move_in(Move move, const Move* moves, int n){
+    for (int i = 0; i < n; i++){
+        if (moves[i] == move)
+            return 1;
+    }
+    return 0;
+}
+
+// Test that the captures and the quiets split the legal moves
+static int test_generate_captures_and_quiets(void) {
+    int nfens = (int)(sizeof(staged_fens) / sizeof(staged_fens[0]));
+    for (int f = 0; f < nfens; f++){
+        Board* board = Board_NewFen(staged_fens[f]);
+        ASSERT_NOT_NULL(board);
+
+        Move legal[256], captures[256], quiets[256];
+        int nlegal = Board_GenerateLegalMoves(board, legal);
+        int ncaptures = Board_GenerateCaptures(board, captures);
+        int nquiets = Board_GenerateQuiets(board, quiets);
+
+        ASSERT_EQ(ncaptures + nquiets, nlegal);
+
+        for (int i = 0; i < ncaptures; i++){
+            Move m = captures[i];
+            ASSERT(move_in(m, legal, nlegal));
+            ASSERT(!move_in(m, quiets, nquiets));
+            ASSERT(Move_IsPromotion(m) || Move_IsEnPassant(m)
+                   || Board_PIECE(board, Move_TO(m)) != NCH_NO_PIECE);
+        }
+
+        for (int i = 0; i < nquiets; i++){
+            Move m = quiets[i];
+            ASSERT(move_in(m, legal, nlegal));
+            ASSERT(!Move_IsPromotion(m) && !Move_IsEnPassant(m));
+            ASSERT(Board_PIECE(board, Move_TO(m)) == NCH_NO_PIECE);
+        }
+
+        Board_Free(board);
+    }
+    return 1;
+}
+
+// Test the staged generator gives captures first and evasions under check
+static int test_generate_staged(void) {
+    int nfens = (int)(sizeof(staged_fens) / sizeof(staged_fens[0]));
+    for (int f = 0; f < nfens; f++){
+        Board* board = Board_NewFen(staged_fens[f]);
+        ASSERT_NOT_NULL(board);
+
+        Move legal[256], captures[256];
+        int nlegal = Board_GenerateLegalMoves(board, legal);
+        int ncaptures = Board_GenerateCaptures(board, captures);
+        int in_check = Board_IS_CHECK(board) != 0;
+
+        MoveGen gen;
+        Move move;
+        int n = 0;
+        MoveGen_Init(&gen, board, 0);
+        while (MoveGen_Next(&gen, &move)){
+            ASSERT(move_in(move, legal, nlegal));
+            if (!in_check)
+                ASSERT_EQ(n < ncaptures, move_in(move, captures, ncaptures));
+            n++;
+        }
+        ASSERT_EQ(n, nlegal);
+
+        n = 0;
+        MoveGen_Init(&gen, board, 1);
+        while (MoveGen_Next(&gen, &move))
+            n++;
+        ASSERT_EQ(n, in_check ? nlegal : ncaptures);
+
+        Move evasions[256];
+        ASSERT_EQ(Board_GenerateEvasions(board, evasions), in_check ? nlegal : 0);
+
+        Board_Free(board);
+    }
+    return 1;
+}
+
+// Test counting the legal moves without generating them
+static int test_count_legal_moves(void) {
+    int nfens = (int)(sizeof(staged_fens) / sizeof(staged_fens[0]));
+    for (int f = 0; f < nfens; f++){
+        Board* board = Board_NewFen(staged_fens[f]);
+        ASSERT_NOT_NULL(board);
+
+        Move moves[256];
+        int nmoves = Board_GenerateLegalMoves(board, moves);
+        ASSERT_EQ(Board_CountLegalMoves(board), nmoves);
+
+        int expected[NCH_PIECE_TYPE_NB] = {0};
+        for (int i = 0; i < nmoves; i++)
+            expected[Piece_TYPE(Board_PIECE(board, Move_FROM(moves[i])))]++;
+
+        int counts[NCH_PIECE_TYPE_NB];
+        ASSERT_EQ(Board_CountLegalMovesByType(board, counts), nmoves);
+        for (int t = 0; t < NCH_PIECE_TYPE_NB; t++)
+            ASSERT_EQ(counts[t], expected[t]);
+
+        Board_Free(board);
+    }
+    return 1;
+}
+
 // Test suite runner
 void test_generate_suite(TestResults* results) {
     TestFunc tests[] = {
@@ -190,8 +305,11 @@ void test_generate_suite(TestResults* results) {
         test_generate_with_pins,
         test_generate_castling,
         test_generate_en_passant,
-        test_generate_promotions
+        test_generate_promotions,
+        test_generate_captures_and_quiets,
+        test_generate_staged,
+        test_count_legal_moves
     };
     
-    run_test_suite("Move Generation Tests", tests, 10, results);
+    run_test_suite("Move Generation Tests", tests, 13, results);
 }
@@ -1,178 +1,213 @@
 #include "main.h"
 #include "helpers.h"
 
-// Test hash dictionary initialization
-static int test_hash_dict_init(void) {
-    BoardDict dict;
-    BoardDict_Init(&dict);
-    
-    // All nodes should be empty
-    for (int i = 0; i < NCH_BOARD_DICT_SIZE; i++) {
-        ASSERT(dict.nodes[i].empty == 1);
-    }
-    
-    return 1;
-}
-
-// Test adding position to dictionary
-static int test_hash_dict_add(void) {
+// Test threefold repetition detection
+static int test_hash_threefold_repetition(void) {
     Board board;
     Board_Init(&board);
     
-    BoardDict dict;
-    BoardDict_Init(&dict);
+    const char* moves[] = {"g1f3", "g8f6", "f3g1", "f6g8",
+                           "g1f3", "g8f6", "f3g1", "f6g8"};
     
-    int result = BoardDict_Add(&dict, board.bitboards);
-    ASSERT(result == 0);
+    // the starting position appears for the third time only after the last move
+    for (int i = 0; i < 8; i++) {
+        ASSERT(!Board_IsThreeFold(&board));
+        ASSERT(Board_Step(&board, (char*)moves[i]));
+    }
+    ASSERT(Board_IsThreeFold(&board));
+    ASSERT_EQ(Board_State(&board, 1), NCH_GS_Draw_ThreeFold);
     
-    int count = BoardDict_GetCount(&dict, board.bitboards);
-    ASSERT_EQ(count, 1);
+    Board_Undo(&board);
+    ASSERT(!Board_IsThreeFold(&board));
     
-    BoardDict_FreeExtra(&dict);
+    Board_FreeExtraOnly(&board);
     return 1;
 }
 
-// Test adding same position multiple times
-static int test_hash_dict_add_duplicate(void) {
-    Board board;
-    Board_Init(&board);
+// Test positions with different castle rights are not counted as repetitions
+static int test_hash_repetition_castle_rights(void) {
+    Board* board = Board_NewFen("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+    ASSERT_NOT_NULL(board);
+    
+    const char* moves[] = {"h1g1", "h8g8", "g1h1", "g8h8"};
+    
+    // the position after the first cycle lost the king side rights so the
+    // starting position is never repeated. the new position repeats at
+    // the end of every cycle.
+    for (int cycle = 0; cycle < 3; cycle++) {
+        for (int i = 0; i < 4; i++) {
+            ASSERT(Board_Step(board, (char*)moves[i]));
+        }
+        ASSERT_EQ(Board_IsThreeFold(board), cycle == 2);
+    }
     
-    BoardDict dict;
-    BoardDict_Init(&dict);
+    Board_Free(board);
+    return 1;
+}
+
+// Test a capture or a pawn move ends the repetition history
+static int test_hash_repetition_irreversible(void) {
+    Board* board = Board_NewFen("4k3/4p3/8/8/8/8/4P3/4K3 w - - 0 1");
+    ASSERT_NOT_NULL(board);
     
-    BoardDict_Add(&dict, board.bitboards);
-    BoardDict_Add(&dict, board.bitboards);
-    BoardDict_Add(&dict, board.bitboards);
+    const char* moves[] = {"e1d1", "e8d8", "d1e1", "d8e8"};
     
-    int count = BoardDict_GetCount(&dict, board.bitboards);
-    ASSERT_EQ(count, 3);
+    for (int i = 0; i < 4; i++) {
+        ASSERT(Board_Step(board, (char*)moves[i]));
+    }
+    ASSERT(Board_Step(board, "e2e3"));
+    ASSERT(Board_Step(board, "e7e6"));
+    
+    // the position right after the pawn moves is the first one that
+    // could be repeated
+    for (int cycle = 0; cycle < 2; cycle++) {
+        ASSERT(!Board_IsThreeFold(board));
+        for (int i = 0; i < 4; i++) {
+            ASSERT(Board_Step(board, (char*)moves[i]));
+        }
+    }
+    ASSERT(Board_IsThreeFold(board));
     
-    BoardDict_FreeExtra(&dict);
+    Board_Free(board);
     return 1;
 }
 
-// Test removing position from dictionary
-static int test_hash_dict_remove(void) {
+// Test repetition detection in a game longer than the first move list array
+static int test_hash_repetition_long_game(void) {
     Board board;
     Board_Init(&board);
     
-    BoardDict dict;
-    BoardDict_Init(&dict);
+    const char* moves[] = {"g1f3", "g8f6", "f3g1", "f6g8"};
+    int nplies = NCH_MOVELIST_INIT_SIZE * 4 + 8;
     
-    BoardDict_Add(&dict, board.bitboards);
-    BoardDict_Add(&dict, board.bitboards);
+    for (int i = 0; i < nplies; i++) {
+        ASSERT(Board_Step(&board, (char*)moves[i % 4]));
+    }
+    ASSERT(board.movelist.cap > NCH_MOVELIST_INIT_SIZE);
+    ASSERT(Board_IsThreeFold(&board));
     
-    int result = BoardDict_Remove(&dict, board.bitboards);
-    ASSERT(result == 0);
+    Board_Undo(&board);
+    ASSERT(Board_IsThreeFold(&board));
     
-    int count = BoardDict_GetCount(&dict, board.bitboards);
-    ASSERT_EQ(count, 1);
+    // only the first two cycles are not enough for a repetition
+    while (board.movelist.len > 7) {
+        Board_Undo(&board);
+    }
+    ASSERT(!Board_IsThreeFold(&board));
+    for (int i = 7; i < nplies; i++) {
+        ASSERT(Board_Step(&board, (char*)moves[i % 4]));
+    }
     
-    BoardDict_FreeExtra(&dict);
-    return 1;
-}
-
-// Test threefold repetition detection
-static int test_hash_threefold_repetition(void) {
-    Board board;
-    Board_Init(&board);
+    // a copy keeps the history and so the repetitions
+    Board* copy = Board_NewCopy(&board);
+    ASSERT_NOT_NULL(copy);
+    ASSERT(Board_IsThreeFold(copy));
     
-    // Play moves that repeat position
-    Board_Step(&board, "g1f3");
-    Board_Step(&board, "g8f6");
-    Board_Step(&board, "f3g1");
-    Board_Step(&board, "f6g8");
-    Board_Step(&board, "g1f3");
-    Board_Step(&board, "g8f6");
-    Board_Step(&board, "f3g1");
-    Board_Step(&board, "f6g8");
-    
-    // After these moves, initial position should appear 3 times
-    // But the actual count may vary depending on implementation
-    int count = BoardDict_GetCount(&board.dict, board.bitboards);
-    ASSERT(count >= 1);  // At least appeared once
-
-    // Clean up dynamic extras attached to stack board
+    Board_Free(copy);
     Board_FreeExtraOnly(&board);
     return 1;
 }
 
-// Test dictionary reset
-static int test_hash_dict_reset(void) {
+// Test key of a new board matches the key calculated from scratch
+static int test_hash_key_init(void) {
     Board board;
     Board_Init(&board);
     
-    BoardDict dict;
-    BoardDict_Init(&dict);
-    
-    int result = BoardDict_Add(&dict, board.bitboards);
-    ASSERT(result == 0);
+    ASSERT(Board_KEY(&board) != 0ULL);
+    ASSERT(Board_KEY(&board) == Board_ComputeKey(&board));
     
-    BoardDict_Reset(&dict);
+    Board* fen_board = Board_NewFen("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    ASSERT_NOT_NULL(fen_board);
+    ASSERT(Board_KEY(fen_board) == Board_KEY(&board));
     
-    int count = BoardDict_GetCount(&dict, board.bitboards);
-    // After reset, should return 0 or negative error code
-    ASSERT(count <= 0);
-    
-    BoardDict_FreeExtra(&dict);
+    Board_Free(fen_board);
+    Board_FreeExtraOnly(&board);
     return 1;
 }
 
-// Test dictionary with different positions
-static int test_hash_dict_different_positions(void) {
-    Board board1, board2;
-    Board_Init(&board1);
-    Board_InitEmpty(&board2);
-    
-    BoardDict dict;
-    BoardDict_Init(&dict);
-    
-    int result = BoardDict_Add(&dict, board1.bitboards);
-    ASSERT(result == 0);
+// Test key stays in sync with the position after moves of all types and undo
+static int test_hash_key_incremental(void) {
+    Board* board = Board_NewFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+    ASSERT_NOT_NULL(board);
+    
+    uint64 start_key = Board_KEY(board);
+    const char* moves[] = {"e1g1", "a6e2", "a2a4", "b4a3", "d5e6", "e8c8", "e6f7", "a3b2", "f7f8q", "b2a1n"};
+    int n = sizeof(moves) / sizeof(moves[0]);
+    
+    for (int i = 0; i < n; i++) {
+        ASSERT(Board_Step(board, (char*)moves[i]));
+        ASSERT(Board_KEY(board) == Board_ComputeKey(board));
+    }
     
-    int count1 = BoardDict_GetCount(&dict, board1.bitboards);
-    int count2 = BoardDict_GetCount(&dict, board2.bitboards);
+    for (int i = 0; i < n; i++) {
+        Board_Undo(board);
+        ASSERT(Board_KEY(board) == Board_ComputeKey(board));
+    }
     
-    ASSERT_EQ(count1, 1);
-    // count2 should be 0 or error code
-    ASSERT(count2 <= 0);
+    ASSERT(Board_KEY(board) == start_key);
     
-    BoardDict_FreeExtra(&dict);
+    Board_Free(board);
     return 1;
 }
 
-// Test dictionary copy
-static int test_hash_dict_copy(void) {
-    Board board;
-    Board_Init(&board);
-    
-    BoardDict dict1, dict2;
-    BoardDict_Init(&dict1);
-    BoardDict_Init(&dict2);
-    
-    BoardDict_Add(&dict1, board.bitboards);
-    BoardDict_Add(&dict1, board.bitboards);
-    
-    int result = BoardDict_CopyExtra(&dict1, &dict2);
-    ASSERT(result == 0);
-    
-    BoardDict_FreeExtra(&dict1);
-    BoardDict_FreeExtra(&dict2);
+// Test transpositions share a key and side, castle rights and en passant change it
+static int test_hash_key_transposition(void) {
+    Board b1, b2;
+    Board_Init(&b1);
+    Board_Init(&b2);
+    
+    Board_Step(&b1, "g1f3");
+    Board_Step(&b1, "g8f6");
+    Board_Step(&b1, "b1c3");
+    
+    Board_Step(&b2, "b1c3");
+    Board_Step(&b2, "g8f6");
+    Board_Step(&b2, "g1f3");
+    
+    ASSERT(Board_KEY(&b1) == Board_KEY(&b2));
+    
+    // same pieces but different side to play
+    Board* w = Board_NewFen("4k3/8/8/8/8/8/8/4K3 w - - 0 1");
+    Board* b = Board_NewFen("4k3/8/8/8/8/8/8/4K3 b - - 0 1");
+    ASSERT(Board_KEY(w) != Board_KEY(b));
+    
+    // same pieces but different castle rights
+    Board* c1 = Board_NewFen("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+    Board* c2 = Board_NewFen("r3k2r/8/8/8/8/8/8/R3K2R w Kkq - 0 1");
+    ASSERT(Board_KEY(c1) != Board_KEY(c2));
+    
+    // en passant is hashed only when it could be taken
+    Board* e1 = Board_NewFen("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1");
+    Board* e2 = Board_NewFen("4k3/8/8/3pP3/8/8/8/4K3 w - - 0 1");
+    Board* e3 = Board_NewFen("4k3/8/8/3p4/8/8/4P3/4K3 w - d6 0 1");
+    Board* e4 = Board_NewFen("4k3/8/8/3p4/8/8/4P3/4K3 w - - 0 1");
+    ASSERT(Board_KEY(e1) != Board_KEY(e2));
+    ASSERT(Board_KEY(e3) == Board_KEY(e4));
+    
+    Board_Free(w);
+    Board_Free(b);
+    Board_Free(c1);
+    Board_Free(c2);
+    Board_Free(e1);
+    Board_Free(e2);
+    Board_Free(e3);
+    Board_Free(e4);
+    Board_FreeExtraOnly(&b1);
+    Board_FreeExtraOnly(&b2);
     return 1;
 }
 
 // Test suite runner
 void test_hash_suite(TestResults* results) {
     TestFunc tests[] = {
-        test_hash_dict_init,
-        test_hash_dict_add,
-        test_hash_dict_add_duplicate,
-        test_hash_dict_remove,
         test_hash_threefold_repetition,
-        test_hash_dict_reset,
-        test_hash_dict_different_positions,
-        test_hash_dict_copy
+        test_hash_repetition_castle_rights,
+        test_hash_repetition_irreversible,
+        test_hash_repetition_long_game,
+        test_hash_key_init,
+        test_hash_key_incremental,
+        test_hash_key_transposition
     };
     
-    run_test_suite("Hash/Dictionary Tests", tests, 8, results);
+    run_test_suite("Hash/Repetition Tests", tests, 7, results);
 }
@@ -0,0 +1,269 @@
+#include "main.h"
+#include "helpers.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static uint32 rng_state;
+
+static int16 next_weight(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (int16)((int)(rng_state >> 24) - 128);
+}
+
+static void write_u32(uint8* dst, uint32 value) {
+    for (int i = 0; i < 4; i++) {
+        dst[i] = (uint8)(value >> (8 * i));
+    }
+}
+
+// Writes a network of pseudo random weights in the format of the weight file.
+// returns the bytes that must be freed.
+static uint8* random_network_bytes(uint32 seed) {
+    uint8* data = (uint8*)malloc(NCH_NNUE_FILE_SIZE);
+    if (!data)
+        return NULL;
+
+    rng_state = seed;
+    memcpy(data, NCH_NNUE_MAGIC, 8);
+    write_u32(data + 8, NCH_NNUE_HIDDEN);
+    write_u32(data + 12, 255);
+    write_u32(data + 16, 64);
+    write_u32(data + 20, 400);
+
+    int nweights = NCH_NNUE_FEATURES * NCH_NNUE_HIDDEN + 3 * NCH_NNUE_HIDDEN;
+    uint8* cursor = data + NCH_NNUE_HEADER_SIZE;
+    for (int i = 0; i < nweights; i++) {
+        uint16 w = (uint16)next_weight();
+        cursor[2 * i] = (uint8)w;
+        cursor[2 * i + 1] = (uint8)(w >> 8);
+    }
+    write_u32(cursor + 2 * nweights, (uint32)-1234);
+    return data;
+}
+
+static NNUENetwork* random_network(uint32 seed) {
+    uint8* data = random_network_bytes(seed);
+    NNUENetwork* net = (NNUENetwork*)malloc(sizeof(NNUENetwork));
+    if (!data || !net || NNUE_LoadFromMemory(net, data, NCH_NNUE_FILE_SIZE) != 0) {
+        free(data);
+        free(net);
+        return NULL;
+    }
+    free(data);
+    return net;
+}
+
+static int same_accumulator(const NNUEAccumulator* a, const NNUEAccumulator* b) {
+    return memcmp(a->values, b->values, sizeof(a->values)) == 0;
+}
+
+// the evaluation computed the long way from the board
+static int reference_eval(const NNUENetwork* net, const Board* board) {
+    int32 hidden[NCH_SIDES_NB][NCH_NNUE_HIDDEN];
+    for (int side = 0; side < NCH_SIDES_NB; side++) {
+        for (int i = 0; i < NCH_NNUE_HIDDEN; i++) {
+            hidden[side][i] = net->ft_biases[i];
+        }
+        for (int sqr = 0; sqr < NCH_SQUARE_NB; sqr++) {
+            Piece p = Board_ON_SQUARE(board, sqr);
+            if (p == NCH_NO_PIECE)
+                continue;
+            int theirs = Piece_SIDE(p) != side;
+            int rel_sqr = side == NCH_White ? sqr : sqr ^ 56;
+            int feature = (theirs * 6 + Piece_TYPE(p) - 1) * 64 + rel_sqr;
+            for (int i = 0; i < NCH_NNUE_HIDDEN; i++) {
+                hidden[side][i] += net->ft_weights[feature][i];
+            }
+        }
+    }
+
+    Side us = Board_SIDE(board);
+    long long sum = net->out_bias;
+    for (int i = 0; i < NCH_NNUE_HIDDEN; i++) {
+        int32 a = hidden[us][i] < 0 ? 0 : hidden[us][i] > net->qa ? net->qa : hidden[us][i];
+        int32 b = hidden[NCH_OP_SIDE(us)][i];
+        b = b < 0 ? 0 : b > net->qa ? net->qa : b;
+        sum += a * net->out_weights[i] + b * net->out_weights[NCH_NNUE_HIDDEN + i];
+    }
+    return (int)(sum * net->scale / ((long long)net->qa * net->qb));
+}
+
+// Test reading the weight file
+static int test_nnue_load(void) {
+    uint8* data = random_network_bytes(7);
+    ASSERT_NOT_NULL(data);
+    NNUENetwork* net = (NNUENetwork*)malloc(sizeof(NNUENetwork));
+    ASSERT_NOT_NULL(net);
+
+    ASSERT(NNUE_LoadFromMemory(net, data, NCH_NNUE_FILE_SIZE) == 0);
+    ASSERT_EQ(net->qa, 255);
+    ASSERT_EQ(net->qb, 64);
+    ASSERT_EQ(net->scale, 400);
+    ASSERT_EQ(net->out_bias, -1234);
+
+    rng_state = 7;
+    ASSERT_EQ(net->ft_weights[0][0], next_weight());
+    ASSERT_EQ(net->ft_weights[0][1], next_weight());
+
+    // the size, the magic and the hidden size are checked
+    ASSERT(NNUE_LoadFromMemory(net, data, NCH_NNUE_FILE_SIZE - 1) == -1);
+    data[0] = 'X';
+    ASSERT(NNUE_LoadFromMemory(net, data, NCH_NNUE_FILE_SIZE) == -1);
+    data[0] = 'N';
+    write_u32(data + 8, 512);
+    ASSERT(NNUE_LoadFromMemory(net, data, NCH_NNUE_FILE_SIZE) == -1);
+    write_u32(data + 8, NCH_NNUE_HIDDEN);
+
+    // the largest qa is fine with small output weights but not with
+    // weights that overflow the sum of a half
+    write_u32(data + 12, 32767);
+    ASSERT(NNUE_LoadFromMemory(net, data, NCH_NNUE_FILE_SIZE) == 0);
+    uint8* second_half = data + NCH_NNUE_HEADER_SIZE + 2 * (NCH_NNUE_FEATURES * NCH_NNUE_HIDDEN + 2 * NCH_NNUE_HIDDEN);
+    uint8 saved[2 * NCH_NNUE_HIDDEN];
+    memcpy(saved, second_half, sizeof(saved));
+    memset(second_half, 0x7f, sizeof(saved));
+    ASSERT(NNUE_LoadFromMemory(net, data, NCH_NNUE_FILE_SIZE) == -1);
+    write_u32(data + 12, 1);
+    ASSERT(NNUE_LoadFromMemory(net, data, NCH_NNUE_FILE_SIZE) == 0);
+    memcpy(second_half, saved, sizeof(saved));
+    write_u32(data + 12, 255);
+
+    // from a file
+    const char* path = "nnue_test_weights.bin";
+    FILE* f = fopen(path, "wb");
+    ASSERT_NOT_NULL(f);
+    ASSERT_EQ(fwrite(data, 1, NCH_NNUE_FILE_SIZE, f), NCH_NNUE_FILE_SIZE);
+    fclose(f);
+
+    NNUENetwork* loaded = (NNUENetwork*)malloc(sizeof(NNUENetwork));
+    ASSERT_NOT_NULL(loaded);
+    int res = NNUE_Load(loaded, path);
+    remove(path);
+    ASSERT(res == 0);
+    ASSERT(memcmp(loaded->ft_weights, net->ft_weights, sizeof(net->ft_weights)) == 0);
+    ASSERT(NNUE_Load(loaded, "nnue_test_missing.bin") == -2);
+
+    free(loaded);
+    free(net);
+    free(data);
+    return 1;
+}
+
+// Plays random games and checks the accumulator against a refreshed one
+// after every move and every undo.
+static int test_nnue_incremental(void) {
+    NNUENetwork* net = random_network(11);
+    ASSERT_NOT_NULL(net);
+
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    };
+
+    Board board;
+    Board_InitEmpty(&board);
+    NNUEAccumulator acc, fresh, start;
+    Move moves[256], played[64];
+    PositionInfo undo[64];
+    uint32 seed = 3;
+
+    for (int f = 0; f < 3; f++) {
+        ASSERT(Board_FromFen(fens[f], &board) == 0);
+        NNUE_Attach(&board, &acc, net);
+        start = acc;
+
+        for (int game = 0; game < 20; game++) {
+            int n = 0;
+            while (n < 64) {
+                int nmoves = Board_GenerateLegalMoves(&board, moves);
+                if (!nmoves)
+                    break;
+                seed = seed * 1664525u + 1013904223u;
+                played[n] = moves[(seed >> 16) % nmoves];
+                Board_DoMove(&board, played[n], &undo[n]);
+                n++;
+
+                NNUE_Refresh(&fresh, net, &board);
+                ASSERT(same_accumulator(&acc, &fresh));
+            }
+
+            ASSERT_EQ(NNUE_Evaluate(&acc, Board_SIDE(&board)), reference_eval(net, &board));
+
+            while (n > 0) {
+                n--;
+                Board_UndoMove(&board, played[n], &undo[n]);
+            }
+            ASSERT(same_accumulator(&acc, &start));
+        }
+    }
+
+    // the moves of the history are undone the same way
+    Board_Init(&board);
+    NNUE_Attach(&board, &acc, net);
+    start = acc;
+    ASSERT(Board_Step(&board, "e2e4"));
+    ASSERT(Board_Step(&board, "d7d5"));
+    ASSERT(Board_Step(&board, "e4d5"));
+    NNUE_Refresh(&fresh, net, &board);
+    ASSERT(same_accumulator(&acc, &fresh));
+    Board_Undo(&board);
+    Board_Undo(&board);
+    Board_Undo(&board);
+    ASSERT(same_accumulator(&acc, &start));
+
+    // the copies do not share the accumulator
+    Board copy;
+    Board_CopyPosition(&board, &copy);
+    ASSERT(copy.nnue == NULL);
+
+    NNUE_Detach(&board);
+    ASSERT(Board_Step(&board, "e2e4"));
+    ASSERT(same_accumulator(&acc, &start));
+
+    Board_FreeExtraOnly(&board);
+    free(net);
+    return 1;
+}
+
+// Test searching with the network
+static int test_nnue_search(void) {
+    NNUENetwork* net = random_network(5);
+    ASSERT_NOT_NULL(net);
+
+    Board board;
+    Board_Init(&board);
+    NNUEAccumulator acc;
+    NNUE_Attach(&board, &acc, net);
+    NNUEAccumulator before = acc;
+
+    ASSERT_EQ(Search_EvalNNUE(&board, NULL), reference_eval(net, &board));
+
+    SearchLimits limits = {4, 0, 0};
+    SearchResult result;
+    ASSERT(Board_Search(&board, &limits, NULL, NULL, NULL, &result) == 0);
+    ASSERT(Board_IsMoveLegal(&board, result.best_move));
+    ASSERT(same_accumulator(&acc, &before));
+
+    // the mates are still found
+    ASSERT(Board_FromFen("7k/8/8/8/8/8/R7/1R4K1 w - - 0 1", &board) == 0);
+    NNUE_Attach(&board, &acc, net);
+    SearchLimits mate_limits = {5, 0, 0};
+    ASSERT(Board_Search(&board, &mate_limits, NULL, NULL, NULL, &result) == 0);
+    ASSERT_EQ(result.score, NCH_SEARCH_MATE - 3);
+
+    Board_FreeExtraOnly(&board);
+    free(net);
+    return 1;
+}
+
+void test_nnue_suite(TestResults* results) {
+    TestFunc tests[] = {
+        test_nnue_load,
+        test_nnue_incremental,
+        test_nnue_search
+    };
+
+    run_test_suite("NNUE Tests", tests, 3, results);
+}
@@ -0,0 +1,133 @@
+#include "main.h"
+#include "helpers.h"
+
+// Packs the position of the fen, unpacks it to a new board and checks
+// that both boards give the same fen, key and flags.
+static int pack_roundtrip(const char* fen) {
+    Board board;
+    Board_InitEmpty(&board);
+    ASSERT(Board_FromFen(fen, &board) == 0);
+
+    PackedBoard packed;
+    ASSERT(Board_Pack(&board, &packed) == 0);
+
+    Board unpacked;
+    ASSERT(Board_Unpack(&packed, &unpacked) == 0);
+
+    char expected[NCH_FEN_MAX_LENGTH];
+    char output[NCH_FEN_MAX_LENGTH];
+    Board_AsFen(&board, expected);
+    Board_AsFen(&unpacked, output);
+
+    ASSERT_STR_EQ(output, expected);
+    ASSERT_EQ(Board_KEY(&unpacked), Board_KEY(&board));
+    ASSERT_EQ(Board_FLAGS(&unpacked), Board_FLAGS(&board));
+    ASSERT_EQ(Board_ENP_MAP(&unpacked), Board_ENP_MAP(&board));
+    for (int i = 0; i < NCH_SQUARE_NB; i++) {
+        ASSERT_EQ(Board_PIECE(&unpacked, i), Board_PIECE(&board, i));
+    }
+
+    // packing the unpacked board gives the same bytes
+    PackedBoard repacked;
+    ASSERT(Board_Pack(&unpacked, &repacked) == 0);
+    ASSERT(memcmp(&packed, &repacked, sizeof(PackedBoard)) == 0);
+
+    Board_FreeExtraOnly(&unpacked);
+    Board_FreeExtraOnly(&board);
+    return 1;
+}
+
+// Test the size of the packed board
+static int test_pack_size(void) {
+    ASSERT_EQ(sizeof(PackedBoard), NCH_PACKED_BOARD_SIZE);
+    return 1;
+}
+
+// Test packing and unpacking different positions
+static int test_pack_roundtrip(void) {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 32 16",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 10 444",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+        "rnbqkbnr/pppp1ppp/8/8/3Pp3/8/PPP1PPPP/RNBQKBNR b KQkq d3 0 3",
+        "4k3/8/8/8/8/8/8/4K2R b K - 5 40",
+        "8/8/8/8/8/8/8/8 w - - 0 1",
+    };
+
+    for (int i = 0; i < (int)(sizeof(fens) / sizeof(fens[0])); i++) {
+        if (!pack_roundtrip(fens[i]))
+            return 0;
+    }
+
+    // a position after moves keeps its counters
+    Board* board = Board_New();
+    ASSERT_NOT_NULL(board);
+    Board_Step(board, "e2e4");
+    Board_Step(board, "g8f6");
+
+    PackedBoard packed;
+    Board unpacked;
+    ASSERT(Board_Pack(board, &packed) == 0);
+    ASSERT(Board_Unpack(&packed, &unpacked) == 0);
+    ASSERT_EQ(Board_NMOVES(&unpacked), Board_NMOVES(board));
+    ASSERT_EQ(Board_FIFTY_COUNTER(&unpacked), Board_FIFTY_COUNTER(board));
+    ASSERT_EQ(Board_KEY(&unpacked), Board_KEY(board));
+
+    Board_Free(board);
+    return 1;
+}
+
+// Test that corrupted packed boards are refused
+static int test_pack_invalid(void) {
+    Board board;
+    Board_Init(&board);
+
+    PackedBoard packed;
+    ASSERT(Board_Pack(&board, &packed) == 0);
+
+    Board out;
+    PackedBoard bad;
+
+    bad = packed;
+    bad.pieces[0] = (bad.pieces[0] & 0xF0) | 13;    // no piece has the code 13
+    ASSERT(Board_Unpack(&bad, &out) == -1);
+
+    bad = packed;
+    bad.pieces[0] &= 0xF0;                          // a set square without a piece
+    ASSERT(Board_Unpack(&bad, &out) == -1);
+
+    bad = packed;
+    bad.state |= 0x80;
+    ASSERT(Board_Unpack(&bad, &out) == -1);
+
+    bad = packed;
+    bad.reserved[1] = 1;
+    ASSERT(Board_Unpack(&bad, &out) == -1);
+
+    bad = packed;
+    bad.en_passant = NCH_E4;                        // no pawn moved to e4
+    ASSERT(Board_Unpack(&bad, &out) == -1);
+
+    bad = packed;
+    bad.occupancy &= ~NCH_SQR(NCH_E2);              // leaves a code after the last piece
+    ASSERT(Board_Unpack(&bad, &out) == -1);
+
+    // more than 32 pieces could not be packed
+    Board full;
+    Board_InitEmpty(&full);
+    ASSERT(Board_FromFen("PPPPPPPP/PPPPPPPP/PPPPPPPP/PPPPPPPP/P7/8/8/8 w - - 0 1", &full) == 0);
+    ASSERT(Board_Pack(&full, &packed) == -1);
+
+    return 1;
+}
+
+void test_pack_suite(TestResults* results) {
+    TestFunc tests[] = {
+        test_pack_size,
+        test_pack_roundtrip,
+        test_pack_invalid
+    };
+
+    run_test_suite("Pack Tests", tests, 3, results);
+}
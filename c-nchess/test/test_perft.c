@@ -8,13 +8,21 @@
 #define PERFT_FAST_MODE 0
 #endif
 
+// The deep perfts of the slow mode use a hash table of subtree counts
+// so they finish in a reasonable time.
+#if PERFT_FAST_MODE
+#define PERFT_HASH_SIZE_MB 0
+#else
+#define PERFT_HASH_SIZE_MB 64
+#endif
+
 // Helper function to test perft results
 static int perft_test_helper(const char* fen, long long* expected, int depth) {
     Board* board = Board_NewFen(fen);
     ASSERT_NOT_NULL(board);
     
     for (int i = 0; i < depth; i++) {
-        long long result = Board_PerftNoPrint(board, i + 1);
+        long long result = Board_PerftWithHash(board, i + 1, PERFT_HASH_SIZE_MB, 0, NULL);
         if (result != expected[i]) {
             printf("  Depth %d: Expected %lld, got %lld\n", i + 1, expected[i], result);
             Board_Free(board);
@@ -153,6 +161,116 @@ static int test_perft_after_undo(void) {
     
     ASSERT_EQ(initial, after_undo);
     
+    Board_FreeExtraOnly(&board);
+    return 1;
+}
+
+// Test parallel perft gives the same counts as the single threaded perft
+static int test_perft_parallel(void) {
+    Board* board = Board_NewFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+    ASSERT_NOT_NULL(board);
+    
+    long long expected[] = {48, 2039, 97862, 4085603};
+    PerftThreadStats stats[4];
+    
+    for (int depth = 1; depth <= 4; depth++) {
+        ASSERT_EQ(Board_PerftParallel(board, depth, 4, 0, stats), expected[depth - 1]);
+        
+        long long nodes = 0;
+        for (int i = 0; i < 4; i++) {
+            nodes += stats[i].nodes;
+        }
+        ASSERT_EQ(nodes, expected[depth - 1]);
+    }
+    
+    // one thread and a shared hash table
+    ASSERT_EQ(Board_PerftParallel(board, 4, 1, 0, NULL), expected[3]);
+    ASSERT_EQ(Board_PerftParallel(board, 4, 4, 16, NULL), expected[3]);
+    
+    // the per move counts match the single threaded divide
+    Move moves[256], pmoves[256];
+    long long counts[256], pcounts[256];
+    int n = Board_PerftAndGetMoves(board, 3, moves, counts, 256);
+    int pn = Board_PerftParallelAndGetMoves(board, 3, 3, 1, pmoves, pcounts, 256, NULL);
+    ASSERT_EQ(n, pn);
+    for (int i = 0; i < n; i++) {
+        ASSERT(moves[i] == pmoves[i]);
+        ASSERT_EQ(counts[i], pcounts[i]);
+    }
+    
+    Board_Free(board);
+    return 1;
+}
+
+// Test hashed perft gives the same counts as the plain perft
+static int test_perft_hashed(void) {
+    Board* board = Board_NewFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - ");
+    ASSERT_NOT_NULL(board);
+    
+    long long expected[] = {48, 2039, 97862, 4085603, 193690690};
+    for (int depth = 1; depth <= 5; depth++) {
+        ASSERT_EQ(Board_PerftWithHash(board, depth, 16, 0, NULL), expected[depth - 1]);
+    }
+    
+    // a tiny table is replaced all the time but must still be correct
+    ASSERT_EQ(Board_PerftWithHash(board, 4, 1, 0, NULL), expected[3]);
+    
+    Board_Free(board);
+    return 1;
+}
+
+typedef struct {
+    Move moves[256];
+    long long counts[256];
+    int n;
+} DivideResult;
+
+static void divide_collect(Move move, long long count, void* ctx) {
+    DivideResult* res = (DivideResult*)ctx;
+    res->moves[res->n] = move;
+    res->counts[res->n] = count;
+    res->n++;
+}
+
+// Test streaming divide
+static int test_perft_divide(void) {
+    Board* board = Board_New();
+    ASSERT_NOT_NULL(board);
+    
+    DivideResult res;
+    res.n = 0;
+    long long total = Board_PerftDivide(board, 3, 1, divide_collect, &res);
+    ASSERT_EQ(total, 8902);
+    ASSERT_EQ(res.n, 20);
+    
+    Move moves[256];
+    long long counts[256];
+    int n = Board_PerftAndGetMoves(board, 3, moves, counts, 256);
+    ASSERT_EQ(n, res.n);
+    for (int i = 0; i < n; i++) {
+        ASSERT(moves[i] == res.moves[i]);
+        ASSERT_EQ(counts[i], res.counts[i]);
+    }
+    
+    FILE* f = tmpfile();
+    ASSERT_NOT_NULL(f);
+    ASSERT_EQ(Board_PerftDivideToFile(board, 2, 0, f), 400);
+    rewind(f);
+    
+    char move_str[16];
+    long long count, sum = 0;
+    int lines = 0;
+    while (fscanf(f, "%15s %lld", move_str, &count) == 2 && strcmp(move_str, "total")) {
+        sum += count;
+        lines++;
+    }
+    ASSERT_EQ(lines, 20);
+    ASSERT_EQ(sum, 400);
+    ASSERT(!strcmp(move_str, "total"));
+    ASSERT_EQ(count, 400);
+    fclose(f);
+    
+    Board_Free(board);
     return 1;
 }
 
@@ -169,8 +287,11 @@ void test_perft_suite(TestResults* results) {
         test_perft_depth1_positions,
         test_perft_with_print,
         test_perft_consistency,
-        test_perft_after_undo
+        test_perft_after_undo,
+        test_perft_parallel,
+        test_perft_hashed,
+        test_perft_divide
     };
     
-    run_test_suite("Perft Tests", tests, 11, results);
+    run_test_suite("Perft Tests", tests, 14, results);
 }
\ No newline at end of file
@@ -0,0 +1,322 @@
+#include "main.h"
+#include "helpers.h"
+
+// Reads the SAN on the board of the fen and checks the UCI of the move
+static int san_is(const char* fen, const char* san, const char* uci) {
+    Board board;
+    Board_InitEmpty(&board);
+    ASSERT(Board_FromFen(fen, &board) == 0);
+
+    Move move;
+    ASSERT(Board_MoveFromSAN(&board, san, (int)strlen(san), &move) == 0);
+
+    char out[8];
+    ASSERT(Move_AsString(move, out) == 0);
+    ASSERT_STR_EQ(out, uci);
+    return 1;
+}
+
+static int san_fails(const char* fen, const char* san) {
+    Board board;
+    Board_InitEmpty(&board);
+    ASSERT(Board_FromFen(fen, &board) == 0);
+
+    Move move;
+    ASSERT(Board_MoveFromSAN(&board, san, (int)strlen(san), &move) == -1);
+    return 1;
+}
+
+// Test reading SAN moves
+static int test_san_parse(void) {
+    const char* start = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    const char* kiwipete = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+    if (!san_is(start, "e4", "e2e4")) return 0;
+    if (!san_is(start, "Nf3", "g1f3")) return 0;
+    if (!san_is(start, "Nf3!?", "g1f3")) return 0;
+    if (!san_is(kiwipete, "O-O", "e1g1")) return 0;
+    if (!san_is(kiwipete, "0-0-0", "e1c1")) return 0;
+    if (!san_is(kiwipete, "Qxf6", "f3f6")) return 0;
+    if (!san_is(kiwipete, "Nxf7", "e5f7")) return 0;
+    if (!san_is(kiwipete, "dxe6", "d5e6")) return 0;
+    if (!san_is(kiwipete, "gxh3", "g2h3")) return 0;
+
+    // disambiguation by file, rank and square
+    if (!san_is("4k3/8/8/8/8/8/4K3/R6R w - - 0 1", "Rad1", "a1d1")) return 0;
+    if (!san_is("4k3/8/8/8/8/8/4K3/R6R w - - 0 1", "Rhf1", "h1f1")) return 0;
+    if (!san_is("4k3/8/8/R7/8/8/8/R3K3 w - - 0 1", "R1a3", "a1a3")) return 0;
+    if (!san_is("4k3/8/8/R7/8/8/8/R3K3 w - - 0 1", "R5a3", "a5a3")) return 0;
+    if (!san_is("4k3/8/8/8/8/2Q1Q3/8/2Q1K3 w - - 0 1", "Qc3d2", "c3d2")) return 0;
+    if (!san_fails("4k3/8/8/8/8/8/4K3/R6R w - - 0 1", "Rd1")) return 0;
+
+    // promotions and en passant
+    if (!san_is("8/P6k/8/8/8/8/8/K7 w - - 0 1", "a8=Q", "a7a8q")) return 0;
+    if (!san_is("8/P6k/8/8/8/8/8/K7 w - - 0 1", "a8N+", "a7a8n")) return 0;
+    if (!san_is("1r5k/P7/8/8/8/8/8/K7 w - - 0 1", "axb8=R", "a7b8r")) return 0;
+    if (!san_fails("8/P6k/8/8/8/8/8/K7 w - - 0 1", "a8")) return 0;
+    if (!san_is("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", "exf6", "e5f6")) return 0;
+
+    // a pawn push is not a capture
+    if (!san_fails("4k3/8/8/8/4p3/3P4/8/4K3 w - - 0 1", "e4")) return 0;
+    if (!san_is("4k3/8/8/8/4p3/3P4/8/4K3 w - - 0 1", "dxe4", "d3e4")) return 0;
+
+    // not moves of the board
+    if (!san_fails(start, "e5")) return 0;
+    if (!san_fails(start, "Ke2")) return 0;
+    if (!san_fails(start, "O-O")) return 0;
+    if (!san_fails(start, "xyz")) return 0;
+    if (!san_fails(start, "")) return 0;
+
+    return 1;
+}
+
+// Writes the SAN of a UCI move on the board of the fen and checks it
+static int san_written(const char* fen, const char* uci, const char* san) {
+    Board board;
+    Board_InitEmpty(&board);
+    ASSERT(Board_FromFen(fen, &board) == 0);
+
+    Move move;
+    ASSERT(Move_FromString(uci, &move));
+
+    char out[NCH_SAN_MAX_LENGTH];
+    ASSERT(Move_AsSAN(&board, move, out) == 0);
+    ASSERT_STR_EQ(out, san);
+    return 1;
+}
+
+// Every legal move written by Board_MovesAsSAN must be read back to itself
+static int san_round_trip(const char* fen) {
+    Board board;
+    Board_InitEmpty(&board);
+    ASSERT(Board_FromFen(fen, &board) == 0);
+
+    Move moves[256];
+    char sans[256 * NCH_SAN_MAX_LENGTH];
+    int nmoves = Board_GenerateLegalMoves(&board, moves);
+    ASSERT(Board_MovesAsSAN(&board, moves, nmoves, sans) == 0);
+
+    for (int i = 0; i < nmoves; i++) {
+        const char* san = sans + i * NCH_SAN_MAX_LENGTH;
+        Move move;
+        ASSERT(Board_MoveFromSAN(&board, san, (int)strlen(san), &move) == 0);
+        ASSERT_EQ(move, moves[i]);
+    }
+    return 1;
+}
+
+// Test writing SAN moves
+static int test_san_write(void) {
+    const char* start = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    const char* kiwipete = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+    if (!san_written(start, "e2e4", "e4")) return 0;
+    if (!san_written(start, "g1f3", "Nf3")) return 0;
+    if (!san_written(kiwipete, "e1g1", "O-O")) return 0;
+    if (!san_written(kiwipete, "e1c1", "O-O-O")) return 0;
+    if (!san_written(kiwipete, "f3f6", "Qxf6")) return 0;
+    if (!san_written(kiwipete, "e5f7", "Nxf7")) return 0;
+    if (!san_written(kiwipete, "g2h3", "gxh3")) return 0;
+    if (!san_written("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", "e5f6", "exf6")) return 0;
+
+    // disambiguation by file, rank and square
+    if (!san_written("4k3/8/8/8/8/8/4K3/R6R w - - 0 1", "a1d1", "Rad1")) return 0;
+    if (!san_written("4k3/8/8/R7/8/8/8/R3K3 w - - 0 1", "a1a3", "R1a3")) return 0;
+    if (!san_written("k7/8/8/8/8/2Q1Q3/8/2Q1K3 w - - 0 1", "c3d2", "Qc3d2")) return 0;
+    if (!san_written("k7/8/8/8/8/2Q1Q3/8/2Q1K3 w - - 0 1", "e3d2", "Qed2")) return 0;
+
+    // a pinned piece does not need to be told apart
+    if (!san_written("4k3/8/8/8/1b6/8/3N4/4K1N1 w - - 0 1", "g1f3", "Nf3")) return 0;
+
+    // promotions, checks and mates
+    if (!san_written("8/P6k/8/8/8/8/8/K7 w - - 0 1", "a7a8q", "a8=Q")) return 0;
+    if (!san_written("8/P6k/8/8/8/8/8/K7 w - - 0 1", "a7a8n", "a8=N")) return 0;
+    if (!san_written("1r5k/P7/8/8/8/8/8/K7 w - - 0 1", "a7b8r", "axb8=R+")) return 0;
+    if (!san_written("rnbqkbnr/pppp1ppp/8/4p3/6P1/5P2/PPPPP2P/RNBQKBNR b KQkq - 0 2", "d8h4", "Qh4#")) return 0;
+
+    // not legal
+    Board board;
+    Board_Init(&board);
+    char out[NCH_SAN_MAX_LENGTH];
+    Move move;
+    ASSERT(Move_FromString("e2e5", &move));
+    ASSERT(Move_AsSAN(&board, move, out) == -1);
+    ASSERT_STR_EQ(out, "");
+    Board_FreeExtraOnly(&board);
+
+    if (!san_round_trip(start)) return 0;
+    if (!san_round_trip(kiwipete)) return 0;
+    if (!san_round_trip("k7/8/8/8/8/2Q1Q3/8/2Q1K3 w - - 0 1")) return 0;
+    if (!san_round_trip("r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1")) return 0;
+
+    return 1;
+}
+
+// Test writing the SAN of the moves of a game
+static int test_san_line(void) {
+    const char* uci[] = {"e2e4", "e7e5", "f1c4", "b8c6", "d1h5", "g8f6", "h5f7"};
+    const char* san[] = {"e4", "e5", "Bc4", "Nc6", "Qh5", "Nf6", "Qxf7#"};
+    int nmoves = 7;
+
+    Move moves[7];
+    for (int i = 0; i < nmoves; i++) {
+        ASSERT(Move_FromString(uci[i], &moves[i]));
+    }
+
+    Board board;
+    Board_Init(&board);
+    uint64 key = Board_KEY(&board);
+
+    char out[7 * NCH_SAN_MAX_LENGTH];
+    ASSERT_EQ(Board_LineAsSAN(&board, moves, nmoves, out), nmoves);
+    for (int i = 0; i < nmoves; i++) {
+        ASSERT_STR_EQ(out + i * NCH_SAN_MAX_LENGTH, san[i]);
+    }
+
+    // the board is not changed
+    ASSERT_EQ(Board_KEY(&board), key);
+    ASSERT_EQ(Board_NMOVES(&board), 0);
+
+    // it stops at the first move that is not legal
+    moves[3] = moves[2];
+    ASSERT_EQ(Board_LineAsSAN(&board, moves, nmoves, out), 3);
+
+    Board_FreeExtraOnly(&board);
+    return 1;
+}
+
+static const char* PGN_TEXT =
+    "[Event \"Test \\\"quoted\\\"\"]\n"
+    "[Site \"?\"]\n"
+    "[Result \"1-0\"]\n"
+    "\n"
+    "1. e4 e5 2. Nf3 {a comment (with parentheses)} Nc6 (2... d6 3. d4) 3. Bb5 a6\n"
+    "; a line comment\n"
+    "4. Ba4 $1 Nf6 5. O-O Be7 6.Re1 b5 7. Bb3 d6 8. c3 O-O 1-0\n"
+    "\n"
+    "[Event \"Second\"]\n"
+    "[FEN \"4k3/8/8/8/8/8/4P3/4K3 w - - 0 1\"]\n"
+    "[SetUp \"1\"]\n"
+    "\n"
+    "1. e4 Kd7 2. e5 Ke6 *\n"
+    "\n"
+    "[Event \"Broken\"]\n"
+    "\n"
+    "1. e4 e5 2. Ke3 Nc6 0-1\n"
+    "1. d4 d5 1/2-1/2\n";
+
+static int count_moves(const Board* board, Move move, void* arg) {
+    (void)board;
+    (void)move;
+    (*(int*)arg)++;
+    return 0;
+}
+
+// Test finding games, reading tags and replaying the moves
+static int test_pgn_games(void) {
+    size_t len = strlen(PGN_TEXT);
+    PGNGame game;
+    PGNTag tag;
+    Board board;
+    Board_Init(&board);
+    char fen[NCH_FEN_MAX_LENGTH];
+    int nmoves;
+
+    // first game
+    size_t pos = PGN_NextGame(PGN_TEXT, len, 0, &game);
+    ASSERT_NOT_NULL(game.start);
+    ASSERT(PGN_FindTag(&game, "Event", &tag));
+    ASSERT_EQ(tag.value_len, 15);
+    ASSERT(memcmp(tag.value, "Test \\\"quoted\\\"", 15) == 0);
+    ASSERT(PGN_FindTag(&game, "Result", &tag));
+    ASSERT(!PGN_FindTag(&game, "FEN", &tag));
+
+    nmoves = 0;
+    ASSERT_EQ(PGN_PlayGame(&game, &board, count_moves, &nmoves), 0);
+    ASSERT_EQ(nmoves, 16);
+    Board_AsFen(&board, fen);
+    ASSERT_STR_EQ(fen, "r1bq1rk1/2p1bppp/p1np1n2/1p2p3/4P3/1BP2N2/PP1P1PPP/RNBQR1K1 w - - 1 9");
+
+    // second game starts from its FEN tag
+    pos = PGN_NextGame(PGN_TEXT, len, pos, &game);
+    ASSERT_NOT_NULL(game.start);
+    ASSERT_EQ(PGN_PlayGame(&game, &board, NULL, NULL), 0);
+    Board_AsFen(&board, fen);
+    ASSERT_STR_EQ(fen, "8/8/4k3/4P3/8/8/8/4K3 w - - 1 3");
+
+    // third game has an illegal move
+    pos = PGN_NextGame(PGN_TEXT, len, pos, &game);
+    ASSERT_NOT_NULL(game.start);
+    nmoves = 0;
+    ASSERT_EQ(PGN_PlayGame(&game, &board, count_moves, &nmoves), -1);
+    ASSERT_EQ(nmoves, 2);
+
+    // fourth game has no tags
+    pos = PGN_NextGame(PGN_TEXT, len, pos, &game);
+    ASSERT_NOT_NULL(game.start);
+    ASSERT(game.start == game.movetext);
+    ASSERT_EQ(PGN_PlayGame(&game, &board, NULL, NULL), 0);
+
+    pos = PGN_NextGame(PGN_TEXT, len, pos, &game);
+    ASSERT_NULL(game.start);
+    ASSERT_EQ(pos, len);
+
+    Board_FreeExtraOnly(&board);
+    return 1;
+}
+
+// Test reading many games with one thread and with many threads
+static int test_pgn_read_games(void) {
+    size_t text_len = strlen(PGN_TEXT);
+    int copies = 4000;
+    size_t len = text_len * copies;
+    char* buffer = (char*)malloc(len);
+    ASSERT_NOT_NULL(buffer);
+    for (int i = 0; i < copies; i++) {
+        memcpy(buffer + i * text_len, PGN_TEXT, text_len);
+    }
+
+    PGNGames single, multi;
+    ASSERT(PGN_ReadGames(buffer, len, 1, 1, &single) == 0);
+    ASSERT(PGN_ReadGames(buffer, len, 1, 4, &multi) == 0);
+
+    ASSERT_EQ(single.ngames, 4 * copies);
+    ASSERT_EQ(multi.ngames, single.ngames);
+    ASSERT_EQ(single.offsets[single.ngames], (16 + 4 + 2 + 2) * copies);
+
+    for (long long i = 0; i < single.ngames; i++) {
+        ASSERT_EQ(multi.status[i], single.status[i]);
+        ASSERT_EQ(multi.offsets[i], single.offsets[i]);
+        ASSERT(multi.games[i].start == single.games[i].start);
+    }
+    ASSERT_EQ(single.status[0], 0);
+    ASSERT_EQ(single.status[2], -1);
+    ASSERT(memcmp(single.moves, multi.moves, single.offsets[single.ngames] * sizeof(Move)) == 0);
+
+    long long npositions = single.offsets[single.ngames] + single.ngames;
+    ASSERT(memcmp(single.positions, multi.positions, npositions * sizeof(PackedBoard)) == 0);
+
+    // the last position of the second game
+    Board board;
+    char fen[NCH_FEN_MAX_LENGTH];
+    ASSERT(Board_Unpack(&single.positions[single.offsets[2] + 1], &board) == 0);
+    Board_AsFen(&board, fen);
+    ASSERT_STR_EQ(fen, "8/8/4k3/4P3/8/8/8/4K3 w - - 1 3");
+
+    PGNGames_Free(&single);
+    PGNGames_Free(&multi);
+    free(buffer);
+    return 1;
+}
+
+void test_pgn_suite(TestResults* results) {
+    TestFunc tests[] = {
+        test_san_parse,
+        test_san_write,
+        test_san_line,
+        test_pgn_games,
+        test_pgn_read_games
+    };
+
+    run_test_suite("PGN Tests", tests, 5, results);
+}
@@ -0,0 +1,160 @@
+#include "main.h"
+#include "helpers.h"
+
+// the scores of the board computed the long way from its piece table
+static int same_scores_as_computed(const Board* board) {
+    int material[NCH_SIDES_NB] = {0, 0};
+    int phase = 0;
+    Score psqt = 0;
+    for (int sqr = 0; sqr < NCH_SQUARE_NB; sqr++) {
+        Piece p = Board_ON_SQUARE(board, sqr);
+        if (p == NCH_NO_PIECE)
+            continue;
+        material[Piece_SIDE(p)] += PSQTMaterial[p];
+        phase += PSQTPhase[p];
+        psqt += PSQTScores[p][sqr];
+    }
+
+    return Board_MATERIAL(board, NCH_White) == material[NCH_White]
+        && Board_MATERIAL(board, NCH_Black) == material[NCH_Black]
+        && Board_PHASE(board) == phase
+        && Board_PSQT(board) == psqt;
+}
+
+// Test the scores of the boards set from scratch
+static int test_psqt_init(void) {
+    Board board;
+    Board_Init(&board);
+
+    ASSERT_EQ(Board_MATERIAL(&board, NCH_White), 4000);
+    ASSERT_EQ(Board_MATERIAL(&board, NCH_Black), 4000);
+    ASSERT_EQ(Board_PHASE(&board), NCH_PSQT_PHASE_MAX);
+    ASSERT_EQ(Board_PSQT(&board), 0);
+    ASSERT_EQ(Board_PSQTScore(&board), 0);
+
+    // the same position from a fen and from a packed board
+    Board* fen_board = Board_NewFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    ASSERT_NOT_NULL(fen_board);
+    ASSERT(same_scores_as_computed(fen_board));
+    ASSERT_EQ(Board_PHASE(fen_board), NCH_PSQT_PHASE_MAX);
+
+    PackedBoard packed;
+    Board unpacked;
+    ASSERT(Board_Pack(fen_board, &packed) == 0);
+    ASSERT(Board_Unpack(&packed, &unpacked) == 0);
+    ASSERT(same_scores_as_computed(&unpacked));
+    ASSERT_EQ(Board_PSQT(&unpacked), Board_PSQT(fen_board));
+
+    Board_InitEmpty(&board);
+    ASSERT_EQ(Board_MATERIAL(&board, NCH_White), 0);
+    ASSERT_EQ(Board_PHASE(&board), 0);
+    ASSERT_EQ(Board_PSQT(&board), 0);
+
+    // the packing of the two halves keeps their signs
+    Score s = Score_NEW(-37, 12) - Score_NEW(5, -40);
+    ASSERT_EQ(Score_MG(s), -42);
+    ASSERT_EQ(Score_EG(s), 52);
+
+    Board_Free(fen_board);
+    Board_FreeExtraOnly(&board);
+    return 1;
+}
+
+// Plays random games and checks the scores against the ones computed from
+// the pieces after every move and every undo.
+static int test_psqt_incremental(void) {
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    };
+
+    Board board;
+    Board_InitEmpty(&board);
+    Move moves[256], played[64];
+    PositionInfo undo[64];
+    uint32 seed = 5;
+
+    for (int f = 0; f < 3; f++) {
+        ASSERT(Board_FromFen(fens[f], &board) == 0);
+        Board start;
+        Board_CopyPosition(&board, &start);
+
+        for (int game = 0; game < 50; game++) {
+            int n = 0;
+            while (n < 64) {
+                int nmoves = Board_GenerateLegalMoves(&board, moves);
+                if (!nmoves)
+                    break;
+                seed = seed * 1664525u + 1013904223u;
+                played[n] = moves[(seed >> 16) % nmoves];
+                Board_DoMove(&board, played[n], &undo[n]);
+                n++;
+                ASSERT(same_scores_as_computed(&board));
+            }
+
+            while (n > 0) {
+                n--;
+                Board_UndoMove(&board, played[n], &undo[n]);
+            }
+            ASSERT(same_scores_as_computed(&board));
+            ASSERT_EQ(Board_PSQT(&board), Board_PSQT(&start));
+        }
+    }
+
+    // the moves of the history are undone the same way
+    Board_Init(&board);
+    ASSERT(Board_Step(&board, "e2e4"));
+    ASSERT(Board_Step(&board, "d7d5"));
+    ASSERT(Board_Step(&board, "e4d5"));
+    ASSERT_EQ(Board_MATERIAL(&board, NCH_Black), 3900);
+    ASSERT(same_scores_as_computed(&board));
+    Board_Undo(&board);
+    Board_Undo(&board);
+    Board_Undo(&board);
+    ASSERT_EQ(Board_PSQT(&board), 0);
+    ASSERT_EQ(Board_MATERIAL(&board, NCH_Black), 4000);
+
+    Board_FreeExtraOnly(&board);
+    return 1;
+}
+
+// Test a position and the same position with the colors swapped have the
+// opposite scores
+static int test_psqt_mirror(void) {
+    Board* board = Board_NewFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    Board* mirror = Board_NewFen("r3k2r/pppbbppp/2n2q1P/1P2p3/3pn3/BN2PNP1/P1PPQPB1/R3K2R b KQkq - 0 1");
+    ASSERT_NOT_NULL(board);
+    ASSERT_NOT_NULL(mirror);
+
+    ASSERT_EQ(Board_MATERIAL(board, NCH_White), Board_MATERIAL(mirror, NCH_Black));
+    ASSERT_EQ(Board_MATERIAL(board, NCH_Black), Board_MATERIAL(mirror, NCH_White));
+    ASSERT_EQ(Board_PSQT(board), -Board_PSQT(mirror));
+    ASSERT_EQ(Board_PSQTScore(board), -Board_PSQTScore(mirror));
+    ASSERT_EQ(Search_EvalPSQT(board, NULL), Search_EvalPSQT(mirror, NULL));
+
+    // a knight in the center is better than in the corner
+    Board* center = Board_NewFen("4k3/8/8/8/3N4/8/8/4K3 w - - 0 1");
+    Board* corner = Board_NewFen("4k3/8/8/8/8/8/8/N3K3 w - - 0 1");
+    ASSERT_NOT_NULL(center);
+    ASSERT_NOT_NULL(corner);
+    ASSERT(Board_PSQTScore(center) > Board_PSQTScore(corner));
+    ASSERT_EQ(Search_EvalMaterial(center, NULL), 320);
+
+    Board_Free(board);
+    Board_Free(mirror);
+    Board_Free(center);
+    Board_Free(corner);
+    return 1;
+}
+
+// Test suite runner
+void test_psqt_suite(TestResults* results) {
+    TestFunc tests[] = {
+        test_psqt_init,
+        test_psqt_incremental,
+        test_psqt_mirror
+    };
+
+    run_test_suite("PSQT Tests", tests, 3, results);
+}
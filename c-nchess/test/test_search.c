@@ -0,0 +1,175 @@
+#include "main.h"
+#include "helpers.h"
+
+// Searches the position of the fen to the depth, without and with a
+// transposition table, and checks the best move and the score.
+// uci could be NULL and score could be 0 to skip them.
+static int search_finds(const char* fen, int depth, const char* uci, int score) {
+    Board board;
+    Board_InitEmpty(&board);
+    ASSERT(Board_FromFen(fen, &board) == 0);
+
+    TransTable tt;
+    ASSERT(TT_Init(&tt, 1) == 0);
+
+    for (int i = 0; i < 2; i++) {
+        SearchLimits limits = {depth, 0, 0};
+        SearchResult result;
+        ASSERT(Board_Search(&board, &limits, i ? &tt : NULL, NULL, NULL, &result) == 0);
+
+        ASSERT(Board_IsMoveLegal(&board, result.best_move));
+        if (uci) {
+            char out[8];
+            ASSERT(Move_AsString(result.best_move, out) == 0);
+            ASSERT_STR_EQ(out, uci);
+        }
+        ASSERT_EQ(result.pv[0], result.best_move);
+        ASSERT(result.pv_len >= 1);
+        if (score) {
+            ASSERT_EQ(result.score, score);
+        }
+    }
+
+    TT_Free(&tt);
+    Board_FreeExtraOnly(&board);
+    return 1;
+}
+
+// Test finding mates and winning material
+static int test_search_moves(void) {
+    // mate in one
+    if (!search_finds("r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4",
+                      3, "h5f7", NCH_SEARCH_MATE - 1)) return 0;
+
+    // mate in two with two rooks
+    if (!search_finds("7k/8/8/8/8/8/R7/1R4K1 w - - 0 1", 5, NULL, NCH_SEARCH_MATE - 3)) return 0;
+
+    // mated in two whatever is played
+    if (!search_finds("7k/R7/1R6/8/8/8/8/6K1 b - - 0 1", 4, NULL, -NCH_SEARCH_MATE + 2)) return 0;
+
+    // a hanging queen is taken
+    if (!search_finds("4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1", 4, "d2d5", 0)) return 0;
+
+    return 1;
+}
+
+// Test the positions without legal moves
+static int test_search_finished(void) {
+    SearchResult result;
+    Board board;
+    Board_InitEmpty(&board);
+
+    // mate
+    ASSERT(Board_FromFen("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3", &board) == 0);
+    ASSERT(Board_Search(&board, NULL, NULL, NULL, NULL, &result) == 1);
+    ASSERT_EQ(result.best_move, 0);
+    ASSERT_EQ(result.score, -NCH_SEARCH_MATE);
+
+    // stalemate
+    ASSERT(Board_FromFen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1", &board) == 0);
+    ASSERT(Board_Search(&board, NULL, NULL, NULL, NULL, &result) == 1);
+    ASSERT_EQ(result.best_move, 0);
+    ASSERT_EQ(result.score, 0);
+
+    Board_FreeExtraOnly(&board);
+    return 1;
+}
+
+static int count_evals(const Board* board, void* arg) {
+    (*(long long*)arg)++;
+    return Search_EvalMaterial(board, NULL);
+}
+
+// Test the limits and the evaluation callback
+static int test_search_limits(void) {
+    Board board;
+    Board_Init(&board);
+    uint64 key = Board_KEY(&board);
+
+    // the nodes limit stops the search after the first iteration
+    SearchLimits limits = {20, 0, 5000};
+    SearchResult result;
+    long long nevals = 0;
+    ASSERT(Board_Search(&board, &limits, NULL, count_evals, &nevals, &result) == 0);
+    ASSERT(result.depth >= 1 && result.depth < 20);
+    ASSERT(result.nodes <= 5000 + 1);
+    ASSERT(nevals > 0);
+    ASSERT(Board_IsMoveLegal(&board, result.best_move));
+
+    // the time limit
+    SearchLimits timed = {0, 0.05, 0};
+    ASSERT(Board_Search(&board, &timed, NULL, NULL, NULL, &result) == 0);
+    ASSERT(result.depth >= 1);
+    ASSERT(result.seconds < 0.5);
+
+    // the board is not changed
+    ASSERT_EQ(Board_KEY(&board), key);
+    ASSERT_EQ(Board_NMOVES(&board), 0);
+
+    Board_FreeExtraOnly(&board);
+    return 1;
+}
+
+// Test searching with many threads and reusing the pool
+static int test_search_pool(void) {
+    SearchPool* pool = SearchPool_New(4);
+    ASSERT(pool != NULL);
+    ASSERT_EQ(SearchPool_Threads(pool), 4);
+
+    TransTable tt;
+    ASSERT(TT_Init(&tt, 1) == 0);
+
+    Board board;
+    Board_InitEmpty(&board);
+    SearchLimits limits = {5, 0, 0};
+    SearchResult result;
+    SearchThreadStats stats[4];
+
+    // the same mate as a single thread
+    ASSERT(Board_FromFen("7k/8/8/8/8/8/R7/1R4K1 w - - 0 1", &board) == 0);
+    ASSERT(SearchPool_Search(pool, &board, &limits, &tt, NULL, NULL, &result, stats) == 0);
+    ASSERT_EQ(result.score, NCH_SEARCH_MATE - 3);
+    ASSERT(Board_IsMoveLegal(&board, result.best_move));
+
+    long long nodes = 0;
+    for (int i = 0; i < 4; i++) {
+        nodes += stats[i].nodes;
+        ASSERT(stats[i].depth <= 5);
+    }
+    ASSERT_EQ(result.nodes, nodes);
+    ASSERT(stats[0].depth >= 1);
+
+    // the threads wait for the next search and the limits still stop it
+    ASSERT(Board_FromFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", &board) == 0);
+    SearchLimits timed = {0, 0.1, 0};
+    ASSERT(SearchPool_Search(pool, &board, &timed, &tt, NULL, NULL, &result, NULL) == 0);
+    ASSERT(result.depth >= 1);
+    ASSERT(result.seconds < 1.0);
+    ASSERT(Board_IsMoveLegal(&board, result.best_move));
+
+    SearchLimits counted = {0, 0, 20000};
+    ASSERT(SearchPool_Search(pool, &board, &counted, NULL, NULL, NULL, &result, stats) == 0);
+    ASSERT(result.depth >= 1);
+    ASSERT(Board_IsMoveLegal(&board, result.best_move));
+
+    // a finished board
+    ASSERT(Board_FromFen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1", &board) == 0);
+    ASSERT(SearchPool_Search(pool, &board, &limits, &tt, NULL, NULL, &result, stats) == 1);
+    ASSERT_EQ(result.best_move, 0);
+
+    TT_Free(&tt);
+    SearchPool_Free(pool);
+    Board_FreeExtraOnly(&board);
+    return 1;
+}
+
+void test_search_suite(TestResults* results) {
+    TestFunc tests[] = {
+        test_search_moves,
+        test_search_finished,
+        test_search_limits,
+        test_search_pool
+    };
+
+    run_test_suite("Search Tests", tests, 4, results);
+}
@@ -0,0 +1,139 @@
+#include "main.h"
+#include "helpers.h"
+
+// Test storing and probing entries
+static int test_tt_store_probe(void) {
+    TransTable tt;
+    ASSERT(TT_Init(&tt, 1) == 0);
+    ASSERT_EQ(sizeof(TTCluster), 64);
+    ASSERT_EQ(((uintptr_t)tt.clusters) % 64, 0);
+    ASSERT_EQ((tt.mask + 1) * sizeof(TTCluster), 1024 * 1024);
+
+    TTData data;
+    uint64 key = 0x123456789ABCDEF0ULL;
+    ASSERT(!TT_Probe(&tt, key, &data));
+
+    TT_Store(&tt, key, 0xABCDEF, 7, TT_BOUND_LOWER);
+    ASSERT(TT_Probe(&tt, key, &data));
+    ASSERT_EQ(TTData_PAYLOAD(data), 0xABCDEF);
+    ASSERT_EQ(TTData_DEPTH(data), 7);
+    ASSERT_EQ(TTData_BOUND(data), TT_BOUND_LOWER);
+    ASSERT_EQ(TTData_GENERATION(data), 0);
+
+    // the same key is replaced
+    TT_Store(&tt, key, 42, 3, TT_BOUND_EXACT);
+    ASSERT(TT_Probe(&tt, key, &data));
+    ASSERT_EQ(TTData_PAYLOAD(data), 42);
+    ASSERT_EQ(TTData_DEPTH(data), 3);
+
+    // a key of the same cluster is not found
+    ASSERT(!TT_Probe(&tt, key ^ (1ULL << 63), &data));
+
+    // an entry whose key and data do not match is a miss
+    TTEntry* entry = &tt.clusters[key & tt.mask].entries[0];
+    entry->data ^= 1;
+    ASSERT(!TT_Probe(&tt, key, &data));
+
+    TT_Clear(&tt);
+    ASSERT(!TT_Probe(&tt, key, &data));
+
+    TT_Free(&tt);
+    return 1;
+}
+
+// Test the replacement of a full cluster and the generations
+static int test_tt_replace(void) {
+    TransTable tt;
+    ASSERT(TT_Init(&tt, 1) == 0);
+
+    // keys of the same cluster
+    uint64 base = 5;
+    uint64 step = tt.mask + 1;
+    TTData data;
+
+    for (int i = 0; i < NCH_TT_CLUSTER_SIZE; i++) {
+        TT_Store(&tt, base + step * i, i, 10 + i, TT_BOUND_EXACT);
+    }
+    for (int i = 0; i < NCH_TT_CLUSTER_SIZE; i++) {
+        ASSERT(TT_Probe(&tt, base + step * i, &data));
+    }
+
+    // the shallowest entry is replaced
+    TT_Store(&tt, base + step * 10, 0, 20, TT_BOUND_EXACT);
+    ASSERT(!TT_Probe(&tt, base, &data));
+    ASSERT(TT_Probe(&tt, base + step * 10, &data));
+    ASSERT(TT_Probe(&tt, base + step, &data));
+
+    // after some generations the deep old entries are replaced first
+    for (int i = 0; i < 4; i++) {
+        TT_NewSearch(&tt);
+    }
+    TT_Store(&tt, base + step * 11, 0, 12, TT_BOUND_EXACT);
+    TT_Store(&tt, base + step * 12, 0, 1, TT_BOUND_EXACT);
+    ASSERT(TT_Probe(&tt, base + step * 11, &data));
+    ASSERT(TT_Probe(&tt, base + step * 12, &data));
+    ASSERT_EQ(TTData_GENERATION(data), 4);
+
+    TT_Free(&tt);
+    return 1;
+}
+
+// Test the hashfull metric
+static int test_tt_hashfull(void) {
+    TransTable tt;
+    ASSERT(TT_Init(&tt, 1) == 0);
+    ASSERT_EQ(TT_Hashfull(&tt), 0);
+
+    // fill the first half of the entries of the counted clusters
+    for (uint64 i = 0; i < 250; i++) {
+        TT_Store(&tt, i, 1, 1, TT_BOUND_EXACT);
+        TT_Store(&tt, i + tt.mask + 1, 1, 1, TT_BOUND_EXACT);
+    }
+    ASSERT_EQ(TT_Hashfull(&tt), 500);
+
+    // the entries of an old generation are not counted
+    TT_NewSearch(&tt);
+    ASSERT_EQ(TT_Hashfull(&tt), 0);
+
+    TT_Free(&tt);
+    return 1;
+}
+
+// Test searching a position twice with the same table
+static int test_tt_search(void) {
+    Board board;
+    Board_InitEmpty(&board);
+    ASSERT(Board_FromFen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", &board) == 0);
+
+    TransTable tt;
+    ASSERT(TT_Init(&tt, 1) == 0);
+
+    SearchLimits limits = {6, 0, 0};
+    SearchResult with_tt, without_tt;
+    ASSERT(Board_Search(&board, &limits, &tt, NULL, NULL, &with_tt) == 0);
+    ASSERT(Board_Search(&board, &limits, NULL, NULL, NULL, &without_tt) == 0);
+    ASSERT(with_tt.hashfull > 0);
+    ASSERT_EQ(with_tt.score, without_tt.score);
+    ASSERT(with_tt.nodes < without_tt.nodes);
+
+    // the second search of the same position finds the entries of the first one
+    SearchResult again;
+    ASSERT(Board_Search(&board, &limits, &tt, NULL, NULL, &again) == 0);
+    ASSERT(again.nodes < with_tt.nodes);
+    ASSERT_EQ(tt.generation, 2);
+
+    TT_Free(&tt);
+    Board_FreeExtraOnly(&board);
+    return 1;
+}
+
+void test_tt_suite(TestResults* results) {
+    TestFunc tests[] = {
+        test_tt_store_probe,
+        test_tt_replace,
+        test_tt_hashfull,
+        test_tt_search
+    };
+
+    run_test_suite("Transposition Table Tests", tests, 4, results);
+}
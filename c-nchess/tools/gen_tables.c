@@ -0,0 +1,38 @@
+/*
+    gen_tables.c
+
+    Writes the bitboard tables of nchess as C source. It is built and run by
+    build.py and setup.py when the library is built with precomputed tables
+    and its output is the bitboard_tables.h included by bitboard.c.
+
+    Usage: gen_tables <output file>
+*/
+
+#include "nchess.h"
+
+#include <stdio.h>
+
+int
+main(int argc, char** argv){
+    if (argc != 2){
+        fprintf(stderr, "Usage: %s <output file>\n", argv[0]);
+        return 1;
+    }
+
+    NCH_Init();
+
+    FILE* file = fopen(argv[1], "w");
+    if (!file){
+        fprintf(stderr, "Could not open %s\n", argv[1]);
+        return 1;
+    }
+
+    int ok = NCH_WriteBitboardTables(file) == 0;
+    ok = fclose(file) == 0 && ok;
+    if (!ok){
+        fprintf(stderr, "Could not write %s\n", argv[1]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,3 +1,4 @@
+import os
 import numpy as np
 from typing import Sequence, overload, TypeAlias, Iterable, Tuple, Optional
 
@@ -10,6 +11,9 @@ class Move(int):
     of chess moves.
     This encoding method enables compact storage and quick access to the essential information 
     regarding each move, similar to the approach used in the Stockfish chess engine.
+
+    Like small ints, a single Move object exists for every value. Creating a move or getting
+    it from a board returns the cached object, so moves are cheap to produce in large numbers.
     """
 
     def __init__(self, move: int | str):
@@ -474,6 +478,48 @@ class Board:
         """
         ...
 
+    @property
+    def key(self) -> int:
+        """
+        Returns the Zobrist key of the current position as an unsigned 64-bit integer.
+        The key covers the pieces, the side to play, the castle rights and the en passant
+        file (only when an en passant capture is possible). It is updated incrementally
+        with every move, so reading it costs nothing.
+
+        Two boards with the same position have the same key, even in different processes.
+
+        Returns:
+            int: The Zobrist key of the position.
+        """
+        ...
+
+    @property
+    def material(self) -> tuple[int, int]:
+        """
+        Returns the material of white and black in centipawns, counting pawns as 100,
+        knights as 320, bishops as 330, rooks as 500 and queens as 900. It is kept by
+        the board and updated with every move, so reading it costs nothing.
+
+        Returns:
+            tuple[int, int]: The material of white and the material of black.
+        """
+        ...
+
+    @property
+    def pst_score(self) -> int:
+        """
+        Returns the piece-square table score of the position from white perspective in
+        centipawns. The midgame and endgame tables (PeSTO) are tapered by the pieces left
+        on the board. Like material it is kept by the board and updated with every move.
+
+        The material is not included: white material minus black material plus
+        pst_score is the PeSTO evaluation of the position.
+
+        Returns:
+            int: The piece-square table score of the position.
+        """
+        ...
+
     @property
     def is_check(self) -> bool:
         """
@@ -570,6 +616,59 @@ class Board:
         """
         ...
 
+    def parse_san(self, san: str) -> Move:
+        """
+        Converts a move in Standard Algebraic Notation (like "Nbd7", "exd5", "e8=Q+"
+        or "O-O") to the legal move of the board it describes.
+
+        Parameters:
+            san (str): The SAN of the move. Check and mate marks and annotations like
+                "!?" are ignored.
+
+        Returns:
+            Move: The move. It could be passed to step.
+
+        Raises:
+            ValueError: If the SAN does not describe exactly one legal move of the board.
+        """
+        ...
+
+    def san(self, move: Move | str | int) -> str:
+        """
+        Returns the Standard Algebraic Notation of a legal move of the board, with the
+        '+' or '#' suffix if the move gives check or mates.
+
+        Parameters:
+            move (Move | str | int): The move.
+
+        Returns:
+            str: The SAN of the move, like "Nbd7", "exd8=Q+" or "O-O".
+
+        Raises:
+            ValueError: If the move is not a legal move of the board.
+        """
+        ...
+
+    def line_san(self, moves: Sequence[Move | str | int] | np.ndarray) -> list[str]:
+        """
+        Returns the Standard Algebraic Notation of moves that are played one after another
+        starting from the board, like the moves of a game. The board is not changed.
+
+        The legal moves of every position are generated once for the whole line, so it is
+        much faster than playing the moves and calling san for every one of them.
+
+        Parameters:
+            moves (Sequence[Move | str | int] | np.ndarray): The moves. A uint16 array like
+                the moves returned by PGNReader works too.
+
+        Returns:
+            list[str]: The SAN of every move.
+
+        Raises:
+            ValueError: If a move is not legal in the position it is played on.
+        """
+        ...
+
     def undo(self) -> None:
         """
         Undoes the last move and restores the previous board state.
@@ -606,7 +705,7 @@ class Board:
         ...
 
 
-    def perft(self, deep: int, pretty: bool = False, no_print: bool = False) -> int:
+    def perft(self, deep: int, pretty: bool = False, no_print: bool = False, threads: int = 1, hash_size: int = 0) -> int:
         """
         Performs a performance test (perft) by counting all legal moves up to a given depth.
 
@@ -614,22 +713,34 @@ class Board:
             deep (int): The depth of the perft search.
             pretty (bool, optional): If True, numbers printed to the console will include commas (e.g., 1,000,000).
             no_print (bool, optional): If True, the function will not print results to the console.
+            threads (int, optional): The number of threads to split the work between. If it is 0 or less
+                the number of processors is used. With more than one thread the node count and rate
+                of each thread are printed as well.
+            hash_size (int, optional): Size in megabytes of a hash table that stores the counts of
+                subtrees, so transpositions are counted only once. 0 means no table.
 
         Note:
             on Jupyter Notebook it prints nothing.
+            The search runs on a copy of the position with the GIL released, other
+            threads could use the board meanwhile.
 
         Returns:
             int: The total number of legal moves at the given depth.
         """
         ...
 
-    def perft_moves(self, deep: int) -> dict[Move, int]:
+    def perft_moves(self, deep: int, hash_size: int = 0) -> dict[Move, int]:
         """
         Performs a performance test (perft) and returns a dictionary mapping each legal move
         to the number of positions reachable from that move at the given depth.
 
         Parameters:
             deep (int): The depth of the perft search.
+            hash_size (int, optional): Size in megabytes of a hash table that stores the counts of
+                subtrees. 0 means no table.
+
+        Note:
+            Like perft it runs on a copy of the position with the GIL released.
 
         Returns:
             dict[Move, int]: A dictionary where keys are Move objects and values are the
@@ -637,6 +748,40 @@ class Board:
         """
         ...
 
+    def search(self, depth: int = 0, movetime: float = 0.0, nodes: int = 0, hash_size: int = 16,
+               network: Network | None = None) -> tuple[Move | None, int, list[Move]]:
+        """
+        Searches the position with an iterative deepening alpha-beta (PVS) search and
+        returns the best move. The evaluation is the network if one is given and counts
+        the material of both sides otherwise.
+
+        At least one limit must be given. The search stops at the first limit that is
+        reached, but its first iteration is always completed.
+
+        Parameters:
+            depth (int, optional): The deepest iteration in plies. 0 means no limit.
+            movetime (float, optional): The time limit in seconds. 0 means no limit.
+            nodes (int, optional): The nodes limit. 0 means no limit.
+            hash_size (int, optional): The size of the transposition table in megabytes.
+                0 searches without a table.
+            network (Network, optional): The NNUE network that evaluates the positions.
+
+        Note:
+            It runs on a copy of the board with the GIL released. The moves played on the
+            board are used to detect repetitions.
+
+        Returns:
+            tuple[Move | None, int, list[Move]]: The best move, its score in centipawns from
+                the side to play perspective and the principal variation. A mate in n plies
+                is scored 32000 - n (or its negative if the side to play is mated). The move
+                is None if the board has no legal moves.
+
+        Raises:
+            ValueError: If no limit is given or hash_size is negative.
+            MemoryError: If the transposition table could not be allocated.
+        """
+        ...
+
     def generate_legal_moves(self, as_set : bool = False) -> list[Move] | set[Move]:
         """
         Generates all legal moves for the current position.
@@ -678,6 +823,66 @@ class Board:
         """
         ...
 
+    def legal_moves_array(self) -> np.ndarray:
+        """
+        Returns the legal moves as a uint16 NumPy array without creating Move objects.
+
+        Returns:
+            np.ndarray: A uint16 array with one item for each legal move.
+        """
+        ...
+
+    def legal_move_mask(self, out = None) -> np.ndarray:
+        """
+        Returns the legal moves as a fixed size mask to be used with a policy output.
+        The mask has 4288 items:
+            0-4095: the move from square f to square t is at f + 64 * t.
+                Queen promotions are at the index of their squares.
+            4096-4287: the promotions to a knight, a bishop or a rook are at
+                4096 + 64 * k + 8 * (f % 8) + (t % 8) where k is 0, 1 or 2 for the
+                knight, the bishop and the rook.
+
+        Parameters:
+            out (optional): A writable buffer to write the mask into instead of a new array.
+                uint8 and bool buffers get 0 or 1, float32 buffers get 0.0 or 1.0 and 64-bit
+                integer buffers get the mask as a bitset of 67 items.
+
+        Returns:
+            np.ndarray: A bool array of shape (4288,), or out if it is given.
+        """
+        ...
+
+    def encode_into(self, buf, offset: int = 0, reversed: bool = False) -> int:
+        """
+        Writes the feature planes of the board into an existing buffer without allocating.
+        The buffer could be a NumPy array or any writable C contiguous object that supports
+        the buffer protocol. There are 19 planes of 64 squares each:
+            0-11: the pieces from white pawn to black king.
+            12: the side to move, all ones if black is to move.
+            13-16: the castle rights WK, WQ, BK, BQ, all ones if the right exists.
+            17: the en passant target square.
+            18: the fifty moves counter on every square.
+
+        The type of the planes follows the items of the buffer:
+            uint8: one byte for each square (19 * 64 items).
+            float32: one float for each square (19 * 64 items).
+            uint64 or int64: the planes packed as bitboards, the last item is the
+                fifty moves counter (19 items).
+
+        Parameters:
+            buf: The buffer to write into, for example a (B, 19, 8, 8) float32 array.
+            offset (int, optional): The index of the item the planes start from. Defaults to 0.
+            reversed (bool, optional): If True, each plane is written in reverse.
+
+        Raises:
+            TypeError: If the items of the buffer are not one of the types above. bool
+                buffers are refused because the fifty moves counter is not 0 or 1.
+
+        Returns:
+            int: The offset right after the written planes.
+        """
+        ...
+
     def on_square(self, square: str | int) -> int:
         """
         Returns the piece located on the given square.
@@ -760,10 +965,16 @@ class Board:
         """
         ...
 
-    def copy(self) -> Board:
+    def copy(self, history: bool = True) -> Board:
         """
         Creates a deep copy of the current board.
 
+        Parameters:
+            history (bool): If True, the played moves are copied as well so the new
+                board could undo them and detect repetitions. If False, only the
+                position is copied, which is much cheaper and never allocates a
+                history.
+
         Returns:
             Board: A new board instance identical to the current state.
         """
@@ -806,6 +1017,36 @@ class Board:
         """
         ...
 
+    def pack(self) -> bytes:
+        """
+        Packs the position into 32 bytes. The packed form has the occupancy bitboard,
+        a 4 bit code for every piece, the side to play, the castle rights, the en passant
+        square and the move counters. The history of the board is not packed.
+
+        Returns:
+            bytes: The packed position.
+
+        Raises:
+            ValueError: If the board has more than 32 pieces.
+        """
+        ...
+
+    @classmethod
+    def unpack(cls, data: bytes) -> Board:
+        """
+        Creates a board from a position packed by Board.pack.
+
+        Parameters:
+            data (bytes): The 32 bytes of the packed position.
+
+        Returns:
+            Board: A new board without history.
+
+        Raises:
+            ValueError: If data is not a valid packed position.
+        """
+        ...
+
     def _makemove(self, move: int | str) -> None:
         """
         Privately applies a move to the board without legality checks.
@@ -841,6 +1082,309 @@ class Board:
 
 
 
+class BoardBatch:
+    """
+    A fixed number of boards that are stepped together in a single call. It is meant for
+    running many games at once (like the environments of a reinforcement learning agent)
+    without paying the cost of a Python call for every board. All methods work on the
+    whole batch and release the GIL while looping over the boards.
+
+    Many threads could read the same batch at once but step and reset need the batch for
+    themselves. A call that conflicts with a call running on another thread raises a
+    RuntimeError instead of waiting.
+    """
+
+    def __init__(self, n: int, fen: str = None) -> None:
+        """
+        Creates n boards set to the same initial position.
+
+        Parameters:
+            n (int): The number of boards in the batch.
+            fen (str, optional): The initial position. Defaults to the standard starting position.
+        """
+        ...
+
+    def __len__(self) -> int:
+        ...
+
+    def __getitem__(self, index: int) -> Board:
+        """
+        Returns a copy of the board at the given index.
+        """
+        ...
+
+    def step(self, moves: np.ndarray) -> np.ndarray:
+        """
+        Plays a move on every board.
+
+        Parameters:
+            moves (np.ndarray): A uint16 array of shape (n,) with one move for each board.
+
+        Returns:
+            np.ndarray: A bool array of shape (n,). An item is False if the move was illegal
+                and the board was not changed.
+        """
+        ...
+
+    def legal_move_masks(self, out = None) -> np.ndarray:
+        """
+        Returns the legal moves of every board as a mask. See Board.legal_move_mask
+        for the layout of the mask.
+
+        Parameters:
+            out (optional): A buffer to write the masks into instead of a new array. It has
+                the same types as in Board.legal_move_mask, n masks one after another.
+
+        Returns:
+            np.ndarray: A bool array of shape (n, 4288), or out if it is given.
+        """
+        ...
+
+    def game_states(self) -> np.ndarray:
+        """
+        Returns the state of every board.
+
+        Returns:
+            np.ndarray: A uint8 array of shape (n,) with the same values as Board.state.
+        """
+        ...
+
+    def reset(self, mask: np.ndarray = None) -> None:
+        """
+        Puts the boards back to the initial position of the batch.
+
+        Parameters:
+            mask (np.ndarray, optional): A bool array of shape (n,) that selects the boards
+                to reset. All boards are reset if it is not given.
+        """
+        ...
+
+    def as_array(self, reversed: bool = False) -> np.ndarray:
+        """
+        Returns the bitboards of every board expanded to arrays.
+
+        Parameters:
+            reversed (bool, optional): If True, each bitboard is read in reverse.
+
+        Returns:
+            np.ndarray: An int array of shape (n, 12, 64).
+        """
+        ...
+
+    def encode_into(self, buf, offset: int = 0, reversed: bool = False) -> int:
+        """
+        Writes the feature planes of every board one after another into an existing
+        buffer. See Board.encode_into for the planes and the supported types.
+
+        Parameters:
+            buf: The buffer to write into, for example a (n, 19, 8, 8) float32 array.
+            offset (int, optional): The index of the item the first board starts from. Defaults to 0.
+            reversed (bool, optional): If True, each plane is written in reverse.
+
+        Returns:
+            int: The offset right after the planes of the last board.
+        """
+        ...
+
+    @classmethod
+    def from_fens(cls, data: str | bytes, threads: int = 0) -> tuple[BoardBatch, np.ndarray]:
+        """
+        Creates a batch from many FEN lines, one position per line. Each line is read up to
+        the first ',' or ';' so CSV and EPD lines work too, and blank lines are skipped. The
+        lines are split between threads and parsed with the GIL released.
+
+        The positions read become the initial positions of the batch, reset puts every board
+        back to its own line.
+
+        Parameters:
+            data (str | bytes): The text to read. Any object with the buffer protocol works,
+                like bytes or an mmap of a file.
+            threads (int, optional): The number of threads. Defaults to 0, the number of CPUs.
+
+        Returns:
+            tuple[BoardBatch, np.ndarray]: The batch and an int64 array with the line numbers
+                (starting from 1) of the lines that could not be read. A line that could not be
+                read still takes its place in the batch as an empty board, so the boards stay in
+                the order of the lines.
+        """
+        ...
+
+    def to_fens(self) -> str:
+        """
+        Returns the FEN of every board, one per line.
+        """
+        ...
+
+    def pack(self) -> np.ndarray:
+        """
+        Packs the position of every board like Board.pack.
+
+        Returns:
+            np.ndarray: A structured array of shape (n,) with 32 bytes items and the fields
+                occupancy (u8), pieces (u1, 16), nmoves (u2), fifty_counter (u2), state (u1),
+                en_passant (u1) and reserved (u1, 2). It could be saved with tofile and read
+                back with BoardBatch.from_packed.
+        """
+        ...
+
+    @classmethod
+    def from_packed(cls, data) -> BoardBatch:
+        """
+        Creates a batch from packed positions. The positions become the initial positions
+        of the batch, reset puts every board back to its own position.
+
+        Parameters:
+            data: The packed positions one after another. Any object with the buffer
+                protocol works, like the array returned by BoardBatch.pack, bytes or an
+                mmap of a file.
+
+        Returns:
+            BoardBatch: A batch with one board for every 32 bytes of data.
+
+        Raises:
+            ValueError: If the size of data is not a multiple of 32 bytes or if a packed
+                position is not valid.
+        """
+        ...
+
+class PGNReader:
+    """
+    An iterator over the games of a PGN file. The moves of the main line of every game
+    are replayed in C, variations, comments and NAGs are skipped. The games are read
+    block by block (a few MB at a time) and every block is split between threads at game
+    boundaries with the GIL released, so a file of many GB could be read through an mmap
+    without loading it into memory.
+
+    Every item is a tuple (headers, moves) or (headers, moves, positions) if positions is
+    True:
+        headers (dict[str, str]): The tags of the game.
+        moves (np.ndarray): A uint16 array of the moves of the main line.
+        positions (np.ndarray): The packed positions (see BoardBatch.pack) before every
+            move and after the last one. It has one item more than moves.
+
+    A game with a move that could not be read is returned with the moves before it and
+    its index is added to errors.
+
+    A reader is read by one thread at a time. Getting the next game while another thread
+    is getting one from the same reader raises a RuntimeError.
+    """
+
+    errors: list[int]
+    """The indices of the games returned so far that could not be read to their end."""
+
+    def __init__(self, data: str | bytes, threads: int = 0, positions: bool = False) -> None:
+        """
+        Parameters:
+            data (str | bytes): The text of the PGN file. Any object with the buffer
+                protocol works, like bytes or an mmap of a file.
+            threads (int, optional): The number of threads. Defaults to 0, the number of CPUs.
+            positions (bool, optional): If True, the positions of every game are returned too.
+        """
+        ...
+
+    def __iter__(self) -> PGNReader:
+        ...
+
+    def __next__(self) -> tuple:
+        ...
+
+class SearchPool:
+    """
+    Searches positions with many threads at once (Lazy SMP). Every thread searches its own
+    copy of the board and they share a transposition table, the helper threads skip some
+    iterations so they fill the table ahead of the main thread.
+
+    The threads are started once and wait between the searches, and the table keeps what
+    the searches before found, so a pool is meant to be reused for all the moves of a game.
+    """
+
+    threads: int
+    """The number of threads, including the thread that calls search."""
+
+    info: dict | None
+    """
+    The statistics of the last search or None before the first one. The keys are depth,
+    nodes, seconds, nps (nodes per second) and hashfull (permille of the table used by the
+    search) and threads, a list with the nodes, depth, seconds and nps of every thread.
+    Reading it while another thread is searching with the pool raises a RuntimeError.
+    """
+
+    def __init__(self, threads: int = 0, hash_size: int = 16) -> None:
+        """
+        Parameters:
+            threads (int, optional): The number of threads. Defaults to 0, the number of CPUs.
+            hash_size (int, optional): The size of the transposition table in megabytes.
+                0 searches without a table.
+
+        Raises:
+            ValueError: If hash_size is negative.
+            MemoryError: If the table or the threads could not be allocated.
+        """
+        ...
+
+    def search(self, board: Board, depth: int = 0, movetime: float = 0.0, nodes: int = 0,
+               network: Network | None = None) -> tuple[Move | None, int, list[Move]]:
+        """
+        Searches the board like Board.search with all the threads of the pool. The limits
+        are checked by the main thread, the nodes limit counts the nodes of all the threads.
+        The result is the one of the thread that completed the deepest iteration.
+
+        Parameters:
+            board (Board): The board to search. It is not changed.
+            depth (int, optional): The deepest iteration in plies. 0 means no limit.
+            movetime (float, optional): The time limit in seconds. 0 means no limit.
+            nodes (int, optional): The nodes limit. 0 means no limit.
+            network (Network, optional): The NNUE network that evaluates the positions.
+                All the threads share it.
+
+        Returns:
+            tuple[Move | None, int, list[Move]]: The same as Board.search.
+
+        Raises:
+            ValueError: If no limit is given.
+            RuntimeError: If another thread is searching with the pool.
+        """
+        ...
+
+    def clear(self) -> None:
+        """
+        Removes all the entries of the transposition table, like a new game.
+        """
+        ...
+
+class Network:
+    """
+    The weights of an NNUE evaluation: 768 inputs (12 pieces x 64 squares), a hidden layer
+    of 256 seen from both sides and one output in centipawns. The file format is described
+    in c-nchess/nchess/nnue.h.
+
+    A network is never changed after it is read so many searches could use it at once.
+    """
+
+    def __init__(self, source: str | os.PathLike | bytes) -> None:
+        """
+        Parameters:
+            source (str | PathLike | bytes): The path of a weight file or its content. Any
+                object with the buffer protocol is read as the content.
+
+        Raises:
+            ValueError: If the data is not a valid network.
+            OSError: If the file could not be read.
+        """
+        ...
+
+    def evaluate(self, board: Board) -> int:
+        """
+        Evaluates the board from the side to play perspective in centipawns.
+
+        Parameters:
+            board (Board): The board to evaluate.
+
+        Returns:
+            int: The score of the board.
+        """
+        ...
+
 def square_from_uci(uci: str) -> int:
     """
     Converts a UCI square notation (e.g., "e4") to its corresponding index (0-63).
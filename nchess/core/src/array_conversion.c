@@ -83,6 +83,41 @@ create_numpy_array(void* data, npy_intp* dims, int ndim, enum NPY_TYPES dtype){
     return numpy_array;
 }
 
+PyArray_Descr*
+packed_board_descr(void){
+    // the type is built once and kept for the life of the module
+    NCH_STATIC PyArray_Descr* cached = NULL;
+    if (cached){
+        Py_INCREF(cached);
+        return cached;
+    }
+
+    import_array();
+
+    PyObject* fields = Py_BuildValue(
+        "[(ss)(ss(i))(ss)(ss)(ss)(ss)(ss(i))]",
+        "occupancy"    , "u8",
+        "pieces"       , "u1", NCH_PACKED_MAX_PIECES / 2,
+        "nmoves"       , "u2",
+        "fifty_counter", "u2",
+        "state"        , "u1",
+        "en_passant"   , "u1",
+        "reserved"     , "u1", 2
+    );
+    if (!fields)
+        return NULL;
+
+    PyArray_Descr* descr = NULL;
+    int res = PyArray_DescrConverter(fields, &descr);
+    Py_DECREF(fields);
+    if (!res)
+        return NULL;
+
+    Py_INCREF(descr);
+    cached = descr;
+    return descr;
+}
+
 NCH_STATIC PyObject*
 _create_list_array_recursive(int** data, npy_intp* dims, int dim, int roof){
     npy_intp size = dims[dim];
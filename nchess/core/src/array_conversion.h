@@ -14,6 +14,12 @@ create_numpy_array(void* data, npy_intp* dims, int ndim, enum NPY_TYPES dtype);
 PyObject*
 create_list_array(int* data, npy_intp* dims, int ndim);
 
+// returns a new reference to the numpy type of a packed board. its fields
+// follow the PackedBoard struct (see nchess/pack.h). it is built on the
+// first call and shared after.
+PyArray_Descr*
+packed_board_descr(void);
+
 int
 parse_array_conversion_function_args(npy_intp nitems, npy_intp* dims, PyObject* args,
                                      PyObject* kwargs, int* reversed, int* as_list);
@@ -10,21 +10,7 @@
 
 void
 bb2array(uint64 bb, int* arr, int reverse){
-    for (int i = 0; i < NCH_SQUARE_NB; i++){
-        arr[i] = 0;
-    }
-
-    int idx;
-    if (reverse){
-        LOOP_U64_T(bb){
-            arr[63 - idx] = 1;
-        }
-    }
-    else{
-        LOOP_U64_T(bb){
-            arr[idx] = 1;
-        }
-    }
+    bb_expand_i32(bb, arr, reverse);
 }
 
 NCH_STATIC_INLINE int
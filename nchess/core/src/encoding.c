@@ -0,0 +1,135 @@
+#include "encoding.h"
+#include "nchess/nchess.h"
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <string.h>
+
+int
+encode_get_buffer(PyObject* obj, Py_buffer* view, EncodeType* type, int allow_bool){
+    if (PyObject_GetBuffer(obj, view, PyBUF_C_CONTIGUOUS | PyBUF_WRITABLE | PyBUF_FORMAT) < 0){
+        return -1;
+    }
+
+    // skip the byte order character. only native sizes are accepted below
+    const char* format = view->format ? view->format : "B";
+    if (*format == '@' || *format == '=' || *format == '<' || *format == '>' || *format == '!'){
+        format++;
+    }
+
+    char code = format[0] && !format[1] ? format[0] : 0;
+    if (code == '?' && !allow_bool){
+        PyErr_SetString(PyExc_TypeError,
+            "bool buffers could not hold the fifty moves counter. use uint8, float32 or 64-bit integer items");
+        PyBuffer_Release(view);
+        return -1;
+    }
+
+    if ((code == 'B' || code == 'b' || code == '?' || code == 'c') && view->itemsize == 1){
+        *type = Encode_UInt8;
+    }
+    else if (code == 'f' && view->itemsize == 4){
+        *type = Encode_Float32;
+    }
+    else if ((code == 'Q' || code == 'q' || code == 'L' || code == 'l') && view->itemsize == 8){
+        *type = Encode_Packed;
+    }
+    else{
+        PyErr_Format(PyExc_TypeError,
+            "buffer expected to hold uint8, bool, float32 or 64-bit integer items. got format '%s'",
+            view->format ? view->format : "B");
+        PyBuffer_Release(view);
+        return -1;
+    }
+
+    return 0;
+}
+
+int
+encode_check_space(const Py_buffer* view, Py_ssize_t offset, Py_ssize_t nitems){
+    Py_ssize_t size = view->len / view->itemsize;
+
+    if (offset < 0 || offset > size || size - offset < nitems){
+        PyErr_Format(PyExc_ValueError,
+            "buffer of %zd items has no space for %zd items at offset %zd",
+            size, nitems, offset);
+        return -1;
+    }
+
+    return 0;
+}
+
+void
+encode_board(const Board* board, void* out, EncodeType type, int reversed){
+    uint64 planes[ENCODE_PLANES - 1];
+
+    for (Piece p = NCH_WPawn; p < NCH_PIECE_NB; p++){
+        planes[p - NCH_WPawn] = Board_BB(board, p);
+    }
+
+    planes[12] = Board_IS_BLACKTURN(board) ? NCH_UINT64_MAX : 0ULL;
+    planes[13] = Board_IS_CASTLE_WK(board) ? NCH_UINT64_MAX : 0ULL;
+    planes[14] = Board_IS_CASTLE_WQ(board) ? NCH_UINT64_MAX : 0ULL;
+    planes[15] = Board_IS_CASTLE_BK(board) ? NCH_UINT64_MAX : 0ULL;
+    planes[16] = Board_IS_CASTLE_BQ(board) ? NCH_UINT64_MAX : 0ULL;
+    planes[17] = Board_ENP_TRG(board);
+
+    int fifty = Board_FIFTY_COUNTER(board);
+
+    if (type == Encode_Packed){
+        uint64* packed = (uint64*)out;
+        for (int i = 0; i < ENCODE_PLANES - 1; i++){
+            packed[i] = reversed ? reverse_bits(planes[i]) : planes[i];
+        }
+        packed[ENCODE_PLANES - 1] = (uint64)fifty;
+    }
+    else if (type == Encode_UInt8){
+        uint8* bytes = (uint8*)out;
+        for (int i = 0; i < ENCODE_PLANES - 1; i++){
+            bb_expand_u8(planes[i], bytes, reversed);
+            bytes += NCH_SQUARE_NB;
+        }
+        memset(bytes, fifty > 255 ? 255 : fifty, NCH_SQUARE_NB);
+    }
+    else{
+        float* floats = (float*)out;
+        for (int i = 0; i < ENCODE_PLANES - 1; i++){
+            bb_expand_f32(planes[i], floats, reversed);
+            floats += NCH_SQUARE_NB;
+        }
+        for (int i = 0; i < NCH_SQUARE_NB; i++){
+            floats[i] = (float)fifty;
+        }
+    }
+}
+
+void
+encode_legal_mask(const Board* board, void* out, EncodeType type){
+    Move moves[256];
+    int nmoves = Board_GenerateLegalMoves(board, moves);
+    int idx;
+
+    if (type == Encode_Packed){
+        uint64* bits = (uint64*)out;
+        memset(bits, 0, encode_mask_size(type) * sizeof(uint64));
+        for (int i = 0; i < nmoves; i++){
+            idx = encode_move_index(moves[i]);
+            bits[idx >> 6] |= NCH_SQR(idx & 63);
+        }
+    }
+    else if (type == Encode_UInt8){
+        uint8* bytes = (uint8*)out;
+        memset(bytes, 0, ENCODE_MOVE_MASK_SIZE);
+        for (int i = 0; i < nmoves; i++){
+            bytes[encode_move_index(moves[i])] = 1;
+        }
+    }
+    else{
+        float* floats = (float*)out;
+        memset(floats, 0, ENCODE_MOVE_MASK_SIZE * sizeof(float));
+        for (int i = 0; i < nmoves; i++){
+            floats[encode_move_index(moves[i])] = 1.0f;
+        }
+    }
+}
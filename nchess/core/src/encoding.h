@@ -0,0 +1,83 @@
+#ifndef NCHESS_CORE_ENCODING_H
+#define NCHESS_CORE_ENCODING_H
+
+#include "nchess/nchess.h"
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+/*
+    Feature planes written by Board.encode_into and BoardBatch.encode_into.
+    Every plane covers the 64 squares of the board:
+        0  - 11 : the bitboards of the pieces from white pawn to black king
+        12      : the side to move. all ones if black is to move
+        13 - 16 : castle rights in the order WK, WQ, BK, BQ. all ones if the right exists
+        17      : the en passant target square
+        18      : the fifty moves counter on every square
+*/
+#define ENCODE_PLANES 19
+
+typedef enum{
+    Encode_UInt8,       // one byte for each square
+    Encode_Float32,     // one float for each square
+    Encode_Packed,      // one uint64 bitboard for each plane
+}EncodeType;
+
+/*
+    The legal move mask written by Board.legal_move_mask and BoardBatch.legal_move_masks.
+    A move from square f to square t is at index f + 64 * t (the squares of the move).
+    Queen promotions use the same index. The promotions to a knight, a bishop or a rook
+    are at 4096 + 64 * (piece_type - Knight) + 8 * file(f) + file(t), the side to move
+    tells which ranks they are on.
+*/
+#define ENCODE_MOVE_MASK_SIZE (NCH_SQUARE_NB * NCH_SQUARE_NB + 3 * NCH_SQUARE_NB)
+
+// returns the index of the move in the legal move mask.
+NCH_STATIC_INLINE int
+encode_move_index(Move move){
+    if (Move_IsPromotion(move) && Move_PRO_PIECE(move) != NCH_Queen){
+        return NCH_SQUARE_NB * NCH_SQUARE_NB
+             + NCH_SQUARE_NB * (Move_PRO_PIECE(move) - NCH_Knight)
+             + 8 * (Move_FROM(move) & 7) + (Move_TO(move) & 7);
+    }
+    return move & Move_SQUARES_MASK;
+}
+
+// returns the number of items that the legal move mask takes in a buffer of the given type.
+// the packed mask is a bitset of 64-bit items.
+NCH_STATIC_INLINE Py_ssize_t
+encode_mask_size(EncodeType type){
+    return type == Encode_Packed ? (ENCODE_MOVE_MASK_SIZE + 63) / 64 : ENCODE_MOVE_MASK_SIZE;
+}
+
+// returns the number of items that a single board takes in a buffer of the given type.
+NCH_STATIC_INLINE Py_ssize_t
+encode_board_size(EncodeType type){
+    return type == Encode_Packed ? ENCODE_PLANES : ENCODE_PLANES * NCH_SQUARE_NB;
+}
+
+// gets a writable C contiguous buffer from obj and finds the encoding type
+// from the format of its items (uint8, float32 or 64-bit integers).
+// bool buffers are written as bytes and are only accepted if allow_bool is 1,
+// numpy expects their bytes to be 0 or 1 so they fit the legal move masks
+// but not the fifty moves plane.
+// returns 0 on success and -1 with a python error set on failure.
+// on success the buffer must be released with PyBuffer_Release.
+int
+encode_get_buffer(PyObject* obj, Py_buffer* view, EncodeType* type, int allow_bool);
+
+// checks that nitems items fit in the buffer starting from the offset.
+// returns 0 on success and -1 with a python error set otherwise.
+int
+encode_check_space(const Py_buffer* view, Py_ssize_t offset, Py_ssize_t nitems);
+
+// writes the planes of the board into out. out must have space for
+// encode_board_size(type) items of the given type.
+void
+encode_board(const Board* board, void* out, EncodeType type, int reversed);
+
+// writes the legal move mask of the board into out. out must have space for
+// encode_mask_size(type) items of the given type.
+void
+encode_legal_mask(const Board* board, void* out, EncodeType type);
+
+#endif // NCHESS_CORE_ENCODING_H
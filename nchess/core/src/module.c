@@ -1,5 +1,9 @@
 #include "common.h"
 #include "pyboard.h"
+#include "pyboardbatch.h"
+#include "pypgn.h"
+#include "pysearch.h"
+#include "pynnue.h"
 #include "pymove.h"
 #include "bb_functions.h"
 #include "PyBB.h"
@@ -66,6 +70,22 @@ PyMODINIT_FUNC PyInit_nchess_core(void) {
         return NULL;
     }
 
+    if (PyType_Ready(&PyBoardBatchType) < 0) {
+        return NULL;
+    }
+
+    if (PyType_Ready(&PyPGNReaderType) < 0) {
+        return NULL;
+    }
+
+    if (PyType_Ready(&PySearchPoolType) < 0) {
+        return NULL;
+    }
+
+    if (PyType_Ready(&PyNNUENetworkType) < 0) {
+        return NULL;
+    }
+
     // Create the module
     m = PyModule_Create(&nchess_core);
     if (m == NULL) {
@@ -97,7 +117,59 @@ PyMODINIT_FUNC PyInit_nchess_core(void) {
         Py_DECREF(m);
         return NULL;
     }
+
+    Py_INCREF(&PyBoardBatchType);
+    if (PyModule_AddObject(m, "BoardBatch", (PyObject*)&PyBoardBatchType) < 0) {
+        Py_DECREF(&PyBoardBatchType);
+        Py_DECREF(&PyBitBoardType);
+        Py_DECREF(&PyMoveType);
+        Py_DECREF(&PyBoardType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    Py_INCREF(&PyPGNReaderType);
+    if (PyModule_AddObject(m, "PGNReader", (PyObject*)&PyPGNReaderType) < 0) {
+        Py_DECREF(&PyPGNReaderType);
+        Py_DECREF(&PyBoardBatchType);
+        Py_DECREF(&PyBitBoardType);
+        Py_DECREF(&PyMoveType);
+        Py_DECREF(&PyBoardType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    Py_INCREF(&PySearchPoolType);
+    if (PyModule_AddObject(m, "SearchPool", (PyObject*)&PySearchPoolType) < 0) {
+        Py_DECREF(&PySearchPoolType);
+        Py_DECREF(&PyPGNReaderType);
+        Py_DECREF(&PyBoardBatchType);
+        Py_DECREF(&PyBitBoardType);
+        Py_DECREF(&PyMoveType);
+        Py_DECREF(&PyBoardType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    Py_INCREF(&PyNNUENetworkType);
+    if (PyModule_AddObject(m, "Network", (PyObject*)&PyNNUENetworkType) < 0) {
+        Py_DECREF(&PyNNUENetworkType);
+        Py_DECREF(&PySearchPoolType);
+        Py_DECREF(&PyPGNReaderType);
+        Py_DECREF(&PyBoardBatchType);
+        Py_DECREF(&PyBitBoardType);
+        Py_DECREF(&PyMoveType);
+        Py_DECREF(&PyBoardType);
+        Py_DECREF(m);
+        return NULL;
+    }
     
+#ifdef Py_GIL_DISABLED
+    // the module keeps no python state of its own. every board method locks
+    // its board and the batches and the pools have their own busy flags.
+    PyUnstable_Module_SetGIL(m, Py_MOD_GIL_NOT_USED);
+#endif
+
     // Initialize additional components
     NCH_Init();
 
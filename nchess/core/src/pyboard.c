@@ -84,7 +84,9 @@ PyObject*
 board_str(PyObject* pyb){
     PyBoard* b = (PyBoard*)pyb;
     char buffer[100];
+    Py_BEGIN_CRITICAL_SECTION(pyb);
     Board_AsString(b->board, buffer);
+    Py_END_CRITICAL_SECTION();
     PyObject* str = PyUnicode_FromString(buffer);
     return str;
 }
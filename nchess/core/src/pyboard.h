@@ -20,4 +20,43 @@ PyBoard_FromBoardWithType(PyTypeObject *self, Board* board);
 PyObject*
 PyBoard_FromBoard(Board* board);
 
+// Py_BEGIN_CRITICAL_SECTION is new in Python 3.13, the versions before it
+// always have the GIL which already runs one call at a time.
+#ifndef Py_BEGIN_CRITICAL_SECTION
+#define Py_BEGIN_CRITICAL_SECTION(op) {
+#define Py_END_CRITICAL_SECTION() }
+#endif
+
+/*
+    Every method of a board runs in a critical section of the board object,
+    so on the free-threaded build a board is never read by one thread while
+    another thread changes it (a step could reallocate the history that a
+    read is walking). On the builds with the GIL the critical sections are
+    nothing.
+
+    The body of a method is written in name_impl and the macros below define
+    name as the call of name_impl in the critical section.
+*/
+#define PYBOARD_LOCKED(name, params, args)      \
+    PyObject*                                   \
+    name params {                               \
+        PyObject* res;                          \
+        Py_BEGIN_CRITICAL_SECTION(self);        \
+        res = name##_impl args;                 \
+        Py_END_CRITICAL_SECTION();              \
+        return res;                             \
+    }
+
+#define PYBOARD_LOCKED_NOARGS(name) \
+    PYBOARD_LOCKED(name, (PyObject* self), (self))
+
+#define PYBOARD_LOCKED_ARGS(name) \
+    PYBOARD_LOCKED(name, (PyObject* self, PyObject* args), (self, args))
+
+#define PYBOARD_LOCKED_KWARGS(name) \
+    PYBOARD_LOCKED(name, (PyObject* self, PyObject* args, PyObject* kwargs), (self, args, kwargs))
+
+#define PYBOARD_LOCKED_GETTER(name) \
+    PYBOARD_LOCKED(name, (PyObject* self, void* closure), (self, closure))
+
 #endif
\ No newline at end of file
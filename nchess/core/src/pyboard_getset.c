@@ -6,88 +6,104 @@
 
 #define BOARD(obj) ((PyBoard*)obj)->board
 
-PyObject*
-board_get_white_pawns(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_white_pawns_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_WHITE_PAWNS(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_white_pawns)
 
-PyObject*
-board_get_black_pawns(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_black_pawns_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_BLACK_PAWNS(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_black_pawns)
 
-PyObject*
-board_get_white_knights(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_white_knights_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_WHITE_KNIGHTS(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_white_knights)
 
-PyObject*
-board_get_black_knights(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_black_knights_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_BLACK_KNIGHTS(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_black_knights)
 
-PyObject*
-board_get_white_bishops(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_white_bishops_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_WHITE_BISHOPS(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_white_bishops)
 
-PyObject*
-board_get_black_bishops(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_black_bishops_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_BLACK_BISHOPS(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_black_bishops)
 
-PyObject*
-board_get_white_rooks(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_white_rooks_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_WHITE_ROOKS(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_white_rooks)
 
-PyObject*
-board_get_black_rooks(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_black_rooks_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_BLACK_ROOKS(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_black_rooks)
 
-PyObject*
-board_get_white_queens(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_white_queens_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_WHITE_QUEENS(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_white_queens)
 
-PyObject*
-board_get_black_queens(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_black_queens_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_BLACK_QUEENS(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_black_queens)
 
-PyObject*
-board_get_white_king(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_white_king_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_WHITE_KING(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_white_king)
 
-PyObject*
-board_get_black_king(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_black_king_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_BLACK_KING(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_black_king)
 
-PyObject*
-board_get_white_occ(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_white_occ_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_WHITE_OCC(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_white_occ)
 
-PyObject*
-board_get_black_occ(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_black_occ_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_BLACK_OCC(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_black_occ)
 
-PyObject*
-board_get_all_occ(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_get_all_occ_impl(PyObject* self, void* something){
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(Board_ALL_OCC(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_get_all_occ)
 
-PyObject*
-board_castles(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_castles_impl(PyObject* self, void* something){
     return (PyObject*)PyLong_FromUnsignedLong(Board_CASTLES(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_castles)
 
-PyObject*
-board_castles_str(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_castles_str_impl(PyObject* self, void* something){
     uint8 castles = Board_CASTLES(BOARD(self));
     if (!castles)
         Py_RETURN_NONE;
@@ -111,75 +127,108 @@ board_castles_str(PyObject* self, void* something){
 
     return PyUnicode_FromString(buffer);
 }
+PYBOARD_LOCKED_GETTER(board_castles_str)
 
-PyObject*
-board_nmoves(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_nmoves_impl(PyObject* self, void* something){
     return PyLong_FromLong(Board_NMOVES(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_nmoves)
 
-PyObject*
-board_fifty_counter(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_fifty_counter_impl(PyObject* self, void* something){
     return PyLong_FromLong(Board_FIFTY_COUNTER(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_fifty_counter)
 
-PyObject*
-board_en_passant_square(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_en_passant_square_impl(PyObject* self, void* something){
     Board* b = BOARD(self);
     if (!Board_ENP_IDX(b))
         return PyLong_FromLong(-1);
 
     return PyLong_FromLong(NCH_SQRIDX(Board_ENP_TRG(b)));
 }
+PYBOARD_LOCKED_GETTER(board_en_passant_square)
 
-PyObject*
-board_side(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_side_impl(PyObject* self, void* something){
     return PyLong_FromLong(Board_SIDE(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_side)
 
-PyObject*
-board_captured_piece(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_key_impl(PyObject* self, void* something){
+    return PyLong_FromUnsignedLongLong(Board_KEY(BOARD(self)));
+}
+PYBOARD_LOCKED_GETTER(board_key)
+
+NCH_STATIC PyObject*
+board_material_impl(PyObject* self, void* something){
+    Board* b = BOARD(self);
+    return Py_BuildValue("(ii)", Board_MATERIAL(b, NCH_White), Board_MATERIAL(b, NCH_Black));
+}
+PYBOARD_LOCKED_GETTER(board_material)
+
+NCH_STATIC PyObject*
+board_pst_score_impl(PyObject* self, void* something){
+    return PyLong_FromLong(Board_PSQTScore(BOARD(self)));
+}
+PYBOARD_LOCKED_GETTER(board_pst_score)
+
+NCH_STATIC PyObject*
+board_captured_piece_impl(PyObject* self, void* something){
     return piece_to_pyobject(Board_CAP_PIECE(BOARD(self)));
 }
+PYBOARD_LOCKED_GETTER(board_captured_piece)
 
-PyObject*
-board_is_check(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_is_check_impl(PyObject* self, void* something){
     if(Board_IS_CHECK(BOARD(self))) {Py_RETURN_TRUE;} Py_RETURN_FALSE;
 }
+PYBOARD_LOCKED_GETTER(board_is_check)
 
-PyObject*
-board_is_double_check(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_is_double_check_impl(PyObject* self, void* something){
     if(Board_IS_DOUBLECHECK(BOARD(self))) {Py_RETURN_TRUE;} Py_RETURN_FALSE;
 }
+PYBOARD_LOCKED_GETTER(board_is_double_check)
 
-PyObject*
-board_is_pawn_moved(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_is_pawn_moved_impl(PyObject* self, void* something){
     if(Board_IS_PAWNMOVED(BOARD(self))) {Py_RETURN_TRUE;} Py_RETURN_FALSE;
 }
+PYBOARD_LOCKED_GETTER(board_is_pawn_moved)
 
-PyObject*
-board_is_capture(PyObject* self, void* something){
+NCH_STATIC PyObject*
+board_is_capture_impl(PyObject* self, void* something){
     if(Board_IS_CAPTURE(BOARD(self))) {Py_RETURN_TRUE;} Py_RETURN_FALSE;
 }
+PYBOARD_LOCKED_GETTER(board_is_capture)
 
-PyObject*
-board_is_insufficient_material(PyObject* self, PyObject* args){
+NCH_STATIC PyObject*
+board_is_insufficient_material_impl(PyObject* self, void* something){
     if (Board_IsInsufficientMaterial(BOARD(self))) {Py_RETURN_TRUE;} Py_RETURN_FALSE;;
 }
+PYBOARD_LOCKED_GETTER(board_is_insufficient_material)
 
-PyObject*
-board_is_threefold(PyObject* self, PyObject* args){
+NCH_STATIC PyObject*
+board_is_threefold_impl(PyObject* self, void* something){
     if (Board_IsThreeFold(BOARD(self))) {Py_RETURN_TRUE;} Py_RETURN_FALSE;;
 }
+PYBOARD_LOCKED_GETTER(board_is_threefold)
 
-PyObject*
-board_is_fifty_moves(PyObject* self, PyObject* args){
+NCH_STATIC PyObject*
+board_is_fifty_moves_impl(PyObject* self, void* something){
     if (Board_IsFiftyMoves(BOARD(self))) {Py_RETURN_TRUE;} Py_RETURN_FALSE;;
 }
+PYBOARD_LOCKED_GETTER(board_is_fifty_moves)
 
-PyObject*
-board_can_move(PyObject* self, PyObject* args){
+NCH_STATIC PyObject*
+board_can_move_impl(PyObject* self, void* something){
     if (Board_CanMove(BOARD(self))) {Py_RETURN_TRUE;} Py_RETURN_FALSE;;
 }
+PYBOARD_LOCKED_GETTER(board_can_move)
 
 PyGetSetDef pyboard_getset[] = {
     {"white_pawns"             ,(getter)board_get_white_pawns          ,NULL ,NULL, NULL},
@@ -204,6 +253,9 @@ PyGetSetDef pyboard_getset[] = {
     {"en_passant_sqr"          ,(getter)board_en_passant_square        ,NULL ,NULL, NULL},
     {"side"                    ,(getter)board_side                     ,NULL ,NULL, NULL},
     {"captured_piece"          ,(getter)board_captured_piece           ,NULL ,NULL, NULL},
+    {"key"                     ,(getter)board_key                      ,NULL ,NULL, NULL},
+    {"material"                ,(getter)board_material                 ,NULL ,NULL, NULL},
+    {"pst_score"               ,(getter)board_pst_score                ,NULL ,NULL, NULL},
     
     {"is_check"                ,(getter)board_is_check                 ,NULL ,NULL, NULL},
     {"is_double_check"         ,(getter)board_is_double_check          ,NULL ,NULL, NULL},
@@ -6,6 +6,8 @@
 #include "array_conversion.h"
 #include "pyboard.h"
 #include "bb_functions.h"
+#include "encoding.h"
+#include "pynnue.h"
 
 #define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
 #include <numpy/arrayobject.h>
@@ -15,8 +17,12 @@
 #define BOARD_ARRAY_SIZE (NCH_PIECE_NB - 1) * NCH_SQUARE_NB
 #define BOARD_TABLE_SIZE NCH_SQUARE_NB
 
+// used as the logger of the perft functions. it is called while the GIL is
+// released so it takes the GIL back to write.
 void pyp(const char* s){
+    PyGILState_STATE gstate = PyGILState_Ensure();
     PySys_WriteStdout("%s", s);
+    PyGILState_Release(gstate);
 }
 
 PyObject*
@@ -68,8 +74,8 @@ moves_to_set(Move* moves, int nmoves) {
     return set;
 }
 
-PyObject*
-board__makemove(PyObject* self, PyObject* args){
+NCH_STATIC PyObject*
+board__makemove_impl(PyObject* self, PyObject* args){
     PyObject* move_obj;
 
     if (!PyArg_ParseTuple(args, "O", &move_obj)){
@@ -88,9 +94,10 @@ board__makemove(PyObject* self, PyObject* args){
 
     Py_RETURN_NONE;
 }
+PYBOARD_LOCKED_ARGS(board__makemove)
 
-PyObject*
-board_step(PyObject* self, PyObject* args, PyObject* kwargs){
+NCH_STATIC PyObject*
+board_step_impl(PyObject* self, PyObject* args, PyObject* kwargs){
     PyObject* move_obj;
     static char* kwlist[] = {"move", NULL};
 
@@ -110,53 +117,108 @@ board_step(PyObject* self, PyObject* args, PyObject* kwargs){
     int out = Board_StepByMove(BOARD(self), move);
     return PyBool_FromLong(out);
 }
+PYBOARD_LOCKED_KWARGS(board_step)
 
-PyObject*
-board_undo(PyObject* self){
+NCH_STATIC PyObject*
+board_undo_impl(PyObject* self){
     Board_Undo(BOARD(self));
     Py_RETURN_NONE;
 }
+PYBOARD_LOCKED_NOARGS(board_undo)
 
-PyObject*
-board_perft(PyObject* self, PyObject* args, PyObject* kwargs){
+NCH_STATIC PyObject*
+board_perft_impl(PyObject* self, PyObject* args, PyObject* kwargs){
     int deep;
     int pretty = 0;
     int no_print = 0;
-    static char* kwlist[] = {"deep", "pretty", "no_print", NULL};
+    int threads = 1;
+    int hash_size = 0;
+    static char* kwlist[] = {"deep", "pretty", "no_print", "threads", "hash_size", NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i|pp", kwlist, &deep, &pretty, &no_print)){
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i|ppii", kwlist, &deep, &pretty, &no_print,
+                                     &threads, &hash_size)){
         if (!PyErr_Occurred()){
             PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
         }
         return NULL;
     }
 
+    // perft runs on a copy of the position with the GIL released so other
+    // threads could keep using the board meanwhile.
+    Board board;
+    Board_CopyPosition(BOARD(self), &board);
+
     long long nmoves;
-    if (no_print) {
-        nmoves = Board_PerftNoPrint(BOARD(self), deep);
+    Py_BEGIN_ALLOW_THREADS
+    if (threads != 1) {
+        nmoves = Board_PerftParallelWithOptions(&board, deep, threads, hash_size, pretty,
+                                                no_print ? NULL : pyp);
     } else {
-        nmoves = Board_PerftWithOptions(BOARD(self), deep, pretty, pyp);
+        nmoves = Board_PerftWithHash(&board, deep, hash_size, pretty,
+                                     no_print ? NULL : pyp);
+    }
+    Py_END_ALLOW_THREADS
+
+    Board_FreeExtraOnly(&board);
+
+    if (nmoves < 0){
+        PyErr_NoMemory();
+        return NULL;
     }
 
     return PyLong_FromLongLong(nmoves);
 }
+PYBOARD_LOCKED_KWARGS(board_perft)
 
-PyObject*
-board_perft_moves(PyObject* self, PyObject* args, PyObject* kwargs){
+typedef struct
+{
+    Move moves[256];
+    long long counts[256];
+    int nmoves;
+}PerftMovesResult;
+
+NCH_STATIC void
+perft_moves_collect(Move move, long long count, void* ctx){
+    PerftMovesResult* res = (PerftMovesResult*)ctx;
+    res->moves[res->nmoves] = move;
+    res->counts[res->nmoves] = count;
+    res->nmoves++;
+}
+
+NCH_STATIC PyObject*
+board_perft_moves_impl(PyObject* self, PyObject* args, PyObject* kwargs){
     int deep;
-    static char* kwlist[] = {"deep", NULL};
+    int hash_size = 0;
+    static char* kwlist[] = {"deep", "hash_size", NULL};
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i", kwlist, &deep)){
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "i|i", kwlist, &deep, &hash_size)){
         if (!PyErr_Occurred()){
             PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
         }
         return NULL;
     }
 
-    Move moves[256];
-    long long counts[256];
-    
-    int nmoves = Board_PerftAndGetMoves(BOARD(self), deep, moves, counts, 256);
+    PerftMovesResult res;
+    res.nmoves = 0;
+
+    Board board;
+    Board_CopyPosition(BOARD(self), &board);
+
+    long long total;
+    Py_BEGIN_ALLOW_THREADS
+    total = Board_PerftDivide(&board, deep, hash_size, perft_moves_collect, &res);
+    Py_END_ALLOW_THREADS
+
+    Board_FreeExtraOnly(&board);
+
+    if (total < 0){
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    Move* moves = res.moves;
+    long long* counts = res.counts;
+    int nmoves = res.nmoves;
     
     // Create dictionary
     PyObject* dict = PyDict_New();
@@ -192,9 +254,97 @@ board_perft_moves(PyObject* self, PyObject* args, PyObject* kwargs){
     
     return dict;
 }
+PYBOARD_LOCKED_KWARGS(board_perft_moves)
 
 PyObject*
-board_generate_legal_moves(PyObject* self, PyObject* args, PyObject* kwargs){
+search_result_to_tuple(const SearchResult* result, int res){
+    PyObject* pv = moves_to_list((Move*)result->pv, result->pv_len);
+    if (!pv)
+        return NULL;
+
+    PyObject* best;
+    if (res == 0){
+        best = (PyObject*)PyMove_FromMove(result->best_move);
+        if (!best){
+            Py_DECREF(pv);
+            return NULL;
+        }
+    }
+    else{
+        best = Py_None;
+        Py_INCREF(best);
+    }
+
+    return Py_BuildValue("(NiN)", best, result->score, pv);
+}
+
+NCH_STATIC PyObject*
+board_search_impl(PyObject* self, PyObject* args, PyObject* kwargs){
+    SearchLimits limits = {0, 0, 0};
+    int hash_size = 16;
+    PyObject* network = NULL;
+    NCH_STATIC char* kwlist[] = {"depth", "movetime", "nodes", "hash_size", "network", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|idLiO!", kwlist, &limits.depth,
+                                     &limits.movetime, &limits.nodes, &hash_size,
+                                     &PyNNUENetworkType, &network)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    if (limits.depth <= 0 && limits.movetime <= 0 && limits.nodes <= 0){
+        PyErr_SetString(PyExc_ValueError, "at least one of depth, movetime and nodes must be set");
+        return NULL;
+    }
+
+    if (hash_size < 0){
+        PyErr_SetString(PyExc_ValueError, "hash_size must not be negative");
+        return NULL;
+    }
+
+    // the search runs on a copy with the GIL released. the history is
+    // copied too so the repetitions of the game are seen.
+    Board board;
+    if (Board_Copy(BOARD(self), &board) < 0){
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    // the search evaluates with the network if the copy has an accumulator
+    NNUEAccumulator acc;
+    if (network)
+        NNUE_Attach(&board, &acc, ((PyNNUENetwork*)network)->net);
+
+    TransTable tt;
+    if (hash_size && TT_Init(&tt, hash_size) < 0){
+        Board_FreeExtraOnly(&board);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    SearchResult result;
+    int res;
+    Py_BEGIN_ALLOW_THREADS
+    res = Board_Search(&board, &limits, hash_size ? &tt : NULL, NULL, NULL, &result);
+    Py_END_ALLOW_THREADS
+
+    if (hash_size)
+        TT_Free(&tt);
+    Board_FreeExtraOnly(&board);
+
+    if (res < 0){
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    return search_result_to_tuple(&result, res);
+}
+PYBOARD_LOCKED_KWARGS(board_search)
+
+NCH_STATIC PyObject*
+board_generate_legal_moves_impl(PyObject* self, PyObject* args, PyObject* kwargs){
     int as_set = 0;
     NCH_STATIC char* kwlist[] = {"as_set", NULL};
     if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|p", kwlist, &as_set)){
@@ -212,6 +362,7 @@ board_generate_legal_moves(PyObject* self, PyObject* args, PyObject* kwargs){
     }
     return moves_to_list(moves, nmoves);
 }
+PYBOARD_LOCKED_KWARGS(board_generate_legal_moves)
 
 NCH_STATIC_INLINE void
 board2tensor(Board* board, int* tensor, int reversed){
@@ -324,8 +475,8 @@ board_as_table(PyObject* self, PyObject* args, PyObject* kwargs) {
     return array;
 }
 
-PyObject*
-board_on_square(PyObject* self, PyObject* args){
+NCH_STATIC PyObject*
+board_on_square_impl(PyObject* self, PyObject* args){
     PyObject* s;
 
     if (!PyArg_ParseTuple(args, "O", &s)){
@@ -341,9 +492,10 @@ board_on_square(PyObject* self, PyObject* args){
     Piece p = Board_ON_SQUARE(BOARD(self), sqr);
     return piece_to_pyobject(p);
 }
+PYBOARD_LOCKED_ARGS(board_on_square)
 
-PyObject*
-board_owned_by(PyObject* self, PyObject* args){
+NCH_STATIC PyObject*
+board_owned_by_impl(PyObject* self, PyObject* args){
     PyObject* s;
 
     if (!PyArg_ParseTuple(args, "O", &s)){
@@ -359,10 +511,13 @@ board_owned_by(PyObject* self, PyObject* args){
     Side side = Board_OWNED_BY(BOARD(self), sqr);
     return side_to_pyobject(side);
 }
+PYBOARD_LOCKED_ARGS(board_owned_by)
 
-PyObject*
-board_get_played_moves(PyObject* self, PyObject* args){
-    int nmoves = Board_NMOVES(BOARD(self));
+NCH_STATIC PyObject*
+board_get_played_moves_impl(PyObject* self, PyObject* args){
+    // the history could be shorter than the number of moves when the board
+    // is loaded from a fen or copied without its history.
+    int nmoves = Board_MOVELIST(BOARD(self)).len;
 
     PyObject* list = PyList_New(nmoves);
     if (!list){
@@ -397,15 +552,17 @@ board_get_played_moves(PyObject* self, PyObject* args){
 
     return list;
 }
+PYBOARD_LOCKED_ARGS(board_get_played_moves)
 
-PyObject*
-board_reset(PyObject* self, PyObject* args){
+NCH_STATIC PyObject*
+board_reset_impl(PyObject* self, PyObject* args){
     Board_Reset(BOARD(self));
     Py_RETURN_NONE;
 }
+PYBOARD_LOCKED_ARGS(board_reset)
 
-PyObject*
-board_get_attackers_map(PyObject* self, PyObject* args, PyObject* kwargs){
+NCH_STATIC PyObject*
+board_get_attackers_map_impl(PyObject* self, PyObject* args, PyObject* kwargs){
     PyObject* sqr;
     PyObject* side_obj = NULL;
     static char* kwlist[] = {"square", "attacker_side", NULL};
@@ -441,9 +598,10 @@ board_get_attackers_map(PyObject* self, PyObject* args, PyObject* kwargs){
     uint64 attack_map = get_checkmap(b, side, s, all_occ);
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(attack_map);
 }
+PYBOARD_LOCKED_KWARGS(board_get_attackers_map)
 
-PyObject*
-board_get_moves_of(PyObject* self, PyObject* args, PyObject* kwargs){
+NCH_STATIC PyObject*
+board_get_moves_of_impl(PyObject* self, PyObject* args, PyObject* kwargs){
     int as_set = 0;
     PyObject* sqr;
     static char* kwlist[] = {"square", "as_set", NULL};
@@ -468,11 +626,23 @@ board_get_moves_of(PyObject* self, PyObject* args, PyObject* kwargs){
 
     return moves_to_list(moves, n);
 }
+PYBOARD_LOCKED_KWARGS(board_get_moves_of)
+
+NCH_STATIC PyObject*
+board_copy_impl(PyObject* self, PyObject* args, PyObject* kwargs){
+    int history = 1;
+    static char* kwlist[] = {"history", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|p", kwlist, &history)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
 
-PyObject*
-board_copy(PyObject* self, PyObject* args){
     Board* src = BOARD(self);
-    Board* dst = Board_NewCopy(src);
+    Board* dst = history ? Board_NewCopy(src)
+                         : Board_NewCopyPosition(src);
     if (!dst){
         PyErr_NoMemory();
         return NULL;
@@ -486,9 +656,10 @@ board_copy(PyObject* self, PyObject* args){
 
     return (PyObject*)pyb;
 }
+PYBOARD_LOCKED_KWARGS(board_copy)
 
-PyObject*
-board_get_game_state(PyObject* self, PyObject* args, PyObject* kwargs){
+NCH_STATIC PyObject*
+board_get_game_state_impl(PyObject* self, PyObject* args, PyObject* kwargs){
     int can_move = -1;
     static char* kwlist[] = {"can_move", NULL};
 
@@ -503,9 +674,10 @@ board_get_game_state(PyObject* self, PyObject* args, PyObject* kwargs){
     GameState state = Board_State(BOARD(self), can_move);
     return PyLong_FromUnsignedLong(state);
 }
+PYBOARD_LOCKED_KWARGS(board_get_game_state)
 
-PyObject*
-board_find(PyObject* self, PyObject* args, PyObject* kwargs){
+NCH_STATIC PyObject*
+board_find_impl(PyObject* self, PyObject* args, PyObject* kwargs){
     PyObject* p_obj;
     static char* kwlist[] = {"piece", NULL};
 
@@ -547,16 +719,18 @@ board_find(PyObject* self, PyObject* args, PyObject* kwargs){
 
     return list;
 }
+PYBOARD_LOCKED_KWARGS(board_find)
 
-PyObject*
-board_fen(PyObject* self, PyObject* args, PyObject* kwargs){
+NCH_STATIC PyObject*
+board_fen_impl(PyObject* self, PyObject* args, PyObject* kwargs){
     char buffer[400];
     Board_AsFen(BOARD(self), buffer);
     return PyUnicode_FromString(buffer);
 }
+PYBOARD_LOCKED_KWARGS(board_fen)
 
-PyObject*
-board_get_occ(PyObject* self, PyObject* args, PyObject* kwargs){
+NCH_STATIC PyObject*
+board_get_occ_impl(PyObject* self, PyObject* args, PyObject* kwargs){
     PyObject* side_obj;
     NCH_STATIC char* kwlist[] = {"side", NULL};
 
@@ -578,9 +752,10 @@ board_get_occ(PyObject* self, PyObject* args, PyObject* kwargs){
     uint64 bb = Board_OCC(BOARD(self), side);
     return (PyObject*)PyBitBoard_FromUnsignedLongLong(bb);
 }
+PYBOARD_LOCKED_KWARGS(board_get_occ)
 
-PyObject*
-board_is_move_legal(PyObject* self, PyObject* args, PyObject* kwargs){
+NCH_STATIC PyObject*
+board_is_move_legal_impl(PyObject* self, PyObject* args, PyObject* kwargs){
     PyObject* move_obj;
     NCH_STATIC char* kwlist[] = {"move", NULL};
 
@@ -598,9 +773,10 @@ board_is_move_legal(PyObject* self, PyObject* args, PyObject* kwargs){
 
     return PyBool_FromLong(Board_IsMoveLegal(BOARD(self), move));
 }
+PYBOARD_LOCKED_KWARGS(board_is_move_legal)
 
-PyObject*
-board_make_move_legal(PyObject* self, PyObject* args, PyObject* kwargs){
+NCH_STATIC PyObject*
+board_make_move_legal_impl(PyObject* self, PyObject* args, PyObject* kwargs){
     PyObject* move_obj;
     NCH_STATIC char* kwlist[] = {"move", NULL};
 
@@ -623,24 +799,329 @@ board_make_move_legal(PyObject* self, PyObject* args, PyObject* kwargs){
 
     return PyMove_FromMove(move);
 }
+PYBOARD_LOCKED_KWARGS(board_make_move_legal)
+
+NCH_STATIC PyObject*
+board_encode_into_impl(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* buf_obj;
+    Py_ssize_t offset = 0;
+    int reversed = 0;
+    NCH_STATIC char* kwlist[] = {"buf", "offset", "reversed", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|np", kwlist, &buf_obj, &offset, &reversed)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    Py_buffer view;
+    EncodeType type;
+    if (encode_get_buffer(buf_obj, &view, &type, 0) < 0){
+        return NULL;
+    }
+
+    if (encode_check_space(&view, offset, encode_board_size(type)) < 0){
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    encode_board(BOARD(self), (char*)view.buf + offset * view.itemsize, type, reversed);
+    PyBuffer_Release(&view);
+
+    return PyLong_FromSsize_t(offset + encode_board_size(type));
+}
+PYBOARD_LOCKED_KWARGS(board_encode_into)
+
+NCH_STATIC PyObject*
+board_legal_moves_array_impl(PyObject* self, PyObject* args){
+    Move moves[256];
+    int nmoves = Board_GenerateLegalMoves(BOARD(self), moves);
+
+    // at least one item is allocated so a board without moves still owns its data
+    Move* data = (Move*)malloc((nmoves ? nmoves : 1) * sizeof(Move));
+    if (!data){
+        PyErr_NoMemory();
+        return NULL;
+    }
+    memcpy(data, moves, nmoves * sizeof(Move));
+
+    npy_intp dims[1] = {nmoves};
+    PyObject* array = create_numpy_array(data, dims, 1, NPY_UINT16);
+    if (!array){
+        free(data);
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_RuntimeError, "Failed to create array");
+        }
+        return NULL;
+    }
+
+    return array;
+}
+PYBOARD_LOCKED_ARGS(board_legal_moves_array)
+
+NCH_STATIC PyObject*
+board_legal_move_mask_impl(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* out_obj = NULL;
+    NCH_STATIC char* kwlist[] = {"out", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", kwlist, &out_obj)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the out argument");
+        }
+        return NULL;
+    }
+
+    if (!out_obj || Py_IsNone(out_obj)){
+        uint8* data = (uint8*)malloc(ENCODE_MOVE_MASK_SIZE);
+        if (!data){
+            PyErr_NoMemory();
+            return NULL;
+        }
+
+        encode_legal_mask(BOARD(self), data, Encode_UInt8);
+
+        npy_intp dims[1] = {ENCODE_MOVE_MASK_SIZE};
+        PyObject* array = create_numpy_array(data, dims, 1, NPY_BOOL);
+        if (!array){
+            free(data);
+            if (!PyErr_Occurred()){
+                PyErr_SetString(PyExc_RuntimeError, "Failed to create array");
+            }
+            return NULL;
+        }
+
+        return array;
+    }
+
+    Py_buffer view;
+    EncodeType type;
+    if (encode_get_buffer(out_obj, &view, &type, 1) < 0){
+        return NULL;
+    }
+
+    if (encode_check_space(&view, 0, encode_mask_size(type)) < 0){
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    encode_legal_mask(BOARD(self), view.buf, type);
+    PyBuffer_Release(&view);
+
+    Py_INCREF(out_obj);
+    return out_obj;
+}
+PYBOARD_LOCKED_KWARGS(board_legal_move_mask)
+
+NCH_STATIC PyObject*
+board_parse_san_impl(PyObject* self, PyObject* args){
+    const char* san;
+
+    if (!PyArg_ParseTuple(args, "s", &san)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    Move move;
+    size_t len = strlen(san);
+    if (len > 32 || Board_MoveFromSAN(BOARD(self), san, (int)len, &move) < 0){
+        PyErr_Format(PyExc_ValueError, "%s is not a legal move of the board", san);
+        return NULL;
+    }
+
+    return (PyObject*)PyMove_FromMove(move);
+}
+PYBOARD_LOCKED_ARGS(board_parse_san)
+
+NCH_STATIC PyObject*
+board_san_impl(PyObject* self, PyObject* args){
+    PyObject* move_obj;
+
+    if (!PyArg_ParseTuple(args, "O", &move_obj)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    Move move;
+    if (!pyobject_as_move(move_obj, &move)){
+        return NULL;
+    }
+
+    char san[NCH_SAN_MAX_LENGTH];
+    if (Move_AsSAN(BOARD(self), move, san) < 0){
+        PyErr_SetString(PyExc_ValueError, "the move is not a legal move of the board");
+        return NULL;
+    }
+
+    return PyUnicode_FromString(san);
+}
+PYBOARD_LOCKED_ARGS(board_san)
+
+NCH_STATIC PyObject*
+board_line_san_impl(PyObject* self, PyObject* args){
+    PyObject* moves_obj;
+
+    if (!PyArg_ParseTuple(args, "O", &moves_obj)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    PyObject* seq = PySequence_Fast(moves_obj, "moves must be a sequence of moves");
+    if (!seq){
+        return NULL;
+    }
+
+    Py_ssize_t nmoves = PySequence_Fast_GET_SIZE(seq);
+    Move* moves = (Move*)malloc((nmoves ? nmoves : 1) * (sizeof(Move) + NCH_SAN_MAX_LENGTH));
+    if (!moves){
+        Py_DECREF(seq);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    char* sans = (char*)(moves + (nmoves ? nmoves : 1));
+
+    // numpy integers (like the items of a uint16 array of moves) are
+    // accepted through __index__
+    PyObject* item;
+    for (Py_ssize_t i = 0; i < nmoves; i++){
+        item = PySequence_Fast_GET_ITEM(seq, i);
+        if (!PyUnicode_Check(item) && !PyMove_Check(item) && !PyLong_Check(item) && PyIndex_Check(item)){
+            Py_ssize_t value = PyNumber_AsSsize_t(item, PyExc_OverflowError);
+            if (value == -1 && PyErr_Occurred()){
+                free(moves);
+                Py_DECREF(seq);
+                return NULL;
+            }
+            moves[i] = (Move)value;
+        }
+        else if (!pyobject_as_move(item, &moves[i])){
+            free(moves);
+            Py_DECREF(seq);
+            return NULL;
+        }
+    }
+    Py_DECREF(seq);
+
+    int nwritten = Board_LineAsSAN(BOARD(self), moves, (int)nmoves, sans);
+    if (nwritten < nmoves){
+        PyErr_Format(PyExc_ValueError, "the move at index %i is not legal", nwritten);
+        free(moves);
+        return NULL;
+    }
+
+    PyObject* list = PyList_New(nmoves);
+    if (!list){
+        free(moves);
+        return NULL;
+    }
+
+    PyObject* str;
+    for (Py_ssize_t i = 0; i < nmoves; i++){
+        str = PyUnicode_FromString(sans + i * NCH_SAN_MAX_LENGTH);
+        if (!str){
+            Py_DECREF(list);
+            free(moves);
+            return NULL;
+        }
+        PyList_SET_ITEM(list, i, str);
+    }
+
+    free(moves);
+    return list;
+}
+PYBOARD_LOCKED_ARGS(board_line_san)
+
+NCH_STATIC PyObject*
+board_pack_impl(PyObject* self, PyObject* args){
+    PackedBoard packed;
+    if (Board_Pack(BOARD(self), &packed) < 0){
+        PyErr_SetString(PyExc_ValueError, "boards with more than 32 pieces could not be packed");
+        return NULL;
+    }
+
+    return PyBytes_FromStringAndSize((const char*)&packed, sizeof(PackedBoard));
+}
+PYBOARD_LOCKED_ARGS(board_pack)
+
+PyObject*
+board_unpack(PyObject* cls, PyObject* args){
+    Py_buffer view;
+
+    if (!PyArg_ParseTuple(args, "y*", &view)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    if (view.len != sizeof(PackedBoard)){
+        PyErr_Format(
+            PyExc_ValueError,
+            "a packed board is %d bytes. got %zd bytes",
+            NCH_PACKED_BOARD_SIZE, view.len
+        );
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    // the buffer could be at any address so it is copied before reading
+    PackedBoard packed;
+    memcpy(&packed, view.buf, sizeof(PackedBoard));
+    PyBuffer_Release(&view);
+
+    Board* board = Board_NewEmpty();
+    if (!board){
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    if (Board_Unpack(&packed, board) < 0){
+        Board_Free(board);
+        PyErr_SetString(PyExc_ValueError, "the packed board is not valid");
+        return NULL;
+    }
+
+    PyObject* pyb = PyBoard_FromBoardWithType((PyTypeObject*)cls, board);
+    if (!pyb){
+        Board_Free(board);
+        return NULL;
+    }
+
+    return pyb;
+}
 
 PyMethodDef pyboard_methods[] = {
     {"undo"                    , (PyCFunction)board_undo                    , METH_NOARGS                  , NULL},
     {"get_played_moves"        , (PyCFunction)board_get_played_moves        , METH_NOARGS                  , NULL},
     {"reset"                   , (PyCFunction)board_reset                   , METH_NOARGS                  , NULL},
-    {"copy"                    , (PyCFunction)board_copy                    , METH_NOARGS                  , NULL},
+    {"copy"                    , (PyCFunction)board_copy                    , METH_VARARGS | METH_KEYWORDS , NULL},
     {"fen"                     , (PyCFunction)board_fen                     , METH_NOARGS                  , NULL},
+    {"pack"                    , (PyCFunction)board_pack                    , METH_NOARGS                  , NULL},
+    {"unpack"                  , (PyCFunction)board_unpack                  , METH_VARARGS | METH_CLASS    , NULL},
 
     {"_makemove"               , (PyCFunction)board__makemove               , METH_VARARGS                 , NULL},
     {"on_square"               , (PyCFunction)board_on_square               , METH_VARARGS                 , NULL},
     {"owned_by"                , (PyCFunction)board_owned_by                , METH_VARARGS                 , NULL},
     
     {"step"                    , (PyCFunction)board_step                    , METH_VARARGS | METH_KEYWORDS , NULL},
+    {"parse_san"               , (PyCFunction)board_parse_san               , METH_VARARGS                 , NULL},
+    {"san"                     , (PyCFunction)board_san                     , METH_VARARGS                 , NULL},
+    {"line_san"                , (PyCFunction)board_line_san                , METH_VARARGS                 , NULL},
     {"perft"                   , (PyCFunction)board_perft                   , METH_VARARGS | METH_KEYWORDS , NULL},
     {"perft_moves"             , (PyCFunction)board_perft_moves             , METH_VARARGS | METH_KEYWORDS , NULL},
+    {"search"                  , (PyCFunction)board_search                  , METH_VARARGS | METH_KEYWORDS , NULL},
     {"generate_legal_moves"    , (PyCFunction)board_generate_legal_moves    , METH_VARARGS | METH_KEYWORDS , NULL},
+    {"legal_moves_array"       , (PyCFunction)board_legal_moves_array       , METH_NOARGS                  , NULL},
+    {"legal_move_mask"         , (PyCFunction)board_legal_move_mask         , METH_VARARGS | METH_KEYWORDS , NULL},
     {"as_array"                , (PyCFunction)board_as_array                , METH_VARARGS | METH_KEYWORDS , NULL},
     {"as_table"                , (PyCFunction)board_as_table                , METH_VARARGS | METH_KEYWORDS , NULL},
+    {"encode_into"             , (PyCFunction)board_encode_into             , METH_VARARGS | METH_KEYWORDS , NULL},
     {"get_attackers_map"       , (PyCFunction)board_get_attackers_map       , METH_VARARGS | METH_KEYWORDS , NULL},
     {"get_moves_of"            , (PyCFunction)board_get_moves_of            , METH_VARARGS | METH_KEYWORDS , NULL},
     {"get_game_state"          , (PyCFunction)board_get_game_state          , METH_VARARGS | METH_KEYWORDS , NULL},
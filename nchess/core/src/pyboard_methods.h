@@ -4,6 +4,14 @@
 #define PY_SSIZE_CLEAN_H
 #include <Python.h>
 
+#include "nchess/search.h"
+
 extern PyMethodDef pyboard_methods[];
 
+// Builds the (move, score, pv) tuple returned by the searches from the
+// result and the return value of the search. The move is None if the
+// board has no legal moves.
+PyObject*
+search_result_to_tuple(const SearchResult* result, int res);
+
 #endif // NCHESS_CORE_PYBOARD_METHODS_H
\ No newline at end of file
@@ -0,0 +1,199 @@
+#include "pyboardbatch.h"
+#include "pyboardbatch_methods.h"
+#include "pyboard.h"
+#include "common.h"
+
+#include "nchess/fen.h"
+
+#define PY_SSIZE_CLEAN_H
+#include <Python.h>
+
+PyBoardBatch*
+boardbatch_alloc(PyTypeObject* type, Py_ssize_t n){
+    PyBoardBatch* batch = (PyBoardBatch*)type->tp_alloc(type, 0);
+    if (!batch){
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    batch->boards = (Board*)calloc(n, sizeof(Board));
+    if (!batch->boards){
+        Py_DECREF(batch);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    batch->nboards = n;
+    Board_Init(&batch->initial);
+    return batch;
+}
+
+PyObject*
+boardbatch_new(PyTypeObject *self, PyObject *args, PyObject *kwargs){
+    Py_ssize_t n;
+    PyObject* fen_obj = NULL;
+    static char* kwlist[] = {"n", "fen", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "n|O", kwlist, &n, &fen_obj)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError ,"failed reading the argmuents");
+        }
+        return NULL;
+    }
+
+    if (n < 1){
+        PyErr_Format(PyExc_ValueError, "number of boards must be positive. got %zd", n);
+        return NULL;
+    }
+
+    PyBoardBatch* batch = boardbatch_alloc(self, n);
+    if (!batch){
+        return NULL;
+    }
+
+    if (fen_obj && !Py_IsNone(fen_obj)){
+        if (!PyUnicode_Check(fen_obj)){
+            PyErr_Format(
+                PyExc_TypeError,
+                "fen must be string. got %s",
+                Py_TYPE(fen_obj)->tp_name
+            );
+            Py_DECREF(batch);
+            return NULL;
+        }
+
+        const char* fen = PyUnicode_AsUTF8(fen_obj);
+        if (!fen){
+            Py_DECREF(batch);
+            return NULL;
+        }
+
+        Board_InitEmpty(&batch->initial);
+        if (Board_FromFen(fen, &batch->initial) < 0){
+            PyErr_SetString(PyExc_ValueError ,"could not read the fen");
+            Py_DECREF(batch);
+            return NULL;
+        }
+    }
+
+    for (Py_ssize_t i = 0; i < n; i++){
+        Board_CopyPosition(&batch->initial, &batch->boards[i]);
+    }
+
+    return (PyObject*)batch;
+}
+
+void
+boardbatch_free(PyObject* self){
+    if (self){
+        PyBoardBatch* batch = (PyBoardBatch*)self;
+        if (batch->boards){
+            for (Py_ssize_t i = 0; i < batch->nboards; i++){
+                Board_FreeExtraOnly(&batch->boards[i]);
+            }
+            free(batch->boards);
+        }
+        if (batch->starts){
+            free(batch->starts);
+        }
+        Py_TYPE(batch)->tp_free(batch);
+    }
+}
+
+int
+boardbatch_acquire(PyBoardBatch* batch, int write){
+    int ok;
+
+#ifdef Py_GIL_DISABLED
+    PyMutex_Lock(&batch->users_mutex);
+#endif
+
+    if (write){
+        ok = batch->users == 0;
+        if (ok)
+            batch->users = -1;
+    }
+    else{
+        ok = batch->users >= 0;
+        if (ok)
+            batch->users++;
+    }
+
+#ifdef Py_GIL_DISABLED
+    PyMutex_Unlock(&batch->users_mutex);
+#endif
+
+    if (!ok){
+        PyErr_SetString(PyExc_RuntimeError,
+            "BoardBatch is being changed or read by another thread");
+        return -1;
+    }
+    return 0;
+}
+
+void
+boardbatch_release(PyBoardBatch* batch, int write){
+#ifdef Py_GIL_DISABLED
+    PyMutex_Lock(&batch->users_mutex);
+#endif
+
+    if (write){
+        batch->users = 0;
+    }
+    else{
+        batch->users--;
+    }
+
+#ifdef Py_GIL_DISABLED
+    PyMutex_Unlock(&batch->users_mutex);
+#endif
+}
+
+Py_ssize_t
+boardbatch_length(PyObject* self){
+    return ((PyBoardBatch*)self)->nboards;
+}
+
+// returns a copy of the board at index i with its history.
+PyObject*
+boardbatch_item(PyObject* self, Py_ssize_t i){
+    PyBoardBatch* batch = (PyBoardBatch*)self;
+    if (i < 0 || i >= batch->nboards){
+        PyErr_SetString(PyExc_IndexError, "board index out of range");
+        return NULL;
+    }
+
+    if (boardbatch_acquire(batch, 0) < 0)
+        return NULL;
+
+    Board* board = Board_NewCopy(&batch->boards[i]);
+    boardbatch_release(batch, 0);
+    if (!board){
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    PyObject* pyb = PyBoard_FromBoard(board);
+    if (!pyb){
+        Board_Free(board);
+        return NULL;
+    }
+
+    return pyb;
+}
+
+static PySequenceMethods boardbatch_as_sequence = {
+    .sq_length = (lenfunc)boardbatch_length,
+    .sq_item = (ssizeargfunc)boardbatch_item,
+};
+
+PyTypeObject PyBoardBatchType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "BoardBatch",
+    .tp_basicsize = sizeof(PyBoardBatch),
+    .tp_dealloc = (destructor)boardbatch_free,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = (newfunc)boardbatch_new,
+    .tp_as_sequence = &boardbatch_as_sequence,
+    .tp_methods = pyboardbatch_methods,
+};
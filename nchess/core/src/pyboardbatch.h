@@ -0,0 +1,50 @@
+#ifndef NCHESS_CORE_PYBOARDBATCH_H
+#define NCHESS_CORE_PYBOARDBATCH_H
+
+#define PY_SSIZE_CLEAN_H
+#include <Python.h>
+
+#include "nchess/board.h"
+
+// A batch of boards stored in one contiguous array. Its methods work
+// on all the boards in a single call.
+typedef struct
+{
+    PyObject_HEAD
+    Board* boards;
+    Py_ssize_t nboards;
+    Board initial; // the position reset goes back to. it has no history.
+
+    // the position of every board reset goes back to if the boards do not
+    // start from the same position (see BoardBatch.from_fens and
+    // BoardBatch.from_packed). NULL otherwise.
+    Board* starts;
+
+    // the number of methods reading the boards or -1 if a method is
+    // changing them. see boardbatch_acquire.
+    int users;
+#ifdef Py_GIL_DISABLED
+    PyMutex users_mutex;
+#endif
+}PyBoardBatch;
+
+extern PyTypeObject PyBoardBatchType;
+
+// allocates a batch of n empty boards. returns NULL with a python error set on failure.
+PyBoardBatch*
+boardbatch_alloc(PyTypeObject* type, Py_ssize_t n);
+
+// The methods of the batch release the GIL while looping over the boards so
+// another thread could call a method of the same batch meanwhile. Every method
+// acquires the batch before touching the boards and releases it after.
+// Many methods could read the boards at once but a method that changes them
+// (write is 1) must be the only user. Both functions must be called while
+// holding the GIL.
+// returns 0 on success and -1 with a RuntimeError set if the batch is in use.
+int
+boardbatch_acquire(PyBoardBatch* batch, int write);
+
+void
+boardbatch_release(PyBoardBatch* batch, int write);
+
+#endif // NCHESS_CORE_PYBOARDBATCH_H
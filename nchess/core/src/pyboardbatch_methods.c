@@ -0,0 +1,618 @@
+#include "pyboardbatch_methods.h"
+#include "pyboardbatch.h"
+#include "nchess/nchess.h"
+#include "common.h"
+#include "bb_functions.h"
+#include "encoding.h"
+#include "array_conversion.h"
+
+#include "nchess/fen.h"
+
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+
+#define BATCH(self) ((PyBoardBatch*)self)
+
+// numpy has to be imported once in every file that uses its C API.
+NCH_STATIC int
+batch_import_numpy(void){
+    if (!PyArray_API){
+        import_array1(-1);
+    }
+    return 0;
+}
+
+// converts obj to a contiguous one dimensional array with n items of the given type.
+// returns a new reference or NULL on failure.
+NCH_STATIC PyArrayObject*
+batch_vector_from_object(PyObject* obj, Py_ssize_t n, int dtype, const char* name){
+    PyArrayObject* arr = (PyArrayObject*)PyArray_FROMANY(obj, dtype, 1, 1, NPY_ARRAY_IN_ARRAY | NPY_ARRAY_FORCECAST);
+    if (!arr){
+        return NULL;
+    }
+
+    if (PyArray_DIM(arr, 0) != n){
+        PyErr_Format(PyExc_ValueError,
+            "%s expected to have %zd items, one for each board. got %zd",
+            name, n, (Py_ssize_t)PyArray_DIM(arr, 0));
+        Py_DECREF(arr);
+        return NULL;
+    }
+
+    return arr;
+}
+
+// puts the board at index i back to its starting position. the buffer
+// of the history is kept to be reused by the next moves.
+NCH_STATIC_INLINE void
+batch_reset_board(PyBoardBatch* batch, Py_ssize_t i){
+    Board* board = &batch->boards[i];
+    MoveList movelist = Board_MOVELIST(board);
+    *board = batch->starts ? batch->starts[i] : batch->initial;
+    MoveList_Reset(&movelist);
+    Board_MOVELIST(board) = movelist;
+}
+
+PyObject*
+boardbatch_step(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* moves_obj;
+    static char* kwlist[] = {"moves", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &moves_obj)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the moves argument");
+        }
+        return NULL;
+    }
+
+    if (batch_import_numpy() < 0)
+        return NULL;
+
+    PyBoardBatch* batch = BATCH(self);
+    PyArrayObject* moves_arr = batch_vector_from_object(moves_obj, batch->nboards, NPY_UINT16, "moves");
+    if (!moves_arr)
+        return NULL;
+
+    npy_intp dims[1] = {batch->nboards};
+    PyArrayObject* out = (PyArrayObject*)PyArray_SimpleNew(1, dims, NPY_BOOL);
+    if (!out){
+        Py_DECREF(moves_arr);
+        return NULL;
+    }
+
+    const Move* moves = (const Move*)PyArray_DATA(moves_arr);
+    npy_bool* played = (npy_bool*)PyArray_DATA(out);
+
+    if (boardbatch_acquire(batch, 1) < 0){
+        Py_DECREF(moves_arr);
+        Py_DECREF(out);
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    for (Py_ssize_t i = 0; i < batch->nboards; i++){
+        played[i] = (npy_bool)Board_StepByMove(&batch->boards[i], moves[i]);
+    }
+    Py_END_ALLOW_THREADS
+
+    boardbatch_release(batch, 1);
+
+    Py_DECREF(moves_arr);
+    return (PyObject*)out;
+}
+
+PyObject*
+boardbatch_legal_move_masks(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* out_obj = NULL;
+    static char* kwlist[] = {"out", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", kwlist, &out_obj)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the out argument");
+        }
+        return NULL;
+    }
+
+    if (batch_import_numpy() < 0)
+        return NULL;
+
+    PyBoardBatch* batch = BATCH(self);
+    PyObject* out;
+    Py_buffer view;
+    EncodeType type;
+
+    if (!out_obj || Py_IsNone(out_obj)){
+        npy_intp dims[2] = {batch->nboards, ENCODE_MOVE_MASK_SIZE};
+        out = PyArray_SimpleNew(2, dims, NPY_BOOL);
+        if (!out)
+            return NULL;
+    }
+    else{
+        Py_INCREF(out_obj);
+        out = out_obj;
+    }
+
+    if (encode_get_buffer(out, &view, &type, 1) < 0){
+        Py_DECREF(out);
+        return NULL;
+    }
+
+    Py_ssize_t mask_size = encode_mask_size(type);
+    if (encode_check_space(&view, 0, mask_size * batch->nboards) < 0){
+        PyBuffer_Release(&view);
+        Py_DECREF(out);
+        return NULL;
+    }
+
+    if (boardbatch_acquire(batch, 0) < 0){
+        PyBuffer_Release(&view);
+        Py_DECREF(out);
+        return NULL;
+    }
+
+    char* data = (char*)view.buf;
+
+    Py_BEGIN_ALLOW_THREADS
+    for (Py_ssize_t i = 0; i < batch->nboards; i++){
+        encode_legal_mask(&batch->boards[i], data, type);
+        data += mask_size * view.itemsize;
+    }
+    Py_END_ALLOW_THREADS
+
+    boardbatch_release(batch, 0);
+
+    PyBuffer_Release(&view);
+    return out;
+}
+
+PyObject*
+boardbatch_game_states(PyObject* self, PyObject* args){
+    if (batch_import_numpy() < 0)
+        return NULL;
+
+    PyBoardBatch* batch = BATCH(self);
+    npy_intp dims[1] = {batch->nboards};
+    PyArrayObject* out = (PyArrayObject*)PyArray_SimpleNew(1, dims, NPY_UINT8);
+    if (!out)
+        return NULL;
+
+    npy_uint8* states = (npy_uint8*)PyArray_DATA(out);
+
+    if (boardbatch_acquire(batch, 0) < 0){
+        Py_DECREF(out);
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    Board* board;
+    for (Py_ssize_t i = 0; i < batch->nboards; i++){
+        board = &batch->boards[i];
+        states[i] = (npy_uint8)Board_State(board, Board_CanMove(board));
+    }
+    Py_END_ALLOW_THREADS
+
+    boardbatch_release(batch, 0);
+
+    return (PyObject*)out;
+}
+
+PyObject*
+boardbatch_reset(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* mask_obj = NULL;
+    static char* kwlist[] = {"mask", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O", kwlist, &mask_obj)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the mask argument");
+        }
+        return NULL;
+    }
+
+    PyBoardBatch* batch = BATCH(self);
+
+    if (!mask_obj || Py_IsNone(mask_obj)){
+        if (boardbatch_acquire(batch, 1) < 0)
+            return NULL;
+
+        Py_BEGIN_ALLOW_THREADS
+        for (Py_ssize_t i = 0; i < batch->nboards; i++){
+            batch_reset_board(batch, i);
+        }
+        Py_END_ALLOW_THREADS
+
+        boardbatch_release(batch, 1);
+
+        Py_RETURN_NONE;
+    }
+
+    if (batch_import_numpy() < 0)
+        return NULL;
+
+    PyArrayObject* mask_arr = batch_vector_from_object(mask_obj, batch->nboards, NPY_BOOL, "mask");
+    if (!mask_arr)
+        return NULL;
+
+    const npy_bool* mask = (const npy_bool*)PyArray_DATA(mask_arr);
+
+    if (boardbatch_acquire(batch, 1) < 0){
+        Py_DECREF(mask_arr);
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    for (Py_ssize_t i = 0; i < batch->nboards; i++){
+        if (mask[i])
+            batch_reset_board(batch, i);
+    }
+    Py_END_ALLOW_THREADS
+
+    boardbatch_release(batch, 1);
+
+    Py_DECREF(mask_arr);
+    Py_RETURN_NONE;
+}
+
+PyObject*
+boardbatch_as_array(PyObject* self, PyObject* args, PyObject* kwargs){
+    int reversed = 0;
+    static char* kwlist[] = {"reversed", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|p", kwlist, &reversed)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    if (batch_import_numpy() < 0)
+        return NULL;
+
+    PyBoardBatch* batch = BATCH(self);
+    npy_intp dims[3] = {batch->nboards, NCH_PIECE_NB - 1, NCH_SQUARE_NB};
+    PyArrayObject* out = (PyArrayObject*)PyArray_SimpleNew(3, dims, NPY_INT);
+    if (!out)
+        return NULL;
+
+    int* data = (int*)PyArray_DATA(out);
+
+    if (boardbatch_acquire(batch, 0) < 0){
+        Py_DECREF(out);
+        return NULL;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    for (Py_ssize_t i = 0; i < batch->nboards; i++){
+        for (Piece p = NCH_WPawn; p < NCH_PIECE_NB; p++){
+            bb2array(Board_BB(&batch->boards[i], p), data, reversed);
+            data += NCH_SQUARE_NB;
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    boardbatch_release(batch, 0);
+
+    return (PyObject*)out;
+}
+
+PyObject*
+boardbatch_encode_into(PyObject* self, PyObject* args, PyObject* kwargs){
+    PyObject* buf_obj;
+    Py_ssize_t offset = 0;
+    int reversed = 0;
+    static char* kwlist[] = {"buf", "offset", "reversed", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|np", kwlist, &buf_obj, &offset, &reversed)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    PyBoardBatch* batch = BATCH(self);
+    Py_buffer view;
+    EncodeType type;
+    if (encode_get_buffer(buf_obj, &view, &type, 0) < 0)
+        return NULL;
+
+    if (encode_check_space(&view, offset, encode_board_size(type) * batch->nboards) < 0){
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    if (boardbatch_acquire(batch, 0) < 0){
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    Py_ssize_t board_bytes = encode_board_size(type) * view.itemsize;
+    char* out = (char*)view.buf + offset * view.itemsize;
+
+    Py_BEGIN_ALLOW_THREADS
+    for (Py_ssize_t i = 0; i < batch->nboards; i++){
+        encode_board(&batch->boards[i], out, type, reversed);
+        out += board_bytes;
+    }
+    Py_END_ALLOW_THREADS
+
+    boardbatch_release(batch, 0);
+
+    PyBuffer_Release(&view);
+    return PyLong_FromSsize_t(offset + encode_board_size(type) * batch->nboards);
+}
+
+// returns a new batch with a board for every non empty line of data and an
+// array of the line numbers that could not be read.
+PyObject*
+boardbatch_from_fens(PyObject* cls, PyObject* args, PyObject* kwargs){
+    PyObject* data_obj;
+    int threads = 0;
+    static char* kwlist[] = {"data", "threads", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|i", kwlist, &data_obj, &threads)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    if (batch_import_numpy() < 0)
+        return NULL;
+
+    // str is read as utf-8, anything else (bytes, mmap, ...) through the buffer protocol
+    Py_buffer view;
+    const char* buffer;
+    Py_ssize_t len;
+    int has_view = 0;
+
+    if (PyUnicode_Check(data_obj)){
+        buffer = PyUnicode_AsUTF8AndSize(data_obj, &len);
+        if (!buffer)
+            return NULL;
+    }
+    else{
+        if (PyObject_GetBuffer(data_obj, &view, PyBUF_SIMPLE) < 0)
+            return NULL;
+        buffer = (const char*)view.buf;
+        len = view.len;
+        has_view = 1;
+    }
+
+    long long nboards;
+    Py_BEGIN_ALLOW_THREADS
+    nboards = Board_CountFenLines(buffer, (size_t)len, threads);
+    Py_END_ALLOW_THREADS
+
+    PyBoardBatch* batch = NULL;
+    int* status = NULL;
+    long long* lines = NULL;
+    PyObject* errors = NULL;
+
+    if (nboards < 0){
+        PyErr_NoMemory();
+        goto end;
+    }
+    if (!nboards){
+        PyErr_SetString(PyExc_ValueError, "no fen found in the data");
+        goto end;
+    }
+
+    batch = boardbatch_alloc((PyTypeObject*)cls, (Py_ssize_t)nboards);
+    if (!batch)
+        goto end;
+
+    batch->starts = (Board*)malloc(nboards * sizeof(Board));
+    status = (int*)malloc(nboards * sizeof(int));
+    lines = (long long*)malloc(nboards * sizeof(long long));
+    if (!batch->starts || !status || !lines){
+        PyErr_NoMemory();
+        goto end;
+    }
+
+    long long nread;
+    Py_BEGIN_ALLOW_THREADS
+    nread = Board_FromFenLines(buffer, (size_t)len, batch->boards, status, lines, nboards, threads);
+    if (nread >= 0)
+        memcpy(batch->starts, batch->boards, nboards * sizeof(Board));
+    Py_END_ALLOW_THREADS
+
+    if (nread < 0){
+        PyErr_NoMemory();
+        goto end;
+    }
+
+    npy_intp nerrors = 0;
+    for (long long i = 0; i < nread; i++){
+        nerrors += status[i] != 0;
+    }
+
+    errors = PyArray_SimpleNew(1, &nerrors, NPY_INT64);
+    if (!errors)
+        goto end;
+
+    npy_int64* error_lines = (npy_int64*)PyArray_DATA((PyArrayObject*)errors);
+    for (long long i = 0; i < nread; i++){
+        if (status[i] != 0)
+            *error_lines++ = lines[i];
+    }
+
+    end:
+        if (has_view)
+            PyBuffer_Release(&view);
+        free(status);
+        free(lines);
+
+        if (!errors){
+            Py_XDECREF(batch);
+            return NULL;
+        }
+
+        PyObject* out = PyTuple_Pack(2, (PyObject*)batch, errors);
+        Py_DECREF(batch);
+        Py_DECREF(errors);
+        return out;
+}
+
+PyObject*
+boardbatch_to_fens(PyObject* self, PyObject* args){
+    PyBoardBatch* batch = BATCH(self);
+
+    char* buffer = (char*)malloc(batch->nboards * NCH_FEN_MAX_LENGTH);
+    if (!buffer){
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    if (boardbatch_acquire(batch, 0) < 0){
+        free(buffer);
+        return NULL;
+    }
+
+    long long len;
+    Py_BEGIN_ALLOW_THREADS
+    len = Board_AsFenLines(batch->boards, batch->nboards, buffer, 0);
+    Py_END_ALLOW_THREADS
+
+    boardbatch_release(batch, 0);
+
+    if (len < 0){
+        free(buffer);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    PyObject* out = PyUnicode_DecodeASCII(buffer, (Py_ssize_t)len, NULL);
+    free(buffer);
+    return out;
+}
+
+PyObject*
+boardbatch_pack(PyObject* self, PyObject* args){
+    if (batch_import_numpy() < 0)
+        return NULL;
+
+    PyArray_Descr* descr = packed_board_descr();
+    if (!descr)
+        return NULL;
+
+    PyBoardBatch* batch = BATCH(self);
+    npy_intp dims[1] = {batch->nboards};
+    PyArrayObject* out = (PyArrayObject*)PyArray_NewFromDescr(&PyArray_Type, descr, 1, dims, NULL, NULL, 0, NULL);
+    if (!out)
+        return NULL;
+
+    if (boardbatch_acquire(batch, 0) < 0){
+        Py_DECREF(out);
+        return NULL;
+    }
+
+    PackedBoard* packed = (PackedBoard*)PyArray_DATA(out);
+    Py_ssize_t failed = -1;
+
+    Py_BEGIN_ALLOW_THREADS
+    for (Py_ssize_t i = 0; i < batch->nboards; i++){
+        if (Board_Pack(&batch->boards[i], &packed[i]) < 0){
+            failed = i;
+            break;
+        }
+    }
+    Py_END_ALLOW_THREADS
+
+    boardbatch_release(batch, 0);
+
+    if (failed >= 0){
+        PyErr_Format(
+            PyExc_ValueError,
+            "the board at index %zd has more than 32 pieces and could not be packed",
+            failed
+        );
+        Py_DECREF(out);
+        return NULL;
+    }
+
+    return (PyObject*)out;
+}
+
+PyObject*
+boardbatch_from_packed(PyObject* cls, PyObject* args){
+    Py_buffer view;
+
+    if (!PyArg_ParseTuple(args, "y*", &view)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    if (view.len % sizeof(PackedBoard)){
+        PyErr_Format(
+            PyExc_ValueError,
+            "the size of the data must be a multiple of %d bytes. got %zd bytes",
+            NCH_PACKED_BOARD_SIZE, view.len
+        );
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    Py_ssize_t n = view.len / sizeof(PackedBoard);
+    if (!n){
+        PyErr_SetString(PyExc_ValueError, "no packed board found in the data");
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    PyBoardBatch* batch = boardbatch_alloc((PyTypeObject*)cls, n);
+    if (!batch){
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+
+    batch->starts = (Board*)malloc(n * sizeof(Board));
+    if (!batch->starts){
+        PyBuffer_Release(&view);
+        Py_DECREF(batch);
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    const char* data = (const char*)view.buf;
+    Py_ssize_t failed = -1;
+
+    Py_BEGIN_ALLOW_THREADS
+    PackedBoard packed;
+    for (Py_ssize_t i = 0; i < n; i++){
+        // the buffer could be at any address so every item is copied before reading
+        memcpy(&packed, data + i * sizeof(PackedBoard), sizeof(PackedBoard));
+        if (Board_Unpack(&packed, &batch->boards[i]) < 0){
+            failed = i;
+            break;
+        }
+    }
+    if (failed < 0)
+        memcpy(batch->starts, batch->boards, n * sizeof(Board));
+    Py_END_ALLOW_THREADS
+
+    PyBuffer_Release(&view);
+
+    if (failed >= 0){
+        PyErr_Format(PyExc_ValueError, "the packed board at index %zd is not valid", failed);
+        Py_DECREF(batch);
+        return NULL;
+    }
+
+    return (PyObject*)batch;
+}
+
+PyMethodDef pyboardbatch_methods[] = {
+    {"step"                    , (PyCFunction)boardbatch_step               , METH_VARARGS | METH_KEYWORDS , NULL},
+    {"legal_move_masks"        , (PyCFunction)boardbatch_legal_move_masks   , METH_VARARGS | METH_KEYWORDS , NULL},
+    {"game_states"             , (PyCFunction)boardbatch_game_states        , METH_NOARGS                  , NULL},
+    {"reset"                   , (PyCFunction)boardbatch_reset              , METH_VARARGS | METH_KEYWORDS , NULL},
+    {"as_array"                , (PyCFunction)boardbatch_as_array           , METH_VARARGS | METH_KEYWORDS , NULL},
+    {"encode_into"             , (PyCFunction)boardbatch_encode_into        , METH_VARARGS | METH_KEYWORDS , NULL},
+    {"to_fens"                 , (PyCFunction)boardbatch_to_fens            , METH_NOARGS                  , NULL},
+    {"from_fens"               , (PyCFunction)boardbatch_from_fens          , METH_VARARGS | METH_KEYWORDS | METH_CLASS, NULL},
+    {"pack"                    , (PyCFunction)boardbatch_pack               , METH_NOARGS                  , NULL},
+    {"from_packed"             , (PyCFunction)boardbatch_from_packed        , METH_VARARGS | METH_CLASS    , NULL},
+
+    {NULL                      , NULL                                       , 0                            , NULL},
+};
@@ -0,0 +1,9 @@
+#ifndef NCHESS_CORE_PYBOARDBATCH_METHODS_H
+#define NCHESS_CORE_PYBOARDBATCH_METHODS_H
+
+#define PY_SSIZE_CLEAN_H
+#include <Python.h>
+
+extern PyMethodDef pyboardbatch_methods[];
+
+#endif // NCHESS_CORE_PYBOARDBATCH_METHODS_H
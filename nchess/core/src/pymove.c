@@ -3,9 +3,26 @@
 #include "nchess/nchess.h"
 #include "pymove_getset.h"
 
-PyMove*
-PyMove_FromMove(Move move)
-{
+// Moves are immutable so a single object is kept for every one of the 65536
+// possible values, like the small ints of python. The objects are created the
+// first time they are asked for and never freed.
+NCH_STATIC PyMove* MoveCache[0x10000];
+
+#ifdef Py_GIL_DISABLED
+// taken only to create a missing move. the objects are published with a
+// release store, so a thread that sees one with the acquire load sees it
+// fully created and the hits never lock.
+NCH_STATIC PyMutex MoveCacheMutex;
+
+#define MoveCache_LOAD(move) ((PyMove*)_Py_atomic_load_ptr_acquire(&MoveCache[move]))
+#define MoveCache_STORE(move, obj) _Py_atomic_store_ptr_release(&MoveCache[move], obj)
+#else
+#define MoveCache_LOAD(move) MoveCache[move]
+#define MoveCache_STORE(move, obj) MoveCache[move] = obj
+#endif
+
+NCH_STATIC PyMove*
+move_create(Move move){
     PyObject* args = Py_BuildValue("(k)", (unsigned long)move);
     if (!args) {
         return NULL;
@@ -14,11 +31,36 @@ PyMove_FromMove(Move move)
     PyObject* obj = PyLong_Type.tp_new(&PyMoveType, args, NULL);
     Py_DECREF(args);  // tp_new doesn't steal the reference
     
-    if (!obj) {
-        return NULL;
+    return (PyMove*)obj;
+}
+
+PyMove*
+PyMove_FromMove(Move move)
+{
+    PyMove* obj = MoveCache_LOAD(move);
+    if (obj){
+        Py_INCREF(obj);
+        return obj;
     }
 
-    return (PyMove*)obj;
+#ifdef Py_GIL_DISABLED
+    PyMutex_Lock(&MoveCacheMutex);
+    // another thread could have created it while this one was waiting
+    obj = MoveCache_LOAD(move);
+#endif
+
+    if (!obj){
+        obj = move_create(move);
+        if (obj)
+            MoveCache_STORE(move, obj);
+    }
+    Py_XINCREF(obj);
+
+#ifdef Py_GIL_DISABLED
+    PyMutex_Unlock(&MoveCacheMutex);
+#endif
+
+    return obj;
 }
 
 PyObject*
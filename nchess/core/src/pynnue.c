@@ -0,0 +1,113 @@
+#include "pynnue.h"
+#include "pyboard.h"
+#include "common.h"
+
+PyObject*
+network_new(PyTypeObject* type, PyObject* args, PyObject* kwargs){
+    PyObject* source;
+    static char* kwlist[] = {"source", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", kwlist, &source)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    PyNNUENetwork* self = (PyNNUENetwork*)type->tp_alloc(type, 0);
+    if (!self){
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    self->net = (NNUENetwork*)malloc(sizeof(NNUENetwork));
+    if (!self->net){
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+
+    // a str or a path is the name of a weight file, anything else
+    // (bytes, mmap, ...) is read through the buffer protocol
+    int res;
+    if (PyUnicode_Check(source) || PyObject_HasAttrString(source, "__fspath__")){
+        PyObject* path;
+        if (!PyUnicode_FSConverter(source, &path)){
+            Py_DECREF(self);
+            return NULL;
+        }
+
+        Py_BEGIN_ALLOW_THREADS
+        res = NNUE_Load(self->net, PyBytes_AS_STRING(path));
+        Py_END_ALLOW_THREADS
+
+        if (res == -2){
+            PyErr_SetFromErrnoWithFilenameObject(PyExc_OSError, source);
+            Py_DECREF(path);
+            Py_DECREF(self);
+            return NULL;
+        }
+        Py_DECREF(path);
+    }
+    else{
+        Py_buffer view;
+        if (PyObject_GetBuffer(source, &view, PyBUF_SIMPLE) < 0){
+            Py_DECREF(self);
+            return NULL;
+        }
+        res = NNUE_LoadFromMemory(self->net, view.buf, (size_t)view.len);
+        PyBuffer_Release(&view);
+    }
+
+    if (res < 0){
+        PyErr_SetString(PyExc_ValueError, "the data is not a valid NNUE network");
+        Py_DECREF(self);
+        return NULL;
+    }
+
+    return (PyObject*)self;
+}
+
+void
+network_free(PyObject* self){
+    if (self){
+        PyNNUENetwork* nn = (PyNNUENetwork*)self;
+        free(nn->net);
+        Py_TYPE(nn)->tp_free(nn);
+    }
+}
+
+PyObject*
+network_evaluate(PyObject* self, PyObject* args){
+    PyObject* board_obj;
+
+    if (!PyArg_ParseTuple(args, "O!", &PyBoardType, &board_obj)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    const Board* board = ((PyBoard*)board_obj)->board;
+    NNUEAccumulator acc;
+    int eval;
+    Py_BEGIN_CRITICAL_SECTION(board_obj);
+    NNUE_Refresh(&acc, ((PyNNUENetwork*)self)->net, board);
+    eval = NNUE_Evaluate(&acc, Board_SIDE(board));
+    Py_END_CRITICAL_SECTION();
+    return PyLong_FromLong(eval);
+}
+
+static PyMethodDef network_methods[] = {
+    {"evaluate", (PyCFunction)network_evaluate, METH_VARARGS, NULL},
+    {NULL      , NULL                         , 0           , NULL},
+};
+
+PyTypeObject PyNNUENetworkType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "Network",
+    .tp_basicsize = sizeof(PyNNUENetwork),
+    .tp_dealloc = (destructor)network_free,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = (newfunc)network_new,
+    .tp_methods = network_methods,
+};
@@ -0,0 +1,19 @@
+#ifndef NCHESS_CORE_PYNNUE_H
+#define NCHESS_CORE_PYNNUE_H
+
+#define PY_SSIZE_CLEAN_H
+#include <Python.h>
+
+#include "nchess/nnue.h"
+
+// The weights of an NNUE network. The network is never changed after it is
+// read so the searches of many threads could use it at once.
+typedef struct
+{
+    PyObject_HEAD
+    NNUENetwork* net;
+}PyNNUENetwork;
+
+extern PyTypeObject PyNNUENetworkType;
+
+#endif // NCHESS_CORE_PYNNUE_H
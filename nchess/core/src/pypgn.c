@@ -0,0 +1,305 @@
+#include "pypgn.h"
+#include "common.h"
+#include "array_conversion.h"
+
+#include "nchess/thread.h"
+
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+
+#include <string.h>
+
+// the size of the part of the buffer that is read by every thread at once.
+// a block ends at the first game boundary after it.
+#define PGN_BLOCK_SIZE (1 << 23)
+
+// numpy has to be imported once in every file that uses its C API.
+NCH_STATIC int
+pgn_import_numpy(void){
+    if (!PyArray_API){
+        import_array1(-1);
+    }
+    return 0;
+}
+
+PyObject*
+pgnreader_new(PyTypeObject* type, PyObject* args, PyObject* kwargs){
+    PyObject* data_obj;
+    int threads = 0;
+    int positions = 0;
+    static char* kwlist[] = {"data", "threads", "positions", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|ip", kwlist, &data_obj, &threads, &positions)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    if (pgn_import_numpy() < 0)
+        return NULL;
+
+    PyPGNReader* reader = (PyPGNReader*)type->tp_alloc(type, 0);
+    if (!reader){
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    // str is read as utf-8, anything else (bytes, mmap, ...) through the buffer protocol
+    if (PyUnicode_Check(data_obj)){
+        Py_ssize_t len;
+        reader->buffer = PyUnicode_AsUTF8AndSize(data_obj, &len);
+        if (!reader->buffer){
+            Py_DECREF(reader);
+            return NULL;
+        }
+        reader->len = (size_t)len;
+    }
+    else{
+        if (PyObject_GetBuffer(data_obj, &reader->view, PyBUF_SIMPLE) < 0){
+            Py_DECREF(reader);
+            return NULL;
+        }
+        reader->has_view = 1;
+        reader->buffer = (const char*)reader->view.buf;
+        reader->len = (size_t)reader->view.len;
+    }
+
+    reader->errors = PyList_New(0);
+    if (!reader->errors){
+        Py_DECREF(reader);
+        return NULL;
+    }
+
+    Py_INCREF(data_obj);
+    reader->data = data_obj;
+    reader->threads = threads > 0 ? threads : NCH_CPUCount();
+    reader->positions = positions;
+    return (PyObject*)reader;
+}
+
+void
+pgnreader_free(PyObject* self){
+    if (self){
+        PyPGNReader* reader = (PyPGNReader*)self;
+        PGNGames_Free(&reader->block);
+        if (reader->has_view)
+            PyBuffer_Release(&reader->view);
+        Py_XDECREF(reader->data);
+        Py_XDECREF(reader->errors);
+        Py_TYPE(reader)->tp_free(reader);
+    }
+}
+
+// reads the games of the next block. returns 1 if games are read,
+// 0 at the end of the buffer and -1 with a python error on failure.
+NCH_STATIC int
+pgnreader_read_block(PyPGNReader* reader){
+    PGNGames_Free(&reader->block);
+    reader->next = 0;
+
+    while (reader->pos < reader->len){
+        size_t block_size = (size_t)PGN_BLOCK_SIZE * reader->threads;
+        size_t end = reader->len - reader->pos <= block_size
+                   ? reader->len
+                   : PGN_GameBoundary(reader->buffer, reader->len, reader->pos + block_size);
+
+        int res;
+        Py_BEGIN_ALLOW_THREADS
+        res = PGN_ReadGames(reader->buffer + reader->pos, end - reader->pos,
+                            reader->positions, reader->threads, &reader->block);
+        Py_END_ALLOW_THREADS
+
+        if (res < 0){
+            PyErr_NoMemory();
+            return -1;
+        }
+
+        reader->pos = end;
+        if (reader->block.ngames)
+            return 1;
+    }
+
+    return 0;
+}
+
+// decodes a tag value and replaces its escapes (\" and \\).
+NCH_STATIC PyObject*
+tag_value_to_str(const PGNTag* tag){
+    if (!memchr(tag->value, '\\', tag->value_len))
+        return PyUnicode_DecodeUTF8(tag->value, tag->value_len, "replace");
+
+    char* value = (char*)malloc(tag->value_len);
+    if (!value)
+        return PyErr_NoMemory();
+
+    int n = 0;
+    for (int i = 0; i < tag->value_len; i++){
+        if (tag->value[i] == '\\' && i + 1 < tag->value_len)
+            i++;
+        value[n++] = tag->value[i];
+    }
+
+    PyObject* str = PyUnicode_DecodeUTF8(value, n, "replace");
+    free(value);
+    return str;
+}
+
+NCH_STATIC PyObject*
+game_headers(const PGNGame* game){
+    PyObject* headers = PyDict_New();
+    if (!headers)
+        return NULL;
+
+    const char* cursor = game->start;
+    PGNTag tag;
+    while (PGN_NextTag(game, &cursor, &tag)){
+        PyObject* name = PyUnicode_DecodeUTF8(tag.name, tag.name_len, "replace");
+        PyObject* value = name ? tag_value_to_str(&tag) : NULL;
+        if (!value || PyDict_SetItem(headers, name, value) < 0){
+            Py_XDECREF(name);
+            Py_XDECREF(value);
+            Py_DECREF(headers);
+            return NULL;
+        }
+        Py_DECREF(name);
+        Py_DECREF(value);
+    }
+
+    return headers;
+}
+
+// a reader is read by one thread at a time. returns 0 on success and -1
+// with a RuntimeError set if another thread is reading it.
+NCH_STATIC int
+pgnreader_acquire(PyPGNReader* reader){
+    int ok;
+
+#ifdef Py_GIL_DISABLED
+    PyMutex_Lock(&reader->busy_mutex);
+#endif
+
+    ok = !reader->busy;
+    if (ok)
+        reader->busy = 1;
+
+#ifdef Py_GIL_DISABLED
+    PyMutex_Unlock(&reader->busy_mutex);
+#endif
+
+    if (!ok){
+        PyErr_SetString(PyExc_RuntimeError, "PGNReader is being read by another thread");
+        return -1;
+    }
+    return 0;
+}
+
+NCH_STATIC void
+pgnreader_release(PyPGNReader* reader){
+#ifdef Py_GIL_DISABLED
+    PyMutex_Lock(&reader->busy_mutex);
+#endif
+
+    reader->busy = 0;
+
+#ifdef Py_GIL_DISABLED
+    PyMutex_Unlock(&reader->busy_mutex);
+#endif
+}
+
+// returns the next game. the reader must be held.
+NCH_STATIC PyObject*
+pgnreader_next_game(PyPGNReader* reader){
+    if (reader->next >= reader->block.ngames){
+        int res = pgnreader_read_block(reader);
+        if (res <= 0)
+            return NULL; // StopIteration if no error is set
+    }
+
+    PGNGames* block = &reader->block;
+    long long i = reader->next++;
+    long long first = block->offsets[i];
+    npy_intp nmoves = (npy_intp)(block->offsets[i + 1] - first);
+
+    if (block->status[i] < 0){
+        PyObject* idx = PyLong_FromLongLong(reader->ngames);
+        if (!idx || PyList_Append(reader->errors, idx) < 0){
+            Py_XDECREF(idx);
+            return NULL;
+        }
+        Py_DECREF(idx);
+    }
+    reader->ngames++;
+
+    PyObject* headers = game_headers(&block->games[i]);
+    if (!headers)
+        return NULL;
+
+    PyObject* moves = PyArray_SimpleNew(1, &nmoves, NPY_UINT16);
+    if (!moves){
+        Py_DECREF(headers);
+        return NULL;
+    }
+    if (nmoves)
+        memcpy(PyArray_DATA((PyArrayObject*)moves), block->moves + first, nmoves * sizeof(Move));
+
+    if (!reader->positions){
+        PyObject* out = PyTuple_Pack(2, headers, moves);
+        Py_DECREF(headers);
+        Py_DECREF(moves);
+        return out;
+    }
+
+    PyArray_Descr* descr = packed_board_descr();
+    npy_intp npositions = nmoves + 1;
+    PyObject* positions = descr ? PyArray_NewFromDescr(&PyArray_Type, descr, 1, &npositions, NULL, NULL, 0, NULL)
+                                : NULL;
+    if (!positions){
+        Py_DECREF(headers);
+        Py_DECREF(moves);
+        return NULL;
+    }
+    memcpy(PyArray_DATA((PyArrayObject*)positions), block->positions + first + i,
+           npositions * sizeof(PackedBoard));
+
+    PyObject* out = PyTuple_Pack(3, headers, moves, positions);
+    Py_DECREF(headers);
+    Py_DECREF(moves);
+    Py_DECREF(positions);
+    return out;
+}
+
+PyObject*
+pgnreader_get_errors(PyObject* self, void* closure){
+    PyPGNReader* reader = (PyPGNReader*)self;
+    Py_INCREF(reader->errors);
+    return reader->errors;
+}
+
+PyObject*
+pgnreader_next(PyObject* self){
+    PyPGNReader* reader = (PyPGNReader*)self;
+    if (pgnreader_acquire(reader) < 0)
+        return NULL;
+
+    PyObject* game = pgnreader_next_game(reader);
+    pgnreader_release(reader);
+    return game;
+}
+
+static PyGetSetDef pgnreader_getset[] = {
+    {"errors", (getter)pgnreader_get_errors, NULL, NULL, NULL},
+    {NULL    , NULL                         , NULL, NULL, NULL},
+};
+
+PyTypeObject PyPGNReaderType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "PGNReader",
+    .tp_basicsize = sizeof(PyPGNReader),
+    .tp_dealloc = (destructor)pgnreader_free,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = (newfunc)pgnreader_new,
+    .tp_iter = PyObject_SelfIter,
+    .tp_iternext = (iternextfunc)pgnreader_next,
+    .tp_getset = pgnreader_getset,
+};
@@ -0,0 +1,37 @@
+#ifndef NCHESS_CORE_PYPGN_H
+#define NCHESS_CORE_PYPGN_H
+
+#define PY_SSIZE_CLEAN_H
+#include <Python.h>
+
+#include "nchess/pgn.h"
+
+// An iterator over the games of a PGN buffer. The games are read block by
+// block so only a part of a big file is processed at a time.
+typedef struct
+{
+    PyObject_HEAD
+    PyObject* data;    // the object that owns the buffer
+    Py_buffer view;    // valid if has_view is 1. a str is read without a view
+    int has_view;
+    const char* buffer;
+    size_t len;
+    size_t pos;        // where the next block starts
+
+    int threads;
+    int positions;     // 1 if the positions of every game are returned
+
+    PGNGames block;    // the games of the current block
+    long long next;    // the index of the next game of the block
+    long long ngames;  // the number of games returned so far
+
+    PyObject* errors;  // list of the indices of the games that could not be read
+    int busy;          // 1 while a thread is reading the next game
+#ifdef Py_GIL_DISABLED
+    PyMutex busy_mutex;
+#endif
+}PyPGNReader;
+
+extern PyTypeObject PyPGNReaderType;
+
+#endif // NCHESS_CORE_PYPGN_H
@@ -0,0 +1,262 @@
+#include "pysearch.h"
+#include "pyboard.h"
+#include "pyboard_methods.h"
+#include "pynnue.h"
+#include "common.h"
+
+#include "nchess/memory.h"
+
+PyObject*
+searchpool_new(PyTypeObject* type, PyObject* args, PyObject* kwargs){
+    int threads = 0;
+    int hash_size = 16;
+    static char* kwlist[] = {"threads", "hash_size", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|ii", kwlist, &threads, &hash_size)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    if (hash_size < 0){
+        PyErr_SetString(PyExc_ValueError, "hash_size must not be negative");
+        return NULL;
+    }
+
+    PySearchPool* self = (PySearchPool*)type->tp_alloc(type, 0);
+    if (!self){
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    if (hash_size){
+        if (TT_Init(&self->tt, hash_size) < 0){
+            Py_DECREF(self);
+            return PyErr_NoMemory();
+        }
+        self->has_tt = 1;
+    }
+
+    self->pool = SearchPool_New(threads);
+    if (!self->pool){
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+
+    self->stats = (SearchThreadStats*)calloc(SearchPool_Threads(self->pool), sizeof(SearchThreadStats));
+    if (!self->stats){
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+
+    return (PyObject*)self;
+}
+
+void
+searchpool_free(PyObject* self){
+    if (self){
+        PySearchPool* sp = (PySearchPool*)self;
+        SearchPool_Free(sp->pool);
+        if (sp->has_tt)
+            TT_Free(&sp->tt);
+        free(sp->stats);
+        Py_TYPE(sp)->tp_free(sp);
+    }
+}
+
+// a pool runs one search at a time. returns 0 on success and -1 with a
+// RuntimeError set if another thread is using it.
+NCH_STATIC int
+searchpool_acquire(PySearchPool* sp){
+    int ok;
+
+#ifdef Py_GIL_DISABLED
+    PyMutex_Lock(&sp->busy_mutex);
+#endif
+
+    ok = !sp->busy;
+    if (ok)
+        sp->busy = 1;
+
+#ifdef Py_GIL_DISABLED
+    PyMutex_Unlock(&sp->busy_mutex);
+#endif
+
+    if (!ok){
+        PyErr_SetString(PyExc_RuntimeError, "SearchPool is being used by another thread");
+        return -1;
+    }
+    return 0;
+}
+
+NCH_STATIC void
+searchpool_release(PySearchPool* sp){
+#ifdef Py_GIL_DISABLED
+    PyMutex_Lock(&sp->busy_mutex);
+#endif
+
+    sp->busy = 0;
+
+#ifdef Py_GIL_DISABLED
+    PyMutex_Unlock(&sp->busy_mutex);
+#endif
+}
+
+PyObject*
+searchpool_search(PyObject* self, PyObject* args, PyObject* kwargs){
+    PySearchPool* sp = (PySearchPool*)self;
+    PyObject* board_obj;
+    SearchLimits limits = {0, 0, 0};
+    PyObject* network = NULL;
+    static char* kwlist[] = {"board", "depth", "movetime", "nodes", "network", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|idLO!", kwlist, &PyBoardType, &board_obj,
+                                     &limits.depth, &limits.movetime, &limits.nodes,
+                                     &PyNNUENetworkType, &network)){
+        if (!PyErr_Occurred()){
+            PyErr_SetString(PyExc_ValueError, "failed to parse the arguments");
+        }
+        return NULL;
+    }
+
+    if (limits.depth <= 0 && limits.movetime <= 0 && limits.nodes <= 0){
+        PyErr_SetString(PyExc_ValueError, "at least one of depth, movetime and nodes must be set");
+        return NULL;
+    }
+
+    // the threads copy the position from this copy. the history is copied
+    // too so the repetitions of the game are seen.
+    Board board;
+    int copied;
+    Py_BEGIN_CRITICAL_SECTION(board_obj);
+    copied = Board_Copy(((PyBoard*)board_obj)->board, &board);
+    Py_END_CRITICAL_SECTION();
+    if (copied < 0){
+        PyErr_NoMemory();
+        return NULL;
+    }
+
+    // every thread searches with its own copy of the accumulator
+    NNUEAccumulator acc;
+    if (network)
+        NNUE_Attach(&board, &acc, ((PyNNUENetwork*)network)->net);
+
+    if (searchpool_acquire(sp) < 0){
+        Board_FreeExtraOnly(&board);
+        return NULL;
+    }
+
+    int res;
+    Py_BEGIN_ALLOW_THREADS
+    res = SearchPool_Search(sp->pool, &board, &limits, sp->has_tt ? &sp->tt : NULL,
+                            NULL, NULL, &sp->result, sp->stats);
+    Py_END_ALLOW_THREADS
+
+    sp->searched = 1;
+
+    // the tuple is built before the pool is released, another search
+    // would write over the result
+    PyObject* out = search_result_to_tuple(&sp->result, res);
+    searchpool_release(sp);
+    Board_FreeExtraOnly(&board);
+
+    return out;
+}
+
+PyObject*
+searchpool_clear(PyObject* self, PyObject* args){
+    PySearchPool* sp = (PySearchPool*)self;
+    if (searchpool_acquire(sp) < 0)
+        return NULL;
+
+    if (sp->has_tt){
+        Py_BEGIN_ALLOW_THREADS
+        TT_Clear(&sp->tt);
+        Py_END_ALLOW_THREADS
+    }
+
+    searchpool_release(sp);
+    Py_RETURN_NONE;
+}
+
+PyObject*
+searchpool_get_threads(PyObject* self, void* closure){
+    return PyLong_FromLong(SearchPool_Threads(((PySearchPool*)self)->pool));
+}
+
+NCH_STATIC_INLINE long long
+nodes_per_second(long long nodes, double seconds){
+    return seconds > 0 ? (long long)(nodes / seconds) : 0;
+}
+
+// builds the info dict of the last search. the pool must be held.
+NCH_STATIC PyObject*
+searchpool_info_dict(const PySearchPool* sp){
+    if (!sp->searched)
+        Py_RETURN_NONE;
+
+    int nthreads = SearchPool_Threads(sp->pool);
+    PyObject* threads = PyList_New(nthreads);
+    if (!threads)
+        return NULL;
+
+    for (int i = 0; i < nthreads; i++){
+        const SearchThreadStats* st = sp->stats + i;
+        PyObject* item = Py_BuildValue("{s:L,s:i,s:d,s:L}",
+                                       "nodes", st->nodes,
+                                       "depth", st->depth,
+                                       "seconds", st->seconds,
+                                       "nps", nodes_per_second(st->nodes, st->seconds));
+        if (!item){
+            Py_DECREF(threads);
+            return NULL;
+        }
+        PyList_SET_ITEM(threads, i, item);
+    }
+
+    const SearchResult* r = &sp->result;
+    return Py_BuildValue("{s:i,s:L,s:d,s:L,s:i,s:N}",
+                         "depth", r->depth,
+                         "nodes", r->nodes,
+                         "seconds", r->seconds,
+                         "nps", r->nps,
+                         "hashfull", r->hashfull,
+                         "threads", threads);
+}
+
+PyObject*
+searchpool_get_info(PyObject* self, void* closure){
+    PySearchPool* sp = (PySearchPool*)self;
+
+    // a search running on another thread writes the result and the stats
+    if (searchpool_acquire(sp) < 0)
+        return NULL;
+
+    PyObject* info = searchpool_info_dict(sp);
+    searchpool_release(sp);
+    return info;
+}
+
+static PyMethodDef searchpool_methods[] = {
+    {"search", (PyCFunction)searchpool_search, METH_VARARGS | METH_KEYWORDS, NULL},
+    {"clear" , (PyCFunction)searchpool_clear , METH_NOARGS                 , NULL},
+    {NULL    , NULL                          , 0                           , NULL},
+};
+
+static PyGetSetDef searchpool_getset[] = {
+    {"threads", (getter)searchpool_get_threads, NULL, NULL, NULL},
+    {"info"   , (getter)searchpool_get_info   , NULL, NULL, NULL},
+    {NULL     , NULL                          , NULL, NULL, NULL},
+};
+
+PyTypeObject PySearchPoolType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "SearchPool",
+    .tp_basicsize = sizeof(PySearchPool),
+    .tp_dealloc = (destructor)searchpool_free,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_new = (newfunc)searchpool_new,
+    .tp_methods = searchpool_methods,
+    .tp_getset = searchpool_getset,
+};
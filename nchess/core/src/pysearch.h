@@ -0,0 +1,31 @@
+#ifndef NCHESS_CORE_PYSEARCH_H
+#define NCHESS_CORE_PYSEARCH_H
+
+#define PY_SSIZE_CLEAN_H
+#include <Python.h>
+
+#include "nchess/search.h"
+
+// A pool of search threads with its transposition table. Both are kept
+// between the searches so the threads are started once and the table
+// keeps what the searches before found.
+typedef struct
+{
+    PyObject_HEAD
+    SearchPool* pool;
+    TransTable tt;
+    int has_tt;                // 0 if the pool searches without a table
+
+    SearchResult result;       // the result of the last search
+    SearchThreadStats* stats;  // the statistics of every thread in the last search
+    int searched;              // 1 after the first search
+
+    int busy;                  // 1 while a search runs with the GIL released
+#ifdef Py_GIL_DISABLED
+    PyMutex busy_mutex;
+#endif
+}PySearchPool;
+
+extern PyTypeObject PySearchPoolType;
+
+#endif // NCHESS_CORE_PYSEARCH_H
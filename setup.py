@@ -8,6 +8,12 @@ from setuptools.command.build_ext import build_ext
 # Paths
 PYTHON_SRC = "nchess/core/src"
 C_SRC = "c-nchess/nchess"
+C_TOOLS = "c-nchess/tools"
+
+# Set NCHESS_PRECOMPUTED_TABLES=1 to generate the bitboard tables at build time
+# as const data. Importing the module then skips computing them and the read
+# only pages of the tables are shared between processes.
+PRECOMPUTED_TABLES = os.environ.get("NCHESS_PRECOMPUTED_TABLES", "0") not in ("", "0")
 
 def get_version():
     """Read version from nchess/__init__.py"""
@@ -45,7 +51,7 @@ else:  # Linux/macOS (GCC/Clang)
         "-O3", "-Wall", "-Wextra",
         "-fPIC", "-std=c99"
     ]
-    extra_link_args = []
+    extra_link_args = ["-pthread"]
 
 # Define the extension module
 nchess_core = Extension(
@@ -63,6 +69,34 @@ nchess_core = Extension(
 
 # Custom build command to show where the extension is built
 class CustomBuildExt(build_ext):
+    def build_extensions(self):
+        if PRECOMPUTED_TABLES:
+            self.generate_tables()
+        super().build_extensions()
+
+    def generate_tables(self):
+        """Build the gen_tables tool and write the bitboard tables with it"""
+        gen_dir = os.path.join(self.build_temp, "gen")
+        sources = find_c_files(C_SRC) + [os.path.join(C_TOOLS, "gen_tables.c")]
+        objects = self.compiler.compile(
+            sources,
+            output_dir=gen_dir,
+            include_dirs=[C_SRC],
+            extra_postargs=extra_compile_args,
+        )
+        self.compiler.link_executable(
+            objects, "gen_tables",
+            output_dir=gen_dir,
+            extra_postargs=extra_link_args,
+        )
+
+        tool = os.path.join(gen_dir, self.compiler.executable_filename("gen_tables"))
+        self.spawn([tool, os.path.join(gen_dir, "bitboard_tables.h")])
+
+        for ext in self.extensions:
+            ext.define_macros.append(("NCH_PRECOMPUTED_TABLES", None))
+            ext.include_dirs.append(gen_dir)
+
     def run(self):
         super().run()
         print("\n" + "="*60)
@@ -0,0 +1,75 @@
+"""
+Tests a board stepped by one thread while other threads read it. On the
+free-threaded build every Board method locks its board, so the readers
+always see a position in between two moves.
+
+    python -m unittest discover tests
+"""
+
+import random
+import threading
+import unittest
+
+import nchess
+
+
+class TestBoardThreads(unittest.TestCase):
+
+    def test_step_and_read(self):
+        board = nchess.Board()
+        stop = threading.Event()
+        errors = []
+
+        def writer():
+            rng = random.Random(7)
+            try:
+                for _ in range(300):
+                    n = 0
+                    while n < 40:
+                        moves = board.generate_legal_moves()
+                        if not moves:
+                            break
+                        board.step(rng.choice(moves))
+                        n += 1
+                    for _ in range(n):
+                        board.undo()
+            except Exception as e:
+                errors.append(e)
+            finally:
+                stop.set()
+
+        def reader():
+            try:
+                while not stop.is_set():
+                    # the copy is taken in one call, so its moves replayed
+                    # from the start must give the same position
+                    copy = board.copy()
+                    replay = nchess.Board()
+                    for move in copy.get_played_moves():
+                        self.assertTrue(replay.step(move))
+                    self.assertEqual(replay.fen(), copy.fen())
+                    self.assertEqual(replay.key, copy.key)
+
+                    board.generate_legal_moves()
+                    board.get_played_moves()
+                    board.fen()
+                    board.material
+                    str(board)
+            except Exception as e:
+                errors.append(e)
+                stop.set()
+
+        threads = [threading.Thread(target=writer)]
+        threads += [threading.Thread(target=reader) for _ in range(3)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+        self.assertEqual(errors, [])
+        self.assertEqual(board.fen(), nchess.Board().fen())
+        self.assertEqual(board.get_played_moves(), [])
+
+
+if __name__ == "__main__":
+    unittest.main()